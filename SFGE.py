@@ -197,15 +197,68 @@ class ShapeManager(System):
     def get_component(self, entity:int):
         pass
 
+class Animation2d:
+    def __init__(self):
+        self.speed = 1.0
+        self.time = 0.0
+        self.clip_id = 0
+        self.current_frame = 0
+
+class Animation2dManager(System):
+    def add_component(self, entity:int) -> Animation2d:
+        pass
+    def get_component(self, entity:int) -> Animation2d:
+        pass
+    def load_clip(self, clip_path:str) -> int:
+        pass
+    def set_clip(self, entity:int, clip_id:int):
+        pass
+
 class TextureManager(System):
     pass    
 
 
+class DebugDraw:
+    class Category:
+        General = 0
+        Physics = 0
+        Vector = 0
+        Raycast = 0
+    General = Category.General
+    Physics = Category.Physics
+    Vector = Category.Vector
+    Raycast = Category.Raycast
+
+    def set_category_enabled(self, category, enable: bool):
+        pass
+
+    def is_category_enabled(self, category) -> bool:
+        pass
+
+    def draw_line(self, from_vec: Vec2f, to_vec: Vec2f, color: Color, category=Category.General):
+        pass
+
+    def draw_lines(self, points, color: Color, category=Category.General):
+        """Draw independent segments in one batch, points is a list of Vec2f or a NumPy array of shape (n, 2) or (n, 4)"""
+        pass
+
+    def draw_circle(self, center: Vec2f, radius: float, color: Color, category=Category.General):
+        pass
+
+    def draw_box(self, center: Vec2f, size: Vec2f, angle: float, color: Color, category=Category.General):
+        pass
+
+    def draw_text(self, position: Vec2f, text: str, color: Color, category=Category.General):
+        pass
+
+
 class Graphics2dManager(System):
     def __init__(self):
         self.texture_manager = TextureManager()
         self.sprite_manager = SpriteManager()
         self.shape_manager = ShapeManager()
+        self.animation2d_manager = Animation2dManager()
+        self.debug_draw = DebugDraw()
 
     def draw_line(self, from_vec:Vec2f, to_vec:Vec2f, color:Color):
         pass
@@ -217,9 +270,30 @@ class SceneManager(System):
     def load_scene(self, scene_name):
         pass
 
+    def cook_scene(self, scene_path:str) -> bool:
+        pass
+
+    def preload_scene(self, scene_name:str):
+        pass
+
+    def is_scene_preloaded(self) -> bool:
+        pass
+
+    def activate_scene(self) -> bool:
+        pass
+
+    def spawn(self, count: int, archetype, positions=None, velocities=None, texture_path="", body_type=None):
+        """Create count entities at runtime, the NumPy component views taken before are invalid afterward"""
+        pass
+
 
 class Transform2dManager(System, ComponentManager):
-    pass
+    """The positions, scales and angles views are NumPy arrays over the engine memory, one row per entity
+    starting at entity 1. A view dangles once the entities are resized (entity_manager.resize or
+    scene_manager.spawn), take it again each frame instead of keeping it in the system"""
+    positions = None  # type: numpy.ndarray
+    scales = None  # type: numpy.ndarray
+    angles = None  # type: numpy.ndarray
 
 
 class PythonEngine(System):
@@ -241,9 +315,20 @@ class EntityManager(System):
     def get_entities_with_type(self, componentType):
         pass
 
+    def resize(self, new_size):
+        """Invalidate every NumPy view taken before, the component arrays are reallocated"""
+        pass
+
+    masks = None  # type: numpy.ndarray
+    """Read only view of the component masks, dangles after resize like the other views"""
+
 
 class Body2dManager(System, ComponentManager):
-    pass
+    """velocities and forces are writable NumPy views, one row per entity starting at entity 1.
+    Changed velocities and non zero forces are applied on the next fixed update, forces are then reset to zero.
+    A view dangles after entity_manager.resize or scene_manager.spawn, take it again each frame"""
+    velocities = None  # type: numpy.ndarray
+    forces = None  # type: numpy.ndarray
 
 
 class Physics2dManager(System):
@@ -265,6 +350,7 @@ class Component:
     Body = 0
     Sound = 0
     Transform2d = 0
+    Animation2d = 0
 
 
 class Transform2d():
@@ -1,8 +1,13 @@
-#version 120
+#version 330
 
-varying vec4 outVertexCol;
+in vec4 outVertexCol;
+in vec2 outTexCoords;
+
+uniform sampler2D spriteTexture;
+
+out vec4 fragColor;
 
 void main()
 {
-   gl_FragColor = outVertexCol;
-}
\ No newline at end of file
+   fragColor = texture(spriteTexture, outTexCoords) * outVertexCol;
+}
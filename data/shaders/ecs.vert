@@ -1,12 +1,29 @@
-#version 120
+#version 330
+
+//Unit quad corner, shared by every instance
+layout(location = 0) in vec2 inCorner;
+//Per instance attributes, see sfge::SpriteInstance
+layout(location = 1) in vec2 inPosition;
+layout(location = 2) in vec2 inScale;
+layout(location = 3) in float inRotation;
+layout(location = 4) in vec4 inVertexCol;
+layout(location = 5) in vec4 inUvRect;
 
-attribute vec2 inVertexPos;
-attribute vec4 inVertexCol;
-varying vec4 outVertexCol;
 uniform mat4 orthoView;
+uniform vec2 textureSize;
+
+out vec4 outVertexCol;
+out vec2 outTexCoords;
 
 void main() 
 {
-   gl_Position = orthoView * vec4(inVertexPos, 1.0, 1.0);
+   vec2 size = inUvRect.zw * textureSize * inScale;
+   float angle = radians(inRotation);
+   vec2 local = inCorner * size;
+   vec2 rotated = vec2(
+      local.x * cos(angle) - local.y * sin(angle),
+      local.x * sin(angle) + local.y * cos(angle));
+   gl_Position = orthoView * vec4(inPosition + rotated, 0.0, 1.0);
    outVertexCol = inVertexCol;
-}
\ No newline at end of file
+   outTexCoords = inUvRect.xy + (inCorner + vec2(0.5)) * inUvRect.zw;
+}
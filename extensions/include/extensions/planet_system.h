@@ -84,6 +84,11 @@ private:
 	sf::Vector2f screenSize;
 #ifdef WITH_VERTEXARRAY
 	sf::VertexArray m_VertexArray{sf::Quads, 4 * entitiesNmb};
+	/**
+	 * \brief Used instead of m_VertexArray when the sprite instancing is enabled, only the positions change every frame
+	 */
+	std::vector<SpriteInstance> m_SpriteInstances;
+	bool m_UseSpriteInstancing = false;
 	Graphics2dManager* m_Graphics2DManager;
 	sf::Texture* texture = nullptr;
 	sf::Vector2f textureSize;
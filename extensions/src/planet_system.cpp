@@ -28,6 +28,7 @@ SOFTWARE.
 #include <graphics/graphics2d.h>
 #include <physics/body2d.h>
 #include <physics/physics2d.h>
+#include <engine/component.h>
 
 
 
@@ -38,6 +39,10 @@ PlanetSystem::PlanetSystem(Engine& engine):
 	System(engine)
 	
 {
+#ifndef MULTI_THREAD
+	//Waits on the thread pool when multi threaded, it then stays alone in its wave on the main thread
+	SetComponentAccess(0, static_cast<int>(ComponentType::TRANSFORM2D) | static_cast<int>(ComponentType::BODY2D));
+#endif
 }
 
 void PlanetSystem::OnEngineInit()
@@ -61,6 +66,15 @@ void PlanetSystem::OnEngineInit()
 	const auto textureId = m_TextureManager->LoadTexture("data/sprites/round.png");
 	texture = m_TextureManager->GetTexture(textureId);
 	textureSize = sf::Vector2f(texture->getSize().x, texture->getSize().y);
+	m_UseSpriteInstancing = m_Graphics2DManager->IsSpriteInstancingEnabled();
+	if (m_UseSpriteInstancing)
+	{
+		m_SpriteInstances.resize(entitiesNmb);
+		for (auto& spriteInstance : m_SpriteInstances)
+		{
+			spriteInstance.scale = sf::Vector2f(1.0f, 1.0f);
+		}
+	}
 #endif
 
 	for (auto i = 0u; i < entitiesNmb; i++)
@@ -99,6 +113,10 @@ void PlanetSystem::OnEngineInit()
 		spriteInfo.textureId = textureId;
 		spriteInfo.texturePath = texturePath;
 #else
+		if (m_UseSpriteInstancing)
+		{
+			continue;
+		}
 		m_VertexArray[4 * i].texCoords = sf::Vector2f(0, 0);
 		m_VertexArray[4 * i + 1].texCoords = sf::Vector2f(textureSize.x, 0);
 		m_VertexArray[4 * i + 2].texCoords = textureSize;
@@ -172,6 +190,11 @@ void PlanetSystem::OnFixedUpdate()
 #endif
 #ifdef WITH_VERTEXARRAY
 		const auto pos = transformPtr->Position;
+		if (m_UseSpriteInstancing)
+		{
+			m_SpriteInstances[i].position = pos;
+			continue;
+		}
 
 		m_VertexArray[4 * i].position = pos - textureSize / 2.0f;
 		m_VertexArray[4 * i + 1].position = pos + sf::Vector2f(textureSize.x / 2.0f, -textureSize.y / 2.0f);
@@ -189,10 +212,13 @@ void PlanetSystem::OnDraw()
 {
 	rmt_ScopedCPUSample(PlanetSystemDraw,0);
 #ifdef WITH_VERTEXARRAY
-	sf::RenderStates renderStates;
-	renderStates.texture = texture;
-	auto window = m_Graphics2DManager->GetWindow();
-	window->draw(m_VertexArray, renderStates);
+	if (m_UseSpriteInstancing)
+	{
+		m_Graphics2DManager->DrawSpriteInstances(m_SpriteInstances.data(), m_SpriteInstances.size(), texture);
+		return;
+	}
+	m_Graphics2DManager->DrawVertices(&m_VertexArray[0], m_VertexArray.getVertexCount(),
+		m_VertexArray.getPrimitiveType(), texture);
 #endif
 }
 
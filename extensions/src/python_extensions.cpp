@@ -32,6 +32,7 @@ SOFTWARE.
 #include <extensions/planet_system.h>
 
 #include <tools/tools_pch.h>
+#include <native_systems/generated_systems.h>
 
 namespace sfge::ext
 {
@@ -46,6 +47,7 @@ void ExtendPython(py::module& m)
 	
 
 	tools::ExtendPythonTools(m);
+	ExtendPythonGeneratedSystems(m);
 }
 
 }
@@ -26,9 +26,11 @@ SOFTWARE.
 #ifndef SFGE_SOUND_H
 #define SFGE_SOUND_H
 #include <vector>
+#include <unordered_map>
 
 #include <SFML/Audio.hpp>
 #include <engine/component.h>
+#include <engine/asset.h>
 #include <editor/editor_info.h>
 
 namespace sfge
@@ -88,14 +90,26 @@ public:
 	void OnAfterSceneLoad() override;
 
 	SoundBufferId LoadSoundBuffer(std::string filename);
+	/**
+	* \brief Give a sound buffer decoded on a worker thread, used by the next LoadSoundBuffer of this path
+	*/
+	void AddPreloadedSoundBuffer(const std::string& filename, std::unique_ptr<sf::SoundBuffer> soundBuffer);
+	/**
+	* \brief Read again a sound buffer changed on the disk, the sounds keep their sf::SoundBuffer
+	* \return false if the file is not a loaded sound buffer
+	*/
+	bool ReloadSoundBuffer(const std::string& filename);
 	sf::SoundBuffer* GetSoundBuffer(SoundBufferId soundBufferId);
 private:
 
   	bool HasValidExtension(std::string filename);
+	std::unique_ptr<sf::SoundBuffer> LoadSoundBufferFile(const std::string& filename);
 	std::vector<std::string> m_SoundBufferPaths{ INIT_ENTITY_NMB };
-	std::vector<size_t> m_SoundBufferCountRefs{ INIT_ENTITY_NMB };
+	std::vector<size_t> m_SoundBufferCountRefs = std::vector<size_t>(INIT_ENTITY_NMB, 0U);
 	std::vector<std::unique_ptr<sf::SoundBuffer>> m_SoundBuffers{INIT_ENTITY_NMB};
 	SoundBufferId m_IncrementId = 0U;
+	std::unordered_map<AssetId, SoundBufferId> m_AssetSoundBufferIds;
+	std::unordered_map<std::string, std::unique_ptr<sf::SoundBuffer>> m_PreloadedSoundBuffers;
 
 };
 
@@ -124,6 +138,11 @@ public:
 
 	//TODO use similar construction as pycomponent
 	void CreateComponent(json& componentJson, Entity entity) override;
+	/**
+	* \brief Shared by the json and the cooked scene loading
+	*/
+	void CreateComponent(const std::string& path, Entity entity);
+	void SerializeComponents(Entity entity, json& componentsJson) override;
 	void DestroyComponent(Entity entity) override;
 	void OnBeforeSceneLoad() override;
 	void OnAfterSceneLoad() override;
@@ -132,6 +151,7 @@ public:
 
 protected:
 	int GetFreeComponentIndex() override;
+	Entity GetComponentEntity(size_t index) override;
 	SoundBufferManager* m_SoundBufferManager = nullptr;
 };
 }
@@ -26,10 +26,12 @@ SOFTWARE.
 #define SFGE_PROFILER_H
 
 #include <SFML/System/Time.hpp>
+#include <string>
 
 namespace sfge
 {
 class Engine;
+class PySystemManager;
 struct ProfilerFrameData
 {
     sf::Time frameTotalTime;
@@ -44,7 +46,17 @@ public:
     ProfilerEditorWindow(Engine& engine);
     void Update ();
 private:
+  /**
+   * \brief Average hook times of the PySystems, sorted by the clicked column, with the history of the selected one
+   */
+  void UpdateSystemsTable ();
+  void UpdatePythonHotspots ();
+
+  Engine& m_Engine;
   ProfilerFrameData& m_ProfilerFrameData;
+  PySystemManager* m_PySystemManager = nullptr;
+  int m_SortColumn = 1;
+  std::string m_SelectedSystem;
 };
 }
 }
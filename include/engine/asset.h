@@ -22,26 +22,90 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+
 #ifndef SFGE_ASSET_H
 #define SFGE_ASSET_H
 
+#include <string>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
 #include <uuid.h>
 #include <xxhash.hpp>
 
+#include <engine/system.h>
+
+namespace sfge
+{
+
+using AssetId = unsigned;
+const AssetId INVALID_ASSET = 0U;
+
+enum class AssetType : unsigned char
+{
+	NONE = 0,
+	TEXTURE,
+	SOUND,
+	SCENE
+};
+
 struct Asset
 {
-    std::string name;
-    std::string path;
-    xxh::hash64_t hash;
-    uuids::uuid uuid;
+	std::string name;
+	std::string path;
+	/**
+	* \brief Hash of the file content, two paths with the same content share the same Asset.
+	* 0 when the asset was registered without reading the file
+	*/
+	xxh::hash64_t hash = 0;
+	uuids::uuid uuid;
+	AssetType type = AssetType::NONE;
 };
 
-class AssetManager
+/**
+* \brief The AssetManager indexes every file loaded by the other managers, by path hash and by content hash
+*/
+class AssetManager : public System
 {
-    
+public:
+	using System::System;
+
+	/**
+	* \brief Get the asset of the file, the content is only read and hashed the first time the path is seen
+	* \param path The path of the file on the disk
+	* \param type The type of the asset, only used when the asset is registered
+	* \param hashContent If false, the file is not read and the asset is only shared by its path
+	* \return The strictly positive asset id, INVALID_ASSET if the file does not exist
+	*/
+	AssetId LoadAsset(const std::string& path, AssetType type, bool hashContent = true);
+	/**
+	* \brief Find an already registered asset without touching the disk
+	*/
+	AssetId FindAsset(const std::string& path) const;
+	/**
+	* \brief Hash again the content of a file changed on the disk
+	* \return The same asset id, or a new one if the path was sharing the content of another file
+	*/
+	AssetId ReloadAsset(const std::string& path, AssetType type);
+	/**
+	* \brief The returned pointer stays valid until the AssetManager is destroyed
+	*/
+	const Asset* GetAsset(AssetId assetId) const;
+	size_t GetAssetCount() const;
+
+	static bool HashFile(const std::string& path, xxh::hash64_t& hash);
+
+	void Destroy() override;
 private:
-    std::vector<Asset> m_Assets;
+	std::deque<Asset> m_Assets;
+	/**
+	* \brief Keyed by the full path, a path hash collision would silently share two unrelated files
+	*/
+	std::unordered_map<std::string, AssetId> m_PathIndex;
+	std::unordered_map<xxh::hash64_t, AssetId> m_ContentIndex;
+	mutable std::mutex m_Mutex;
 };
+}
 
 #endif
-
@@ -62,6 +62,16 @@ class IComponentFactory
 {
  public:
   virtual void CreateComponent(json& componentJson, Entity entity) = 0;
+  /**
+   * \brief Append the json of the components of this type attached to the entity, in the format read by CreateComponent
+   */
+  virtual void SerializeComponents(Entity entity, json& componentsJson) { (void) entity; (void) componentsJson; }
+  /**
+   * \brief Called before and after serializing the whole scene entity by entity, so the managers not indexed by entity
+   * can build their entity to components index once
+   */
+  virtual void BeginSerialization() {}
+  virtual void EndSerialization() {}
 };
 
 template<typename T, ComponentType componentType>
@@ -148,8 +158,69 @@ public:
 		ComponentManager<T, componentType>::m_Engine.GetSceneManager()->AddComponentManager(this, componentType);
 	}
 
+	void BeginSerialization() override
+	{
+		const size_t componentNmb = ComponentManager<T, componentType>::m_Components.size();
+		const size_t entityNmb = ComponentManager<T, componentType>::m_EntityManager->GetMasks().size();
+		//Components of the entity e are m_SerializationIndexes[m_SerializationOffsets[e - 1]] to m_SerializationIndexes[m_SerializationOffsets[e] - 1]
+		m_SerializationOffsets.assign(entityNmb + 1, 0);
+		for (size_t i = 0; i < componentNmb; i++)
+		{
+			const Entity entity = GetComponentEntity(i);
+			if (entity != INVALID_ENTITY && entity <= entityNmb)
+				m_SerializationOffsets[entity]++;
+		}
+		for (size_t entity = 1; entity <= entityNmb; entity++)
+		{
+			m_SerializationOffsets[entity] += m_SerializationOffsets[entity - 1];
+		}
+		m_SerializationIndexes.resize(m_SerializationOffsets[entityNmb]);
+		std::vector<size_t> cursors(m_SerializationOffsets.begin(), m_SerializationOffsets.end() - 1);
+		for (size_t i = 0; i < componentNmb; i++)
+		{
+			const Entity entity = GetComponentEntity(i);
+			if (entity != INVALID_ENTITY && entity <= entityNmb)
+				m_SerializationIndexes[cursors[entity - 1]++] = i;
+		}
+		m_SerializationIndexed = true;
+	}
+	void EndSerialization() override
+	{
+		m_SerializationIndexed = false;
+		m_SerializationOffsets.clear();
+		m_SerializationIndexes.clear();
+	}
+
 protected:
 	virtual int GetFreeComponentIndex() = 0;
+	/**
+	 * \brief Entity of the component at this index, only needed by the managers with several components per entity
+	 */
+	virtual Entity GetComponentEntity(size_t index) { (void) index; return INVALID_ENTITY; }
+	/**
+	 * \brief Call func with the index of each component of the entity, through the index built by BeginSerialization if any
+	 */
+	template<typename Func>
+	void ForEachComponentOf(Entity entity, Func func)
+	{
+		if (m_SerializationIndexed && entity < m_SerializationOffsets.size())
+		{
+			for (size_t i = m_SerializationOffsets[entity - 1]; i < m_SerializationOffsets[entity]; i++)
+			{
+				func(m_SerializationIndexes[i]);
+			}
+			return;
+		}
+		for (size_t i = 0; i < ComponentManager<T, componentType>::m_Components.size(); i++)
+		{
+			if (GetComponentEntity(i) == entity)
+				func(i);
+		}
+	}
+
+	bool m_SerializationIndexed = false;
+	std::vector<size_t> m_SerializationOffsets;
+	std::vector<size_t> m_SerializationIndexes;
 };
 
 template<class T, class TInfo, ComponentType componentType>
@@ -61,6 +61,50 @@ struct Configuration
 	 * \brief The limited framerate
 	 */
 	unsigned int maxFramerate = 60;
+	/**
+	 * \brief Submit the draw calls to a dedicated render thread owning the GL context
+	 */
+	bool renderThread = false;
+	/**
+	 * \brief Draw the sprites with one instanced draw call per texture, expanding the quads in data/shaders/ecs.vert
+	 */
+	bool instancedSprites = false;
+	/**
+	 * \brief Maximum bytes of asynchronously decoded textures uploaded to the GPU per frame
+	 */
+	size_t textureUploadBudget = 16U * 1024U * 1024U;
+	/**
+	 * \brief Folder of the decoded textures keyed by the hash of their source file, empty to decode the textures at each run
+	 */
+	std::string textureCacheDirname = "texture_cache/";
+	/**
+	 * \brief The least recently written texture cache entries are removed at init above this size in bytes
+	 */
+	size_t textureCacheMaxSize = 512U * 1024U * 1024U;
+	/**
+	 * \brief Write a binary .cscene next to each .scene loaded from json, loaded instead of the json while it is up to date
+	 */
+	bool cookScenes = false;
+	/**
+	 * \brief Search the scenes at the first scene request instead of at the engine init
+	 */
+	bool lazySceneSearch = false;
+	/**
+	 * \brief Import each script when a scene first references it instead of the whole scripts folder at init
+	 */
+	bool lazyScripts = false;
+	/**
+	 * \brief Folder of the marshaled code of the scripts keyed by the hash of their source, empty to compile the scripts at each run
+	 */
+	std::string scriptCacheDirname = "script_cache/";
+	/**
+	 * \brief Watch the data and scripts folders in devMode and reload the changed textures, sounds, scripts and current scene
+	 */
+	bool hotReload = true;
+	/**
+	 * \brief Pack built from the data folder, mapped at the init and read instead of the loose files, empty to read the disk
+	 */
+	std::string packFilename = "";
 	float fixedDeltaTime = 0.02f;
 	int velocityIterations = 8;
 	int positionIterations = 2;
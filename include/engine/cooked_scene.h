@@ -0,0 +1,211 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef SFGE_COOKED_SCENE_H
+#define SFGE_COOKED_SCENE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <type_traits>
+
+#include <utility/json_utility.h>
+#include <utility/file_utility.h>
+#include <engine/transform2d.h>
+#include <graphics/shape2d.h>
+#include <physics/body2d.h>
+#include <physics/collider2d.h>
+
+namespace sfge
+{
+
+const std::uint32_t COOKED_SCENE_MAGIC = 0x53434653U;
+const std::uint32_t COOKED_SCENE_VERSION = 1U;
+const std::uint32_t INVALID_COOKED_STRING = 0xFFFFFFFFU;
+
+enum class CookedSectionType : std::uint32_t
+{
+	ENTITY_NAMES = 0,
+	SYSTEMS,
+	TRANSFORM2D,
+	SPRITE2D,
+	SHAPE2D,
+	SOUND,
+	ANIMATION2D,
+	BODY2D,
+	COLLIDER2D,
+	LENGTH
+};
+
+/**
+* \brief Start of a .cscene file, followed by the section table, the sections and the string table
+*/
+struct CookedSceneHeader
+{
+	std::uint32_t magic = COOKED_SCENE_MAGIC;
+	std::uint32_t version = COOKED_SCENE_VERSION;
+	/**
+	* \brief Hash of the .scene json it was cooked from, a different hash means the cooked scene is outdated
+	*/
+	std::uint64_t sourceHash = 0;
+	std::uint32_t nameIndex = INVALID_COOKED_STRING;
+	std::uint32_t entityCount = 0;
+	std::uint32_t sectionCount = 0;
+	std::uint32_t stringTableOffset = 0;
+	std::uint32_t stringTableSize = 0;
+	std::uint32_t padding = 0;
+};
+
+struct CookedSection
+{
+	std::uint32_t type = 0;
+	std::uint32_t count = 0;
+	/**
+	* \brief Size of one record, checked against the loading build
+	*/
+	std::uint32_t stride = 0;
+	std::uint32_t offset = 0;
+};
+
+struct CookedSystem
+{
+	std::uint32_t scriptPathIndex = INVALID_COOKED_STRING;
+	std::uint32_t classNameIndex = INVALID_COOKED_STRING;
+};
+
+/**
+* \brief Component without any path, the definition is copied as is
+*/
+template<typename TDef>
+struct CookedComponent
+{
+	std::uint32_t entityIndex = 0;
+	TDef def;
+};
+
+struct CookedSprite
+{
+	std::uint32_t entityIndex = 0;
+	std::uint32_t pathIndex = INVALID_COOKED_STRING;
+	std::int32_t layer = 0;
+	std::uint32_t hasLayer = 0;
+};
+
+struct CookedSound
+{
+	std::uint32_t entityIndex = 0;
+	std::uint32_t pathIndex = INVALID_COOKED_STRING;
+};
+
+struct CookedAnimation2d
+{
+	std::uint32_t entityIndex = 0;
+	std::uint32_t pathIndex = INVALID_COOKED_STRING;
+	float speed = 1.0f;
+};
+
+using CookedTransform2d = CookedComponent<Transform2d>;
+using CookedShape = CookedComponent<ShapeDef>;
+using CookedBody2d = CookedComponent<Body2dDef>;
+using CookedCollider = CookedComponent<ColliderDef>;
+
+static_assert(std::is_trivially_copyable<CookedTransform2d>::value, "Cooked records are written and read as raw memory");
+static_assert(std::is_trivially_copyable<CookedShape>::value, "Cooked records are written and read as raw memory");
+static_assert(std::is_trivially_copyable<CookedBody2d>::value, "Cooked records are written and read as raw memory");
+static_assert(std::is_trivially_copyable<CookedCollider>::value, "Cooked records are written and read as raw memory");
+
+/**
+* \brief The .cscene path next to the .scene json
+*/
+std::string GetCookedScenePath(const std::string& scenePath);
+
+/**
+* \brief Convert a scene json into per component type arrays and a string table
+*/
+class SceneCooker
+{
+public:
+	/**
+	* \return false if the scene contains something that cannot be cooked, the json should then be loaded
+	*/
+	bool Cook(const json& sceneJson, std::uint64_t sourceHash);
+	bool Write(const std::string& cookedPath) const;
+private:
+	std::uint32_t AddString(const std::string& value);
+
+	CookedSceneHeader m_Header;
+	std::vector<std::uint32_t> m_EntityNames;
+	std::vector<CookedSystem> m_Systems;
+	std::vector<CookedTransform2d> m_Transforms;
+	std::vector<CookedSprite> m_Sprites;
+	std::vector<CookedShape> m_Shapes;
+	std::vector<CookedSound> m_Sounds;
+	std::vector<CookedAnimation2d> m_Animations;
+	std::vector<CookedBody2d> m_Bodies;
+	std::vector<CookedCollider> m_Colliders;
+	std::string m_StringTable;
+	std::unordered_map<std::string, std::uint32_t> m_StringIndexes;
+};
+
+/**
+* \brief Read only view of a mapped .cscene, the sections are used in place without any copy
+*/
+class CookedSceneView
+{
+public:
+	/**
+	* \return false if the file is missing, corrupted, from another version or cooked from another source
+	*/
+	bool Open(const std::string& cookedPath, std::uint64_t sourceHash);
+	const CookedSceneHeader& GetHeader() const;
+	/**
+	* \return nullptr for INVALID_COOKED_STRING
+	*/
+	const char* GetString(std::uint32_t index) const;
+
+	template<typename TRecord>
+	const TRecord* GetSection(CookedSectionType type, size_t& count) const
+	{
+		count = 0;
+		for (std::uint32_t i = 0U; i < m_Header->sectionCount; i++)
+		{
+			const auto& section = m_Sections[i];
+			if (section.type == static_cast<std::uint32_t>(type) && section.stride == sizeof(TRecord))
+			{
+				count = section.count;
+				return reinterpret_cast<const TRecord*>(m_File.GetData() + section.offset);
+			}
+		}
+		return nullptr;
+	}
+private:
+	MappedFile m_File;
+	const CookedSceneHeader* m_Header = nullptr;
+	const CookedSection* m_Sections = nullptr;
+};
+
+}
+#endif
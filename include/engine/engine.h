@@ -33,6 +33,7 @@ SOFTWARE.
 
 #include <engine/config.h>
 #include <utility/json_utility.h>
+#include <utility/file_utility.h>
 
 #include <editor/profiler.h>
 #include <Remotery.h>
@@ -59,6 +60,8 @@ class Physics2dManager;
 class EntityManager;
 class Transform2dManager;
 class Editor;
+class AssetManager;
+class SystemRegistry;
 struct SystemsContainer;
 
 /**
@@ -88,6 +91,10 @@ public:
 	* \brief Reload is used after loading a new scene
 	*/
 	void Collect();
+	/**
+	* \brief Reload the assets changed on the disk, called each frame when the hot reload is enabled
+	*/
+	void HotReload();
 
 	~Engine();
 	/**
@@ -105,6 +112,11 @@ public:
 	EntityManager* GetEntityManager();
 	Transform2dManager* GetTransform2dManager();
 	Editor* GetEditor();
+	AssetManager* GetAssetManager();
+	/**
+	* \brief Factories of the C++ systems created by the scenes without the Python interpreter
+	*/
+	SystemRegistry* GetSystemRegistry();
 
 	ctpl::thread_pool& GetThreadPool();
 	ProfilerFrameData& GetProfilerFrameData();
@@ -123,6 +135,8 @@ protected:
 	std::unique_ptr<SystemsContainer> m_SystemsContainer;
 
   	ProfilerFrameData m_FrameData;
+	FileWatcher m_FileWatcher;
+	bool m_HotReload = false;
 
 };
 
@@ -27,6 +27,7 @@ SOFTWARE.
 
 #include <vector>
 #include <set>
+#include <mutex>
 
 #include <engine/system.h>
 #include <editor/editor_info.h>
@@ -72,11 +73,32 @@ public:
 	void OnBeforeSceneLoad() override;
 
 	EntityMask GetMask(Entity entity);
+	/**
+	* \brief Component bits of each entity, indexed by entity - 1
+	*/
+	const std::vector<EntityMask>& GetMasks() const;
 	Entity CreateEntity(Entity wantedEntity);
+	/**
+	* \brief Find count free entities in one pass, growing the entity array when there are not enough.
+	* Like CreateEntity, they stay free until a component is added
+	*/
+	std::vector<Entity> CreateEntities(size_t count);
 	void DestroyEntity(Entity entity);
 	bool HasComponent(Entity entity, ComponentType componentType);
+	/**
+	* \brief Set the component bit, only recorded while the masks are deferred
+	*/
 	void AddComponentType(Entity entity, ComponentType componentType);
 	void RemoveComponentType(Entity entity, ComponentType componentType);
+	/**
+	* \brief Record the added component bits instead of writing them, so the masks can be read without a lock while the
+	* component factories run on the thread pool. Must be called on the main thread before starting the tasks
+	*/
+	void DeferComponentTypes();
+	/**
+	* \brief Write the recorded bits and stop deferring, must be called on the main thread after joining the tasks
+	*/
+	void ApplyDeferredComponentTypes();
 	editor::EntityInfo& GetEntityInfo(Entity entity);
 
 	Entity GetEntityByName(std::string entityName) const;
@@ -88,6 +110,12 @@ public:
 
 private:
 	std::vector<EntityMask> m_MaskArray{ INIT_ENTITY_NMB };
+	/**
+	* \brief Component factories of different types can add bits at the same time during the parallel scene loading
+	*/
+	std::mutex m_MaskMutex;
+	bool m_DeferComponentTypes = false;
+	std::vector<std::pair<Entity, EntityMask>> m_DeferredComponentTypes;
 	std::vector<editor::EntityInfo> m_EntityInfos{ INIT_ENTITY_NMB };
 	std::set<ResizeObserver*> m_ResizeObservers;
 	std::set<DestroyObserver*> m_DestroyObservers;
@@ -29,16 +29,26 @@
 #include <memory>
 #include <string>
 #include <list>
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <future>
+#include <functional>
+#include <mutex>
+
+#include <SFML/Audio/SoundBuffer.hpp>
 
 #include <engine/system.h>
 #include <utility/json_utility.h>
 #include <engine/entity.h>
+#include "p2body.h"
 
 
 
 namespace sfge
 {
 enum class ComponentType: int;
+enum class PySystemHook : unsigned char;
 class IComponentFactory;
 class PySystem;
 
@@ -47,6 +57,91 @@ namespace editor
 struct SceneInfo;
 }
 
+/**
+* \brief C++ system of the scene created from the SystemRegistry, called directly without the Python interpreter
+*/
+struct NativeSceneSystem
+{
+	std::string systemClassName;
+	std::unique_ptr<System> system;
+};
+
+/**
+* \brief Components and initial values of the entities created at once by SceneManager::SpawnEntities
+*/
+struct EntitySpawnDef
+{
+	/**
+	* \brief Mask of the Transform2d, Body2d and Sprite ComponentType given to each entity, a body needs a transform and gets one
+	*/
+	int archetype = 0;
+	/**
+	* \brief Null or one x, y position in pixels per entity
+	*/
+	const float* positions = nullptr;
+	/**
+	* \brief Null or one x, y linear velocity in meters per second per entity, as Body2dManager::GetLinearVelocities
+	*/
+	const float* velocities = nullptr;
+	p2BodyType bodyType = p2BodyType::DYNAMIC;
+	std::string texturePath;
+};
+
+/**
+* \brief Scene systems without conflicting component access, the native ones run on the thread pool while the main thread calls the PySystems
+*/
+struct SceneSystemWave
+{
+	std::vector<System*> nativeSystems;
+	/**
+	* \brief Only the PySystems with the hook, a system without update nor fixed update is in no wave
+	*/
+	std::vector<PySystem*> pyUpdateSystems;
+	std::vector<PySystem*> pyFixedUpdateSystems;
+};
+
+/**
+* \brief Scene parsed on a worker thread, waiting for SceneManager::ActivateScene
+*/
+struct PreloadedScene
+{
+	std::string name;
+	std::string path;
+	std::unique_ptr<json> sceneJson;
+	std::vector<std::string> texturePaths;
+	std::vector<std::pair<std::string, std::unique_ptr<sf::SoundBuffer>>> soundBuffers;
+};
+
+/**
+* \brief Entry of the scene index saved in the data folder, the scene is parsed again only when its size or its modification time changed
+*/
+struct SceneIndexEntry
+{
+	std::string name;
+	long long modificationTime = 0;
+	long long size = 0;
+	std::uint64_t hash = 0;
+};
+
+enum class SceneSaveFormat
+{
+	JSON,
+	/**
+	* \brief Cooked scene records, loaded back with SceneManager::LoadSceneSnapshot
+	*/
+	BINARY
+};
+
+/**
+* \brief Timing breakdown of the last scene loaded from json, the vectors are indexed by the log2 of the ComponentType
+*/
+struct SceneLoadStats
+{
+	float entitiesTime = 0.0f;
+	std::vector<size_t> componentCounts = std::vector<size_t>(sizeof(ComponentType) * 8, 0U);
+	std::vector<float> componentTimes = std::vector<float>(sizeof(ComponentType) * 8, 0.0f);
+};
+
 /**
 * \brief The Scene Manager do the transition between two scenes, read from the Engine Configuration the scenes build list
 */
@@ -54,31 +149,85 @@ class SceneManager : public System
 {
 public:
 	SceneManager(Engine& engine);
-	~SceneManager() = default;
+	~SceneManager();
 	void OnEngineInit() override;
 
+	/**
+	* \brief Find the scenes of the data folder, only the scenes changed since the last saved index are parsed
+	*/
 	void SearchScenes(std::string& dataDirname);
 	/**
 	* \brief Finalize and delete everything created in the SceneManager
+	* Called from a system update, the load is applied after the systems of the frame
 	*/
 	void LoadSceneFromName(const std::string& sceneName);
 	/**
 	* \brief Load a Scene and create all its GameObject
 	* \param scenePath the scene path given by the configuration
 	* \return the heap Scene that is automatically destroyed when not used
+	* Called from a system update, the load is applied after the systems of the frame
 	*/
 	void LoadSceneFromPath(const std::string& scenePath);
 	/**
 	* \brief Load a Scene and create all its GameObject
 	* \param sceneName the scene path given by the configuration
 	* \return the heap Scene that is automatically destroyed when not used
+	* Must not be called from a system update, the systems of the frame would be destroyed under the waves
 	*/
 	void LoadSceneFromJson(json& sceneJson, std::unique_ptr<editor::SceneInfo> sceneInfo = nullptr);
+	/**
+	* \brief Write the binary .cscene next to the scene json, loaded instead of the json by LoadSceneFromPath while the json is unchanged
+	* \return false if the scene could not be read or contains components that cannot be cooked
+	*/
+	bool CookScene(const std::string& scenePath);
+	/**
+	* \brief Serialize the live entities and their components, the destroyed entities are written empty to keep the entity ids
+	*/
+	json SerializeScene();
+	/**
+	* \brief Write the live scene and take it as the reference of the next SaveSceneDelta
+	*/
+	bool SaveScene(const std::string& scenePath, SceneSaveFormat format = SceneSaveFormat::JSON);
+	/**
+	* \brief Write only the entities changed since the last SaveScene or SaveSceneDelta, the first delta after a scene load contains the whole scene
+	*/
+	bool SaveSceneDelta(const std::string& deltaPath);
+	/**
+	* \brief Apply a delta written by SaveSceneDelta on the scene json of the previous snapshot
+	*/
+	static void MergeSceneDelta(json& sceneJson, const json& deltaJson);
+	/**
+	* \brief Load a scene written by SaveScene in the binary format
+	*/
+	bool LoadSceneSnapshot(const std::string& snapshotPath);
+	/**
+	* \brief Called for a scene file changed on the disk, the current scene is loaded again if its content changed
+	* \return false if the file is not a scene
+	*/
+	bool ReloadScene(const std::string& scenePath);
+	/**
+	* \brief Swap a PySystem instantiated again after its script was reloaded
+	*/
+	void ReplacePySystem(PySystem* previousPySystem, PySystem* newPySystem);
 	/**
 	 * \brief Return a list of all the scenes available in the data folder, pretty useful for python and the editor
 	 * \return the list of scenes in the data folder
 	 */
 	std::list<std::string> GetAllScenes();
+	/**
+	* \brief Parse the scene and decode its sounds on the thread pool while the current scene keeps running
+	*/
+	void PreloadScene(const std::string& sceneName);
+	/**
+	* \brief Poll the preloading, its textures start decoding as soon as the json is parsed
+	*/
+	bool IsScenePreloaded();
+	/**
+	* \brief Replace the current scene by the preloaded one, waiting for the preloading if needed
+	* \return false if no scene was preloaded
+	* Called from a system update, the activation is applied after the systems of the frame
+	*/
+	bool ActivateScene();
 
 	void AddComponentManager(IComponentFactory* componentFactory, ComponentType componentType);
 
@@ -89,14 +238,124 @@ public:
 
 	void OnBeforeSceneLoad() override;
 	std::vector<PySystem*>& GetSceneSystems();
+	std::vector<NativeSceneSystem>& GetSceneNativeSystems();
+	const std::vector<SceneSystemWave>& GetSystemWaves() const;
+	/**
+	* \brief Forward the contact to the native systems of the scene, the PySystems get it from the PySystemManager
+	*/
+	void ContactNativeSystems(ColliderData* c1, ColliderData* c2, bool enter);
+	/**
+	* \brief Create count entities with the components of the archetype in one call, the texture is loaded once
+	* \return The created entities, in the order of the arrays of the spawn def
+	*/
+	std::vector<Entity> SpawnEntities(size_t count, const EntitySpawnDef& spawnDef);
+	const SceneLoadStats& GetLoadStats() const;
 private:
 
 	void InitScenePySystems();
+	/**
+	* \brief Place each scene system in the wave after the last earlier system it conflicts with,
+	* and list the PySystems of each hook
+	*/
+	void BuildSystemWaves();
+	/**
+	* \brief Run the waves one after the other, the PySystems with the hook stay on the main thread under the GIL
+	*/
+	void RunSystemWaves(PySystemHook hook, const std::function<void(System*)>& nativeCall,
+		const std::function<void(const std::vector<PySystem*>&)>& pyCall);
+	/**
+	* \brief Keep the scene load for after the systems of the frame when they are running
+	* \return false if the load can be done now
+	*/
+	bool DeferSceneLoad(std::function<void()> sceneLoad);
+	/**
+	* \brief Apply the last scene load requested by a system of the frame
+	*/
+	void ApplyDeferredSceneLoad();
+	/**
+	* \brief Search the scenes at the first request when the config asks for a lazy search
+	*/
+	void EnsureScenesSearched();
+	void LoadSceneIndex(const std::string& indexPath);
+	void SaveSceneIndex(const std::string& indexPath);
+	/**
+	* \brief Use the hash of the index while the scene file is unchanged instead of reading the whole file
+	*/
+	bool GetSceneSourceHash(const std::string& scenePath, std::uint64_t& sourceHash);
+	/**
+	* \brief Create the scene from the mapped cooked records without parsing any json
+	* \return false if there is no up to date cooked scene, nothing is loaded then
+	*/
+	bool LoadCookedScene(const std::string& scenePath, const std::string& cookedPath, std::uint64_t sourceHash);
+	/**
+	* \brief Read the name and load the systems of the scene, before its entities in the json and streamed paths
+	*/
+	void LoadSceneHeader(json& sceneJson, editor::SceneInfo& sceneInfo);
+	void LoadScenePySystem(const std::string& scriptPath);
+	void LoadSceneCppSystem(const std::string& systemClassName);
+	/**
+	* \brief Common end of the json and cooked scene loading
+	*/
+	void FinishSceneLoad(std::unique_ptr<editor::SceneInfo> sceneInfo);
+	/**
+	* \brief Load the scene while parsing its file, the whole entities array is never kept in memory
+	*/
+	void LoadSceneFromStream(const std::string& scenePath, std::unique_ptr<editor::SceneInfo> sceneInfo);
+	/**
+	* \brief Create the entities of the json array after the last created entity and their components stage by stage
+	* \return false if there is no entity left
+	*/
+	bool LoadSceneEntities(json& entitiesJson, Entity& lastEntity);
+	/**
+	* \brief Serialize the scene and compute the snapshot hashes of each entity
+	*/
+	json SerializeLiveScene(std::vector<std::uint64_t>& snapshotHashes);
+	json SerializeEntityComponents(Entity entity, size_t typeIndex);
+	/**
+	* \brief Let the component managers index their components by entity for one pass over the scene
+	*/
+	void BeginSerialization();
+	void EndSerialization();
+	void FinishPreload();
+	/**
+	* \brief Run the component factories stage by stage, the independent types of a stage in parallel on the thread pool
+	*/
+	void CreateComponentsByStage(std::vector<std::vector<std::pair<json*, Entity>>>& componentsJsonByType);
 
 	std::vector<PySystem*> m_ScenePySystems;
+	/**
+	* \brief The scene PySystems overriding each called hook, built with the waves
+	*/
+	std::vector<PySystem*> m_ScenePyUpdateSystems;
+	std::vector<PySystem*> m_ScenePyFixedUpdateSystems;
+	std::vector<PySystem*> m_ScenePyDrawSystems;
+	std::vector<NativeSceneSystem> m_SceneNativeSystems;
+	std::vector<SceneSystemWave> m_SystemWaves;
+	/**
+	* \brief Set while the scene systems are called, a scene load would destroy them
+	*/
+	bool m_RunningSystems = false;
+	std::function<void()> m_DeferredSceneLoad;
+	std::mutex m_DeferredSceneLoadMutex;
 	EntityManager* m_EntityManager = nullptr;
 	std::vector<IComponentFactory*> m_ComponentManager{sizeof(ComponentType)*8};
 	std::map<std::string, std::string> m_ScenePathMap;
+	std::map<std::string, SceneIndexEntry> m_SceneIndex;
+	bool m_ScenesSearched = false;
+	SceneLoadStats m_LoadStats;
+	std::string m_SceneName;
+	std::string m_ScenePath;
+	/**
+	* \brief Hash of the scene file the current scene was loaded from or saved to
+	*/
+	std::uint64_t m_SceneSourceHash = 0;
+	json m_SceneSystemsJson = json::array();
+	/**
+	* \brief Hash of the entity name and of the json of each component type at the last snapshot, zero when absent
+	*/
+	std::vector<std::uint64_t> m_SnapshotHashes;
+	std::future<std::unique_ptr<PreloadedScene>> m_PreloadTask;
+	std::unique_ptr<PreloadedScene> m_PreloadedScene;
 
 };
 }
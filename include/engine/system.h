@@ -81,9 +81,25 @@ public:
 
 	Engine& GetEngine() const;
 	bool GetInitlialized() const;
+	/**
+	* \brief Declare the ComponentType masks read and written in update and fixed update,
+	* the SceneManager runs the systems without conflicting access in the same wave.
+	* A system with declared access must not create or destroy entities outside of init
+	*/
+	void SetComponentAccess(int readComponents, int writeComponents);
+	int GetReadComponents() const;
+	int GetWriteComponents() const;
+	bool HasComponentAccess() const;
+	/**
+	* \brief A system conflicts with another one when one writes a component type the other uses, or when any of them did not declare its access
+	*/
+	bool ConflictsWith(const System& system) const;
 protected:
 	bool m_Enable = true;
 	bool m_Initialized = false;
+	bool m_ComponentAccessDeclared = false;
+	int m_ReadComponents = 0;
+	int m_WriteComponents = 0;
 
 	Engine& m_Engine;
 };
@@ -0,0 +1,72 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef SFGE_SYSTEM_REGISTRY_H
+#define SFGE_SYSTEM_REGISTRY_H
+
+#include <string>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+
+#include <engine/system.h>
+
+namespace sfge
+{
+
+using SystemFactory = std::function<std::unique_ptr<System>(Engine&)>;
+
+/**
+* \brief Factories of the C++ systems by class name, a scene system found here is created and called without the Python interpreter
+*/
+class SystemRegistry
+{
+public:
+	/**
+	* \brief Register the factory of a system class, a class name can be registered only once
+	* \return false if the class name is already registered
+	*/
+	bool RegisterSystem(const std::string& systemClassName, SystemFactory factory);
+	template<class T>
+	bool RegisterSystem(const std::string& systemClassName)
+	{
+		return RegisterSystem(systemClassName, [](Engine& engine)
+		{
+			return std::unique_ptr<System>(std::make_unique<T>(engine));
+		});
+	}
+	bool HasSystem(const std::string& systemClassName) const;
+	/**
+	* \brief Create a new instance of a registered system
+	* \return nullptr if the class name is not registered
+	*/
+	std::unique_ptr<System> CreateSystem(const std::string& systemClassName, Engine& engine) const;
+	void Clear();
+private:
+	std::unordered_map<std::string, SystemFactory> m_Factories;
+};
+
+}
+#endif //SFGE_SYSTEM_REGISTRY_H
@@ -56,6 +56,12 @@ public:
 	using SingleComponentManager::SingleComponentManager;
 	Transform2d* AddComponent(Entity entity) override;
 	void CreateComponent(json& componentJson, Entity entity) override;
+	/**
+	* \brief Shared by the json and the cooked scene loading
+	*/
+	void CreateComponent(const Transform2d& def, Entity entity);
+	static Transform2d GetDefFromJson(const json& componentJson);
+	void SerializeComponents(Entity entity, json& componentsJson) override;
 	void DestroyComponent(Entity entity) override;
 	void OnUpdate(float dt) override;
 };
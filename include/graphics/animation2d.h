@@ -0,0 +1,137 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef SFGE_ANIMATION2D_H
+#define SFGE_ANIMATION2D_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <SFML/Graphics/Rect.hpp>
+
+#include <engine/component.h>
+#include <editor/editor.h>
+#include <graphics/texture.h>
+
+namespace sfge
+{
+class SpriteManager;
+class Animation2dManager;
+
+using AnimationClipId = unsigned;
+const AnimationClipId INVALID_ANIMATION_CLIP = 0U;
+
+struct AnimationFrame
+{
+	sf::IntRect textureRect;
+	TextureId textureId = INVALID_TEXTURE;
+};
+
+/**
+* \brief Frame rects of one animation json, loaded once and shared by all the animators playing it
+*/
+struct AnimationClip
+{
+	std::string path;
+	std::string name;
+	std::vector<AnimationFrame> frames;
+	/**
+	 * \brief Duration of one frame in seconds, the json stores it in milliseconds as "speed"
+	 */
+	float frameDuration = 0.1f;
+	bool isLooped = true;
+};
+
+/**
+* \brief Per entity animation state, the frames themselves live in the AnimationClip
+*/
+struct Animation2d
+{
+	AnimationClipId clipId = INVALID_ANIMATION_CLIP;
+	float time = 0.0f;
+	float speed = 1.0f;
+	int currentFrame = -1;
+};
+
+/**
+* \brief Parameters of an Animation2d component, read from the scene json or from the cooked scene
+*/
+struct Animation2dDef
+{
+	std::string path;
+	float speed = 1.0f;
+};
+
+namespace editor
+{
+struct Animation2dInfo : ComponentInfo
+{
+	void DrawOnInspector() override;
+
+	Animation2dManager* animationManager = nullptr;
+};
+}
+
+/**
+* \brief Advance all the animators in one loop and push the new texture rect to the Sprite only when the frame changes
+*/
+class Animation2dManager : public SingleComponentManager<Animation2d, editor::Animation2dInfo, ComponentType::ANIMATION2D>
+{
+public:
+	using SingleComponentManager::SingleComponentManager;
+
+	void OnEngineInit() override;
+	void OnUpdate(float dt) override;
+	void OnBeforeSceneLoad() override;
+
+	Animation2d* AddComponent(Entity entity) override;
+	void CreateComponent(json& componentJson, Entity entity) override;
+	void CreateComponent(const Animation2dDef& def, Entity entity);
+	static Animation2dDef GetDefFromJson(const json& componentJson);
+	void SerializeComponents(Entity entity, json& componentsJson) override;
+	void DestroyComponent(Entity entity) override;
+
+	/**
+	* \brief Load the clip from the animation json or return the already loaded one
+	* \return INVALID_ANIMATION_CLIP if the json or one of its textures could not be loaded
+	*/
+	AnimationClipId LoadClip(const std::string& clipPath);
+	const AnimationClip* GetClip(AnimationClipId clipId) const;
+	/**
+	* \brief Start playing the clip from its first frame
+	*/
+	void SetClip(Entity entity, AnimationClipId clipId);
+	size_t GetClipCount() const;
+protected:
+	void ApplyFrame(Entity entity, const AnimationFrame& frame);
+
+	SpriteManager* m_SpriteManager = nullptr;
+	TextureManager* m_TextureManager = nullptr;
+	std::vector<AnimationClip> m_Clips;
+	std::unordered_map<std::string, AnimationClipId> m_ClipIds;
+};
+}
+#endif //SFGE_ANIMATION2D_H
@@ -0,0 +1,125 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef SFGE_DEBUG_DRAW_H
+#define SFGE_DEBUG_DRAW_H
+
+#include <bitset>
+#include <string>
+#include <vector>
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+
+#include <engine/vector.h>
+
+namespace sf
+{
+class RenderTarget;
+}
+
+namespace sfge
+{
+class RenderCommandList;
+class RenderThread;
+
+/**
+ * \brief Bitmask used to switch on and off whole families of debug primitives
+ */
+enum class DebugDrawCategory : int
+{
+	NONE = 0,
+	GENERAL = 1 << 0,
+	PHYSICS = 1 << 1,
+	VECTOR = 1 << 2,
+	RAYCAST = 1 << 3,
+	ALL = ~0
+};
+
+/**
+ * \brief Immediate mode debug drawing, every primitive of the frame is accumulated in one vertex buffer and flushed in one draw call
+ */
+class DebugDraw
+{
+public:
+	void SetCategoryEnabled(DebugDrawCategory category, bool enable);
+	bool IsCategoryEnabled(DebugDrawCategory category) const;
+	void SetEnabledCategories(int categories);
+	int GetEnabledCategories() const;
+
+	void DrawLine(Vec2f from, Vec2f to, sf::Color color, DebugDrawCategory category = DebugDrawCategory::GENERAL);
+	/**
+	 * \brief Draw pointCount/2 independent segments, points being stored as consecutive (from, to) pairs of floats
+	 */
+	void DrawLines(const float* points, size_t pointCount, sf::Color color, DebugDrawCategory category = DebugDrawCategory::GENERAL);
+	void DrawVector(Vec2f drawingVector, Vec2f originPos, sf::Color color, float pixelResolution,
+		DebugDrawCategory category = DebugDrawCategory::VECTOR);
+	void DrawCircle(Vec2f center, float radius, sf::Color color, DebugDrawCategory category = DebugDrawCategory::GENERAL);
+	/**
+	 * \brief Draw the outline of a box
+	 * \param angle Rotation of the box in degrees, like Transform2d::EulerAngle
+	 */
+	void DrawBox(Vec2f center, Vec2f size, float angle, sf::Color color, DebugDrawCategory category = DebugDrawCategory::GENERAL);
+	void DrawText(Vec2f position, const std::string& text, sf::Color color, DebugDrawCategory category = DebugDrawCategory::GENERAL);
+
+	/**
+	 * \brief Draw everything accumulated since the last flush in one batch and start a new frame
+	 */
+	void Flush(sf::RenderTarget& target);
+	void Flush(RenderCommandList& commandList);
+	void Clear();
+
+	void SetFontPath(const std::string& fontPath);
+	/**
+	 * \brief The recorded text reads the glyph page of the font, the render thread is waited for before a new glyph modifies it
+	 */
+	void SetRenderThread(RenderThread* renderThread);
+	size_t GetLineVertexCount() const;
+
+	static constexpr unsigned textCharacterSize = 14;
+	static constexpr size_t circleSegments = 24;
+protected:
+	bool LoadFont();
+	void WaitForRenderThread();
+
+	/**
+	 * \brief The collider outlines of the PHYSICS category are opt-in
+	 */
+	int m_EnabledCategories = static_cast<int>(DebugDrawCategory::ALL) & ~static_cast<int>(DebugDrawCategory::PHYSICS);
+	std::vector<sf::Vertex> m_LineVertices;
+	std::vector<sf::Vertex> m_TextVertices;
+	std::string m_FontPath;
+	sf::Font m_Font;
+	bool m_FontLoaded = false;
+	bool m_FontFailed = false;
+	/**
+	 * \brief Characters already rendered in the glyph page, getGlyph does not touch the page texture for them
+	 */
+	std::bitset<256> m_LoadedGlyphs;
+	RenderThread* m_RenderThread = nullptr;
+};
+}
+#endif //SFGE_DEBUG_DRAW_H
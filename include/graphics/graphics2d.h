@@ -29,10 +29,20 @@ SOFTWARE.
 #include <graphics/shape2d.h>
 #include <graphics/texture.h>
 #include <graphics/sprite2d.h>
+#include <graphics/animation2d.h>
+#include <graphics/render_thread.h>
+#include <graphics/debug_draw.h>
+#include <graphics/sprite_instancing.h>
 
 namespace sfge
 {
 
+/**
+* \brief Load the OpenGL extension functions with GLEW, only the first call does the work
+* \return false if GLEW could not be initialized, a GL context must be active on the calling thread
+*/
+bool InitGlew();
+
 /**
 * \brief The Graphics Manager
 */
@@ -52,6 +62,9 @@ public:
 		*/
 	void OnUpdate(float dt) override;
 	void OnDraw() override;
+	/**
+	* \brief Present the frame, or hand it to the render thread when it is enabled
+	*/
 	void Display();
 	/**
 	* \brief Destroy the window and other
@@ -65,6 +78,32 @@ public:
 
 	void DrawLine(Vec2f from, Vec2f to, sf::Color color=sf::Color::Red);
     void DrawVector(Vec2f drawingVector, Vec2f originPos, sf::Color color=sf::Color::Red);
+	/**
+	* \brief Draw in one batch all the debug primitives of the frame, called after the game systems and before the editor
+	*/
+	void FlushDebugDraw();
+	/**
+	* \brief Draw raw vertices, recorded in the current RenderCommandList when the render thread is enabled
+	*/
+	void DrawVertices(const sf::Vertex* vertices, size_t count, sf::PrimitiveType primitive, const sf::Texture* texture = nullptr);
+	/**
+	* \brief Draw sprites expanded by the vertex shader, falling back to CPU generated quads when instancing is not supported
+	*/
+	void DrawSpriteInstances(const SpriteInstance* instances, size_t count, const sf::Texture* texture);
+	bool IsSpriteInstancingEnabled() const;
+	/**
+	* \brief Join the render thread and give the GL context back to the main thread
+	*/
+	void StopRenderThread();
+	/**
+	* \brief Wait for the render thread to display the frame in flight, must be called before modifying or destroying a texture it may read
+	*/
+	void WaitForRenderThread();
+	/**
+	* \brief The list to record draw calls in this frame
+	* \return nullptr when the render thread is disabled and draw calls go directly to the window
+	*/
+	RenderCommandList* GetRenderCommandList();
 	/**
 	* \brief Getter of the window created in GraphicsManager
 	* \return The SFML window
@@ -73,18 +112,29 @@ public:
 
 	ShapeManager* GetShapeManager();
 	SpriteManager* GetSpriteManager();
+	Animation2dManager* GetAnimation2dManager();
 	TextureManager* GetTextureManager();
+	DebugDraw* GetDebugDraw();
 
 protected:
 	bool m_Windowless = false;
+	bool m_SpriteInstancing = false;
 	/**
 	* \brief Write to log the OpenGL version
 	*/
 	void CheckVersion() const;
 	TextureManager m_TextureManager{m_Engine};
 	SpriteManager m_SpriteManager{m_Engine};
+	Animation2dManager m_AnimationManager{m_Engine};
 	ShapeManager m_ShapeManager{m_Engine};
+	DebugDraw m_DebugDraw;
+	InstancedSpriteRenderer m_SpriteRenderer;
+	/**
+	* \brief Sprite batches of the frame when the render thread is disabled
+	*/
+	RenderCommandList m_SpriteBatchList;
 	std::unique_ptr<sf::RenderWindow> m_Window;
+	std::unique_ptr<RenderThread> m_RenderThread;
 
 	const float debugVectorPixelResolution = 20.f;
 };
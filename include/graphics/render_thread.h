@@ -0,0 +1,175 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef SFGE_RENDER_THREAD_H
+#define SFGE_RENDER_THREAD_H
+
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+
+#include <graphics/sprite_instancing.h>
+
+struct ImDrawData;
+struct ImDrawList;
+
+namespace sf
+{
+class RenderTarget;
+class RenderWindow;
+class Texture;
+}
+
+namespace sfge
+{
+
+/**
+ * \brief A contiguous range of vertices, or of sprite instances, sharing the same primitive type and texture
+ */
+struct RenderBatch
+{
+	bool instanced = false;
+	sf::PrimitiveType primitive = sf::Triangles;
+	const sf::Texture* texture = nullptr;
+	size_t start = 0;
+	size_t count = 0;
+};
+
+/**
+ * \brief Self-contained description of one frame, recorded by the simulation and replayed by the RenderThread.
+ * Everything the GPU needs is copied in, so the recording side can move on to the next frame as soon as it is submitted.
+ */
+class RenderCommandList
+{
+public:
+	RenderCommandList() = default;
+	~RenderCommandList();
+	RenderCommandList(const RenderCommandList&) = delete;
+	RenderCommandList& operator=(const RenderCommandList&) = delete;
+
+	/**
+	 * \brief Empty the list while keeping the allocated storage for the next frame
+	 */
+	void Reset();
+	void SetClearColor(sf::Color clearColor);
+	/**
+	 * \brief Append vertices, merging with the previous batch when primitive and texture match
+	 */
+	void AddVertices(const sf::Vertex* vertices, size_t count, sf::PrimitiveType primitive, const sf::Texture* texture = nullptr);
+	/**
+	 * \brief Append a quad given in triangle strip order (the sf::Sprite layout) as two triangles
+	 */
+	void AddQuad(const sf::Vertex* quad, const sf::Texture* texture);
+	/**
+	 * \brief Append sprites expanded on the GPU, merging with the previous instanced batch using the same texture
+	 */
+	void AddSpriteInstances(const SpriteInstance* instances, size_t count, const sf::Texture* texture);
+	/**
+	 * \brief Deep copy the ImGui draw data, so ImGui can start its next frame while this one is rendered
+	 */
+	void SetImGuiDrawData(ImDrawData* drawData);
+	/**
+	 * \brief Replay the recorded frame, must be called on the thread owning the GL context of the target
+	 * \param spriteRenderer Used for the instanced batches, they are expanded on the CPU when it is null or unsupported
+	 */
+	void Execute(sf::RenderTarget& target, InstancedSpriteRenderer* spriteRenderer = nullptr) const;
+	/**
+	 * \brief Draw the batches only, without clearing the target nor drawing ImGui
+	 */
+	void ExecuteBatches(sf::RenderTarget& target, InstancedSpriteRenderer* spriteRenderer = nullptr) const;
+
+	size_t GetBatchCount() const;
+	size_t GetVertexCount() const;
+	const std::vector<RenderBatch>& GetBatches() const;
+protected:
+	void ClearImGuiDrawLists();
+	void ExecuteImGui(sf::RenderTarget& target) const;
+
+	sf::Color m_ClearColor = sf::Color::Black;
+	std::vector<sf::Vertex> m_Vertices;
+	std::vector<RenderBatch> m_Batches;
+	std::vector<SpriteInstance> m_SpriteInstances;
+	std::vector<ImDrawList*> m_ImGuiDrawLists;
+	float m_ImGuiDisplaySize[2] = {0.0f, 0.0f};
+	float m_ImGuiFramebufferScale[2] = {1.0f, 1.0f};
+};
+
+/**
+ * \brief Owns the GL context of the window and consumes the RenderCommandList submitted every frame.
+ * Two lists are used, one being recorded by the simulation while the other is drawn.
+ */
+class RenderThread
+{
+public:
+	explicit RenderThread(sf::RenderWindow& window);
+	~RenderThread();
+	RenderThread(const RenderThread&) = delete;
+	RenderThread& operator=(const RenderThread&) = delete;
+
+	void Start();
+	/**
+	 * \brief Finish the frame in flight, join the thread and give the GL context back to the calling thread
+	 */
+	void Stop();
+	/**
+	 * \brief The list the simulation is currently allowed to record in
+	 */
+	RenderCommandList& GetRecordingList();
+	/**
+	 * \brief Hand the recorded list to the render thread, waiting only if the previous frame is still being drawn
+	 */
+	void Submit();
+	/**
+	 * \brief Block until the submitted frame is displayed, so the resources it reads can be modified
+	 */
+	void WaitForFrame();
+	bool IsRunning() const;
+	/**
+	 * \brief Must be set before Start, its GL objects are created and released on the render thread
+	 */
+	void SetSpriteRenderer(InstancedSpriteRenderer* spriteRenderer);
+protected:
+	void Loop();
+
+	sf::RenderWindow& m_Window;
+	InstancedSpriteRenderer* m_SpriteRenderer = nullptr;
+	std::thread m_Thread;
+	std::mutex m_Mutex;
+	std::condition_variable m_Condition;
+	std::array<RenderCommandList, 2> m_CommandLists;
+	size_t m_RecordingIndex = 0;
+	size_t m_SubmittedIndex = 0;
+	bool m_FrameSubmitted = false;
+	bool m_Running = false;
+};
+
+}
+#endif //SFGE_RENDER_THREAD_H
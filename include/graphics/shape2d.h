@@ -36,6 +36,7 @@ SOFTWARE.
 
 namespace sfge
 {
+class RenderCommandList;
 
 enum class ShapeType
 {
@@ -46,6 +47,17 @@ enum class ShapeType
 	CONVEX,
 };
 
+/**
+* \brief Parameters of a Shape component, read from the scene json or from the cooked scene
+*/
+struct ShapeDef
+{
+	ShapeType shapeType = ShapeType::NONE;
+	sf::Vector2f offset;
+	float radius = 10.0f;
+	sf::Vector2f size;
+};
+
 class Shape : public Offsetable
 {
 public:
@@ -55,11 +67,17 @@ public:
   	Shape ( const Shape & ) = delete; //delete copy constructor
   	virtual ~Shape();
 	void Draw(sf::RenderWindow& window) const;
+	/**
+	* \brief Record the fill and the outline of the shape as transformed triangles instead of drawing it
+	*/
+	void Draw(RenderCommandList& commandList) const;
 	void SetFillColor(sf::Color color) const;
 	void Update() const;
 	void SetShape(std::unique_ptr<sf::Shape> shape);
 	sf::Shape* GetShape();
 protected:
+	void DrawOutline(RenderCommandList& commandList) const;
+
 	friend class ShapeManager;
 	Transform2d transform;
 	std::unique_ptr<sf::Shape> m_Shape = nullptr;
@@ -88,11 +106,15 @@ public:
 
 	void OnEngineInit() override;
 	void DrawShapes(sf::RenderWindow &window);
+	void DrawShapes(RenderCommandList& commandList);
 	void OnUpdate(float dt) override;
 	void OnBeforeSceneLoad() override;
 
 	Shape* AddComponent(Entity entity) override;
 	void CreateComponent(json& componentJson, Entity entity) override;
+	void CreateComponent(const ShapeDef& def, Entity entity);
+	static ShapeDef GetDefFromJson(const json& componentJson);
+	void SerializeComponents(Entity entity, json& componentsJson) override;
 	void DestroyComponent(Entity entity) override;
 
 	void OnResize(size_t new_size) override;
@@ -38,6 +38,8 @@ SOFTWARE.
 namespace sfge
 {
 class Graphics2dManager;
+class RenderCommandList;
+struct SpriteInstance;
 /**
 * \brief Sprite component used in the GameObject
 */
@@ -52,7 +54,25 @@ public:
 	void Init();
 	void Update();
 	void Draw(sf::RenderWindow& window);
-	void SetTexture(sf::Texture* newTexture);
+	/**
+	* \brief Record the transformed quad of the sprite instead of drawing it
+	*/
+	void Draw(RenderCommandList& commandList) const;
+	/**
+	* \brief Fill the GPU instance of the sprite directly from the transform
+	* \return false if the sprite has no texture and should not be drawn
+	*/
+	bool FillInstance(const Transform2d& spriteTransform, SpriteInstance& instance) const;
+	const sf::Texture* GetTexture() const;
+	/**
+	* \brief Set the texture and center the origin
+	* \param resetRect Show the whole texture, used when a placeholder is replaced by the loaded texture
+	*/
+	void SetTexture(sf::Texture* newTexture, bool resetRect = false);
+	/**
+	* \brief Show only a part of the texture, keeping the sprite centered
+	*/
+	void SetTextureRect(const sf::IntRect& textureRect);
 protected:
 	friend class SpriteManager;
 	Transform2d transform;
@@ -60,6 +80,16 @@ protected:
 };
 
 
+/**
+* \brief Parameters of a Sprite component, read from the scene json or from the cooked scene
+*/
+struct SpriteDef
+{
+	std::string path;
+	bool hasLayer = false;
+	int layer = 0;
+};
+
 namespace editor
 {
 struct SpriteInfo : ComponentInfo
@@ -83,12 +113,28 @@ public:
 	void OnEngineInit() override;
 	void OnUpdate(float dt) override;
 	void DrawSprites(sf::RenderWindow &window);
+	void DrawSprites(RenderCommandList& commandList);
+	/**
+	* \brief Record the sprites as GPU instances, reading the Transform2d array directly instead of the sf::Sprite
+	*/
+	void DrawSpriteInstances(RenderCommandList& commandList);
 
 	void OnBeforeSceneLoad() override;
 	void OnAfterSceneLoad() override;
 	Sprite* AddComponent(Entity entity) override;
 	void CreateComponent(json& componentJson, Entity entity) override;
+	void CreateComponent(const SpriteDef& def, Entity entity);
+	/**
+	* \brief Give the same sprite to all the entities, the texture is looked up once
+	*/
+	void CreateComponents(const SpriteDef& def, const std::vector<Entity>& entities);
+	static SpriteDef GetDefFromJson(const json& componentJson);
+	void SerializeComponents(Entity entity, json& componentsJson) override;
 	void DestroyComponent(Entity entity) override;
+	/**
+	* \brief Refresh the sprites that were showing the placeholder of this texture
+	*/
+	void OnTextureReady(TextureId textureId);
 
 	void OnResize(size_t new_size) override;
 protected:
@@ -0,0 +1,116 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef SFGE_SPRITE_INSTANCING_H
+#define SFGE_SPRITE_INSTANCING_H
+
+#include <string>
+#include <vector>
+
+#include <SFML/Config.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+namespace sf
+{
+class RenderTarget;
+class Texture;
+class Color;
+}
+
+namespace sfge
+{
+
+/**
+ * \brief Per sprite data uploaded to the GPU, the quad corners are generated by the vertex shader
+ */
+struct SpriteInstance
+{
+	sf::Vector2f position;
+	/**
+	 * \brief Final size factor of the quad, multiplied by the size of the uv rect in pixels
+	 */
+	sf::Vector2f scale;
+	/**
+	 * \brief Rotation in degrees, like Transform2d::EulerAngle
+	 */
+	float rotation = 0.0f;
+	sf::Uint8 color[4] = {255, 255, 255, 255};
+	/**
+	 * \brief left, top, width, height of the texture rect normalized to [0, 65535]
+	 */
+	sf::Uint16 uvRect[4] = {0, 0, 65535, 65535};
+
+	void SetColor(const sf::Color& newColor);
+	/**
+	 * \brief Set the uv rect, a negative width or height flips the sign of scale so it must be called after setting scale
+	 */
+	void SetTextureRect(const sf::IntRect& textureRect, sf::Vector2u textureSize);
+};
+static_assert(sizeof(SpriteInstance) == 32, "SpriteInstance is uploaded as is and must stay 32 bytes");
+
+/**
+ * \brief Draw SpriteInstance arrays with one instanced draw call per texture, using data/shaders/ecs.vert and ecs.frag
+ * GL resources are created lazily on the thread owning the GL context.
+ */
+class InstancedSpriteRenderer
+{
+public:
+	InstancedSpriteRenderer() = default;
+	~InstancedSpriteRenderer() = default;
+	InstancedSpriteRenderer(const InstancedSpriteRenderer&) = delete;
+	InstancedSpriteRenderer& operator=(const InstancedSpriteRenderer&) = delete;
+
+	void SetShaderPaths(const std::string& vertexShaderPath, const std::string& fragmentShaderPath);
+	/**
+	 * \brief Draw the instances in the target
+	 * \return false if the instanced path is not supported, the caller should then use DrawFallback
+	 */
+	bool Draw(sf::RenderTarget& target, const SpriteInstance* instances, size_t count, const sf::Texture* texture);
+	/**
+	 * \brief Expand the instances into SFML vertices on the CPU, used when the GL path is not available
+	 */
+	static void DrawFallback(sf::RenderTarget& target, const SpriteInstance* instances, size_t count, const sf::Texture* texture);
+	/**
+	 * \brief Delete the GL objects, the GL context used for drawing must be active
+	 */
+	void Release();
+protected:
+	bool Init();
+
+	std::string m_VertexShaderPath;
+	std::string m_FragmentShaderPath;
+	bool m_Initialized = false;
+	bool m_Supported = false;
+	unsigned m_Program = 0;
+	unsigned m_VertexArray = 0;
+	unsigned m_QuadBuffer = 0;
+	unsigned m_InstanceBuffer = 0;
+	int m_OrthoViewLocation = -1;
+	int m_TextureSizeLocation = -1;
+	int m_TextureLocation = -1;
+};
+}
+#endif //SFGE_SPRITE_INSTANCING_H
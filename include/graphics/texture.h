@@ -26,8 +26,12 @@ SOFTWARE.
 #define SFGE_TEXTURE_H_
 
 //STL
+#include <cstdint>
 #include <string>
 #include <memory>
+#include <mutex>
+#include <vector>
+#include <unordered_map>
 
 
 //Externals
@@ -36,6 +40,7 @@ SOFTWARE.
 
 #include <engine/system.h>
 #include <engine/globals.h>
+#include <engine/asset.h>
 
 namespace sfge
 {
@@ -43,6 +48,62 @@ namespace sfge
 using TextureId = unsigned;
 const TextureId INVALID_TEXTURE = 0U;
 
+enum class TextureFormat : std::uint32_t
+{
+	RGBA8 = 0,
+	DXT1,
+	DXT3,
+	DXT5
+};
+
+const std::uint32_t TEXTURE_CACHE_MAGIC = 0x58544653U;
+const std::uint32_t TEXTURE_CACHE_VERSION = 1U;
+
+/**
+* \brief Start of a texture cache file, followed by the pixels ready to be uploaded
+*/
+struct TextureCacheHeader
+{
+	std::uint32_t magic = TEXTURE_CACHE_MAGIC;
+	std::uint32_t version = TEXTURE_CACHE_VERSION;
+	std::uint32_t width = 0;
+	std::uint32_t height = 0;
+	std::uint32_t format = static_cast<std::uint32_t>(TextureFormat::RGBA8);
+	std::uint32_t dataSize = 0;
+};
+
+/**
+* \brief Image decoded on a worker thread, waiting to be uploaded to the GPU by the TextureManager
+*/
+struct TextureDecodeResult
+{
+	TextureId textureId = INVALID_TEXTURE;
+	unsigned generation = 0U;
+	bool success = false;
+	bool fromCache = false;
+	TextureFormat format = TextureFormat::RGBA8;
+	/**
+	* \brief Used for RGBA8
+	*/
+	std::unique_ptr<sf::Image> image;
+	/**
+	* \brief First mip level of a DXT texture, uploaded as is
+	*/
+	std::vector<std::uint8_t> compressedData;
+	sf::Vector2u size;
+
+	size_t GetByteSize() const;
+};
+
+/**
+* \brief Shared between the TextureManager and the decoding tasks, so a task finishing after the manager is destroyed stays valid
+*/
+struct TextureDecodeQueue
+{
+	std::mutex mutex;
+	std::vector<TextureDecodeResult> results;
+};
+
 /**
 * \brief The Texture Manager is the cache of all the textures used for sprites or other objects
 *
@@ -57,19 +118,47 @@ public:
 	 * \brief Load all the textures in the data in Shipping mode
 	 */
 	void OnEngineInit() override;
+	/**
+	 * \brief Upload the textures decoded by the thread pool, within the per frame budget
+	 */
+	void OnUpdate(float dt) override;
 
 	/**
 	* \brief load the texture from the disk or the texture cache
 	* \param filename The filename string of the texture
+	* \param async If true, the image is decoded on the thread pool and a placeholder is shown until it is uploaded
 	* \return The strictly positive texture id > 0, if equals 0 then the texture was not loaded
 	*/
-	TextureId LoadTexture(std::string filename);
+	TextureId LoadTexture(std::string filename, bool async = false);
+	/**
+	* \brief Start decoding a texture needed by the next scene without taking a reference,
+	* so it is only kept if the next scene uses it
+	*/
+	TextureId PreloadTexture(const std::string& filename);
+	/**
+	* \brief Decode again a texture changed on the disk, the sprites keep their sf::Texture
+	* \return false if the file is not a loaded texture
+	*/
+	bool ReloadTexture(const std::string& filename);
 	/**
 	* \brief Used after loading the texture in the texture cache to get the pointer to the texture
 	* \param text_id The texture id striclty positive
-	* \return The pointer to the texture in memory
+	* \return The pointer to the texture in memory, the pointer stays the same when the placeholder is replaced
 	*/
 	sf::Texture* GetTexture(TextureId textureId);
+	/**
+	* \brief False while the texture is decoded and if its decode or upload failed
+	*/
+	bool IsTextureReady(TextureId textureId) const;
+	/**
+	* \brief Textures uploaded during the last OnUpdate, used to refresh the sprites showing the placeholder
+	*/
+	const std::vector<TextureId>& GetReadyTextures() const;
+	size_t GetPendingTexturesCount() const;
+	/**
+	* \brief Number of textures uploaded from a texture cache entry instead of decoding their source
+	*/
+	size_t GetCacheReadCount() const;
 	
 	void OnBeforeSceneLoad() override;
 
@@ -80,12 +169,54 @@ public:
 private:
   	bool HasValidExtension(std::string filename);
 	void LoadTextures(std::string dataDirname);
+	bool LoadTextureSync(TextureId textureId, const std::string& filename);
+	void StartDecode(TextureId textureId, const std::string& filename);
+	/**
+	* \brief Read a .dds, or the texture cache entry of the source hash, or decode the file and write its cache entry
+	* \param cacheDirname Empty to skip the texture cache
+	*/
+	static bool DecodeTexture(const std::string& filename, xxh::hash64_t sourceHash, const std::string& cacheDirname, TextureDecodeResult& result);
+	static bool ReadCachedTexture(const std::string& cachePath, TextureDecodeResult& result);
+	static void WriteCachedTexture(const std::string& cachePath, const sf::Image& image);
+	bool UploadTexture(sf::Texture& texture, const TextureDecodeResult& result);
+	xxh::hash64_t GetSourceHash(const std::string& filename) const;
+	void InitPlaceholder();
+	/**
+	* \brief The render thread draws the previous frame with raw sf::Texture pointers, it must be done before a texture is changed
+	*/
+	void WaitForRenderThread();
 
 	std::vector<std::string> m_TexturePaths {INIT_ENTITY_NMB * 4};
 	std::vector<sf::Texture> m_Textures { INIT_ENTITY_NMB * 4 };
 	std::vector<size_t> m_TextureIdsRefCounts = std::vector<size_t>(INIT_ENTITY_NMB * 4, 0 );
+	/**
+	* \brief Incremented each time a slot is reloaded or evicted, so late decode results are dropped
+	*/
+	std::vector<unsigned> m_TextureGenerations = std::vector<unsigned>(INIT_ENTITY_NMB * 4, 0U);
+	std::vector<bool> m_TexturePending = std::vector<bool>(INIT_ENTITY_NMB * 4, false);
+	/**
+	* \brief Set when the last decode or upload of the slot failed, the slot may still show the placeholder
+	*/
+	std::vector<bool> m_TextureFailed = std::vector<bool>(INIT_ENTITY_NMB * 4, false);
 	TextureId m_IncrementId = 0U;
-
+	/**
+	* \brief Files with the same content share the same asset, and so the same texture
+	*/
+	std::unordered_map<AssetId, TextureId> m_AssetTextureIds;
+
+	std::shared_ptr<TextureDecodeQueue> m_DecodeQueue = std::make_shared<TextureDecodeQueue>();
+	std::vector<TextureDecodeResult> m_UploadQueue;
+	std::vector<TextureId> m_ReadyTextures;
+	size_t m_PendingTexturesCount = 0;
+	size_t m_CacheReadCount = 0;
+	size_t m_UploadBudget = 16U * 1024U * 1024U;
+	std::string m_CacheDirname;
+	/**
+	* \brief Checked at the first DXT upload, the GL extension functions are loaded with GLEW
+	*/
+	bool m_CompressedFormatsChecked = false;
+	bool m_CompressedFormatsSupported = false;
+	sf::Image m_PlaceholderImage;
 };
 }
 
@@ -34,6 +34,17 @@ SOFTWARE.
 namespace sfge
 {
 
+/**
+* \brief Parameters of a Body2d component, read from the scene json or from the cooked scene
+*/
+struct Body2dDef
+{
+	p2BodyType bodyType = p2BodyType::STATIC;
+	float gravityScale = 1.0f;
+	Vec2f offset;
+	Vec2f velocity;
+};
+
 class Body2d: public Offsetable
 {
 public:
@@ -62,6 +73,10 @@ struct Body2dInfo : ComponentInfo
 	std::deque<p2Vec2>& GetVelocities();
 
 	Body2dManager* bodyManager = nullptr;
+	/**
+	* \brief Kept for the scene saving, the body does not expose it
+	*/
+	float gravityScale = 1.0f;
 private:
 	std::deque<p2Vec2> m_Velocities;
 	const size_t m_VelocitiesMaxSize = 120;
@@ -76,13 +91,39 @@ public:
 	void OnFixedUpdate() override;
 	Body2d* AddComponent(Entity entity) override;
 	void CreateComponent(json& componentJson, Entity entity) override;
+	void CreateComponent(const Body2dDef& def, Entity entity);
+	static Body2dDef GetDefFromJson(const json& componentJson);
+	void SerializeComponents(Entity entity, json& componentsJson) override;
 	void DestroyComponent(Entity entity) override;
 
 	void OnResize(size_t new_size) override;
+	/**
+	* \brief Apply the velocities changed and the forces added through the arrays since the last step, called before the world step
+	*/
+	void ApplyArrayChanges();
+	/**
+	* \brief Linear velocity in meter per second of each entity body, indexed by entity - 1, copied from the bodies after each step
+	*/
+	std::vector<p2Vec2>& GetLinearVelocities();
+	/**
+	* \brief Force in newton applied to each entity body at the next step, indexed by entity - 1 and reset after the step
+	*/
+	std::vector<p2Vec2>& GetForces();
+	/**
+	* \brief Bodies created in the current world, which cannot hold more than MAX_BODY_LEN
+	*/
+	size_t GetBodyCount() const;
 
 private:
 	Transform2dManager* m_Transform2dManager;
 	std::weak_ptr<p2World> m_WorldPtr;
+	std::vector<p2Vec2> m_LinearVelocities;
+	/**
+	* \brief Velocities as copied after the last step, a different value in m_LinearVelocities was written by a system
+	*/
+	std::vector<p2Vec2> m_SyncedLinearVelocities;
+	std::vector<p2Vec2> m_Forces;
+	size_t m_BodyCount = 0;
 };
 
 
@@ -41,6 +41,21 @@ enum class ColliderType
 	POLYGON
 };
 
+/**
+* \brief Parameters of a collider, read from the scene json or from the cooked scene, sizes are in pixels
+*/
+struct ColliderDef
+{
+	ColliderType colliderType = ColliderType::NONE;
+	bool isSensor = false;
+	bool hasRadius = false;
+	float radius = 0.0f;
+	Vec2f size;
+	float restitution = 0.0f;
+};
+
+class DebugDraw;
+
 struct ColliderData
 {
 	Entity entity = INVALID_ENTITY;
@@ -52,6 +67,10 @@ namespace editor
 struct ColliderInfo : ComponentInfo
 {
     ColliderData* data;
+	/**
+	* \brief Kept for the scene saving, the p2Collider does not expose its restitution
+	*/
+	ColliderDef def;
 	void DrawOnInspector() override;
 };
 }
@@ -62,11 +81,19 @@ public:
 	void OnEngineInit() override;
 	ColliderData* AddComponent(Entity entity) override;
 	void CreateComponent(json& componentJson, Entity entity)override;
+	void CreateComponent(const ColliderDef& def, Entity entity);
+	static ColliderDef GetDefFromJson(const json& componentJson);
+	void SerializeComponents(Entity entity, json& componentsJson) override;
 	void DestroyComponent(Entity entity) override;
   	ColliderData* GetComponentPtr(Entity entity) override;
+	/**
+	* \brief Outline every collider with the PHYSICS category of the DebugDraw
+	*/
+	void DrawDebug(DebugDraw& debugDraw);
 protected:
 
   	int GetFreeComponentIndex() override;
+	Entity GetComponentEntity(size_t index) override;
 	Body2dManager* m_BodyManager = nullptr;
 };
 
@@ -92,6 +92,10 @@ public:
 	void OnUpdate(float dt) override;
 	void OnFixedUpdate() override;
 	/**
+	* \brief Outline the colliders when the PHYSICS debug draw category is enabled
+	*/
+	void OnDraw() override;
+	/**
 	* \brief Called at the end of the program to Destroy a b2World, if it sill exists
 	*/
 	void Destroy() override;
@@ -25,6 +25,12 @@
 #ifndef SFGE_PYSYSTEM_H
 #define SFGE_PYSYSTEM_H
 
+#include <array>
+#include <deque>
+#include <unordered_map>
+
+#include <Remotery.h>
+
 #include <utility/python_utility.h>
 
 #include <engine/system.h>
@@ -35,6 +41,69 @@ namespace sfge
 
 using InstanceId = unsigned;
 using ModuleId = unsigned;
+
+enum class PySystemHook : unsigned char
+{
+	INIT = 0,
+	UPDATE,
+	FIXED_UPDATE,
+	DRAW,
+	CONTACT,
+	LENGTH
+};
+
+/**
+* \brief Last call durations in milliseconds of each hook of one system, shown in the Stats window
+*/
+struct PySystemProfile
+{
+	static constexpr size_t HISTORY_LENGTH = 120;
+	void AddTime(PySystemHook hook, float time);
+	float GetAverageTime(PySystemHook hook) const;
+	/**
+	* \brief Oldest first, for ImGui::PlotHistogram
+	*/
+	size_t GetHistoryOffset(PySystemHook hook) const;
+
+	std::array<std::array<float, HISTORY_LENGTH>, static_cast<size_t>(PySystemHook::LENGTH)> history{};
+	std::array<size_t, static_cast<size_t>(PySystemHook::LENGTH)> sampleCounts{};
+	float maxTime = 0.0f;
+};
+
+/**
+* \brief Cumulated time of a Python function while the profiling mode of the PySystemManager is on
+*/
+struct PyHotspot
+{
+	std::string location;
+	float time = 0.0f;
+	size_t calls = 0;
+};
+
+/**
+* \brief Python overrides of the System hooks of one instance, resolved once when the instance is created
+*/
+struct PySystemHooks
+{
+	/**
+	* \brief Borrowed, the instance is kept alive by the PySystemManager
+	*/
+	py::handle instance;
+	/**
+	* \brief Functions of the Python class called with the instance, empty when the class keeps the System hook
+	*/
+	std::array<py::object, static_cast<size_t>(PySystemHook::LENGTH)> functions;
+	/**
+	* \brief A C++ extension system is called directly, a Python class without override is skipped
+	*/
+	bool pythonClass = false;
+	/**
+	* \brief Class name of the system, also the name of its Remotery samples
+	*/
+	std::string name;
+	rmtU32 sampleHash = 0;
+	PySystemProfile profile;
+};
 class PySystem : public System
 {
 public:
@@ -61,13 +130,83 @@ public:
 	InstanceId LoadCppExtensionSystem(std::string systemClassName);
 	PySystem* GetPySystemFromInstanceId(InstanceId instanceId);
 
-	PySystem* GetPySystemFromClassName(std::string className);
+	/**
+	* \brief The first loaded system of the class, from a hash map
+	*/
+	PySystem* GetPySystemFromClassName(const std::string& className);
+	/**
+	* \brief Instantiate again the PySystems of a reloaded module
+	* \return The replaced and the new PySystem of each instance, the replaced ones are already deleted
+	*/
+	std::vector<std::pair<PySystem*, PySystem*>> ReloadPySystems(ModuleId moduleId);
 	std::vector<PySystem*>& GetPySystems();
+	/**
+	* \brief A C++ extension system has every hook, a Python one only the hooks its class overrides
+	*/
+	bool HasHook(const PySystem* pySystem, PySystemHook hook) const;
+	/**
+	* \brief Loaded systems with the hook, in loading order
+	*/
+	const std::vector<PySystem*>& GetHookSystems(PySystemHook hook) const;
+	/**
+	* \brief Call one phase of the given systems with the cached hooks, the GIL is taken once for the whole batch
+	*/
+	void InitSystems(const std::vector<PySystem*>& pySystems);
+	void UpdateSystems(const std::vector<PySystem*>& pySystems, float dt);
+	void FixedUpdateSystems(const std::vector<PySystem*>& pySystems);
+	void DrawSystems(const std::vector<PySystem*>& pySystems);
+	/**
+	* \brief Send the contact to every loaded system
+	*/
+	void ContactSystems(ColliderData* c1, ColliderData* c2, bool enter);
+	/**
+	* \brief Hooks and timings of the loaded systems
+	*/
+	std::vector<const PySystemHooks*> GetProfiledSystems() const;
+	/**
+	* \brief Record the time spent in each Python function called by the hooks with sys.setprofile, slow while enabled
+	*/
+	void SetPythonProfiling(bool pythonProfiling);
+	bool IsPythonProfiling() const;
+	/**
+	* \brief The slowest Python functions since the profiling was reset, slowest first
+	*/
+	std::vector<PyHotspot> GetPythonHotspots(size_t count);
+	void ResetPythonHotspots();
 protected:
-	std::vector<PySystem*> m_PySystems{ INIT_ENTITY_NMB * MULTIPLE_COMPONENTS_MULTIPLIER };
-	std::vector<std::string> m_PySystemNames {INIT_ENTITY_NMB * MULTIPLE_COMPONENTS_MULTIPLIER};
-	std::vector<py::object> m_PythonInstances{ INIT_ENTITY_NMB * MULTIPLE_COMPONENTS_MULTIPLIER };
-	InstanceId m_IncrementalInstanceId = 1U;
+	/**
+	* \brief Store a new instance and its hooks, the instance ids are the indices of the dense instance arrays
+	*/
+	InstanceId AddInstance(py::object instance, const std::string& className, ModuleId moduleId, bool pythonClass);
+	void AddHookSystem(PySystem* pySystem, const PySystemHooks& hooks);
+	void RemoveHookSystem(PySystem* pySystem);
+	void CacheHooks(InstanceId instanceId, bool pythonClass);
+	PySystemHooks* GetHooks(PySystem* pySystem);
+	template<typename TCall, typename ...TArgs>
+	void CallHook(const std::vector<PySystem*>& pySystems, PySystemHook hook, const char* phaseName, TCall cppCall, TArgs... args);
+
+	/**
+	* \brief Only the loaded systems, without empty slots
+	*/
+	std::vector<PySystem*> m_PySystems;
+	std::array<std::vector<PySystem*>, static_cast<size_t>(PySystemHook::LENGTH)> m_HookSystems;
+	std::unordered_map<std::string, PySystem*> m_PySystemsByName;
+	/**
+	* \brief Indexed by InstanceId, the first element stands for INVALID_INSTANCE
+	*/
+	std::vector<std::string> m_PySystemNames{ 1 };
+	std::vector<py::object> m_PythonInstances{ 1 };
+	std::vector<ModuleId> m_InstanceModuleIds{ 0U };
+	/**
+	* \brief A deque keeps the hooks in place while a hook loads new systems
+	*/
+	std::deque<PySystemHooks> m_InstanceHooks{ 1 };
+	std::unordered_map<const PySystem*, InstanceId> m_InstanceIds;
+	/**
+	* \brief Python profile function given to sys.setprofile around the hooks, none when the profiling is off
+	*/
+	py::object m_PythonProfiler;
+	bool m_PythonProfiling = false;
 
 	PythonEngine* m_PythonEngine = nullptr;
 };
@@ -76,6 +76,11 @@ public:
 	void OnBeforeSceneLoad() override;
 
 	ModuleId LoadPyModule(std::string moduleFilename);
+	/**
+	* \brief Import again a script changed on the disk and swap the instances of its PySystem
+	* \return false if the file is not a loaded module
+	*/
+	bool ReloadPyModule(const std::string& moduleFilename);
 
 
 	PySystemManager& GetPySystemManager(){ return m_PySystemManager; }
@@ -95,6 +100,10 @@ private:
 	 * \brief Load all the python scripts at initialization or reset
 	 */
 	void LoadScripts(std::string dirname = "scripts/");
+	/**
+	 * \brief Folder of the marshaled script code from the Configuration, empty without cache
+	 */
+	std::string GetScriptCacheDirname() const;
 
 
 	std::vector<std::string> m_PythonModulePaths{ INIT_ENTITY_NMB * MULTIPLE_COMPONENTS_MULTIPLIER };
@@ -32,6 +32,10 @@ namespace fs = std::experimental::filesystem;
 #endif
 #include <string>
 #include <fstream>
+#include <vector>
+#include <set>
+#include <unordered_map>
+#include <chrono>
 
 namespace sfge
 {	
@@ -45,14 +49,83 @@ bool IsDirectory(std::string& filename);
 void IterateDirectory(std::string& dirname, std::function<void(std::string)>);
 
 std::ifstream::pos_type CalculateFileSize(const std::string& filename);
+/**
+* \brief Last write time of the file as an opaque stamp, only meant to be compared with a previous stamp of the same file
+*/
+long long GetFileModificationTime(const std::string& filename);
 
 bool CreateDirectory(const std::string& dirname);
 
 bool RemoveDirectory(const std::string& dirname, bool removeAll=true);
+/**
+* \brief Remove the least recently written files of the folder, not its subfolders, until they take at most maxSize bytes
+* \return The number of removed files
+*/
+size_t PruneDirectory(const std::string& dirname, size_t maxSize);
 
 const std::string LoadFile(std::string path);
 
 std::string GetFilenameExtension(std::string path);
+
+/**
+* \brief Read only memory mapping of a whole file, the content is paged in by the OS when read
+*/
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool Open(const std::string& path);
+	void Close();
+
+	const char* GetData() const;
+	size_t GetSize() const;
+private:
+	const char* m_Data = nullptr;
+	size_t m_Size = 0;
+#ifdef WIN32
+	void* m_FileHandle = nullptr;
+	void* m_MappingHandle = nullptr;
+#else
+	int m_FileDescriptor = -1;
+#endif
+};
+
+/**
+* \brief Watch folders and their subfolders for written files, inotify on Linux and a periodic scan of the modification times elsewhere
+*/
+class FileWatcher
+{
+public:
+	FileWatcher() = default;
+	~FileWatcher();
+	FileWatcher(const FileWatcher&) = delete;
+	FileWatcher& operator=(const FileWatcher&) = delete;
+
+	bool Watch(const std::string& dirname);
+	void Stop();
+	/**
+	* \brief Never blocks, the changes since the last poll are batched and each file is returned once
+	* \return The paths of the written files, starting with the watched folder name
+	*/
+	std::vector<std::string> Poll();
+private:
+#ifdef __linux__
+	void AddWatch(const std::string& dirname);
+
+	int m_InotifyDescriptor = -1;
+	std::unordered_map<int, std::string> m_WatchedDirnames;
+#else
+	void ScanDirectory(std::string dirname, std::set<std::string>& changedFiles);
+
+	std::vector<std::string> m_WatchedDirnames;
+	std::unordered_map<std::string, long long> m_ModificationTimes;
+	std::chrono::steady_clock::time_point m_LastScanTime;
+#endif
+};
 }
 
 #endif
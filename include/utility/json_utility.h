@@ -25,6 +25,7 @@
 #define SFGE_JSON_UTILITY_H
 
 #include <string>
+#include <string_view>
 #include <memory>
  //Externals includes
 #include <json.hpp>
@@ -43,22 +44,30 @@ bool IsJsonValueNumeric(const json::value_type& jsonValue);
 /**
 * \brief Function that checks if the given parameter exists in the json
 */
-bool CheckJsonExists(const json& jsonObject, std::string parameterName);
+bool CheckJsonExists(const json& jsonObject, std::string_view parameterName);
 /**
 * \brief Function that checks if the parameter exists and is of expected type
 */
-bool CheckJsonParameter(const json& jsonObject, std::string parameterName, json::value_t expectedType);
+bool CheckJsonParameter(const json& jsonObject, std::string_view parameterName, json::value_t expectedType);
 /**
 * \brief Function that checks if the parameters exists and is a number
 */
-bool CheckJsonNumber(const json& jsonObject, std::string parameterName);
+bool CheckJsonNumber(const json& jsonObject, std::string_view parameterName);
 /**
 * \brief Function that gets the Vector from an array or an object in the json
 */
-sf::Vector2f GetVectorFromJson(const json& jsonObject, std::string parameterName);
+sf::Vector2f GetVectorFromJson(const json& jsonObject, std::string_view parameterName);
+/**
+* \brief Function that writes the Vector as an array read back by GetVectorFromJson
+*/
+json GetJsonFromVector(sf::Vector2f vector);
 /**
 * \brief Function that loads a json file and returns a json object
 */
 std::unique_ptr<json> LoadJson(std::string jsonPath);
+/**
+* \brief Function that parses a json file through a parser callback, the values the callback consumes and discards are never kept in the returned json
+*/
+std::unique_ptr<json> LoadJson(const std::string& jsonPath, const json::parser_callback_t& callback);
 }
 #endif
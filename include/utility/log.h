@@ -27,6 +27,7 @@
 
 #include <iostream>
 #include <string>
+#include <mutex>
 
 #include <utility/singleton.h>
 
@@ -48,6 +49,11 @@ public:
 	* \param errorText The message to be written in cerr
 	*/
 	void Error(const std::string& errorText);
+private:
+	/**
+	* \brief The scene loading and the texture decoding also log from the thread pool
+	*/
+	std::mutex m_Mutex;
 };
 }
 #endif // SFGE_LOG_H
@@ -0,0 +1,139 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef SFGE_PACK_FILE_H
+#define SFGE_PACK_FILE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <utility/file_utility.h>
+
+namespace sfge
+{
+
+const std::uint32_t PACK_MAGIC = 0x4B504653U;
+const std::uint32_t PACK_VERSION = 1U;
+
+enum class PackCompression : std::uint32_t
+{
+	NONE = 0,
+	LZ4
+};
+
+/**
+* \brief Start of a .pack file, followed by the file blobs and the entry index
+*/
+struct PackHeader
+{
+	std::uint32_t magic = PACK_MAGIC;
+	std::uint32_t version = PACK_VERSION;
+	std::uint32_t entryCount = 0;
+	std::uint32_t padding = 0;
+	std::uint64_t indexOffset = 0;
+};
+
+/**
+* \brief One packed file, the index is sorted by path hash
+*/
+struct PackEntry
+{
+	std::uint64_t pathHash = 0;
+	/**
+	* \brief Hash of the uncompressed content, the same as AssetManager::HashFile on the original file
+	*/
+	std::uint64_t contentHash = 0;
+	std::uint64_t offset = 0;
+	std::uint64_t size = 0;
+	std::uint64_t rawSize = 0;
+	std::uint32_t compression = static_cast<std::uint32_t>(PackCompression::NONE);
+	std::uint32_t padding = 0;
+};
+
+/**
+* \brief Read only view of a mapped .pack, the uncompressed files are read in place without any copy
+*/
+class PackFile
+{
+public:
+	/**
+	* \return false if the file is missing, corrupted or from another version
+	*/
+	bool Open(const std::string& packPath);
+	void Close();
+	bool IsOpen() const;
+	size_t GetEntryCount() const;
+
+	const PackEntry* FindEntry(const std::string& path) const;
+	/**
+	* \brief Point data to the content of the entry, a compressed entry is first decompressed into buffer
+	*/
+	bool ReadEntry(const PackEntry& entry, const char*& data, size_t& size, std::vector<char>& buffer) const;
+
+	static std::uint64_t HashPath(const std::string& path);
+private:
+	MappedFile m_File;
+	const PackHeader* m_Header = nullptr;
+	const PackEntry* m_Entries = nullptr;
+};
+
+/**
+* \brief Gather files and write them in one .pack, used by the pack tool at build time
+*/
+class PackBuilder
+{
+public:
+	/**
+	* \param path The path the loaders will ask for, relative to the working directory of the engine
+	*/
+	void AddFile(const std::string& path);
+	/**
+	* \brief Add every file of the folder and its subfolders, except the excluded filenames
+	*/
+	void AddDirectory(std::string dirname, const std::set<std::string>& excludedFilenames = {});
+	/**
+	* \param compress Compress the files that get smaller with LZ4, ignored when the engine is built without LZ4
+	*/
+	bool Write(const std::string& packPath, bool compress) const;
+	size_t GetFileCount() const;
+private:
+	std::vector<std::string> m_Paths;
+};
+
+/**
+* \brief Map the pack read by the loaders instead of the loose files
+*/
+bool MountPack(const std::string& packPath);
+void UnmountPack();
+const PackFile* GetMountedPack();
+/**
+* \brief Read a file from the mounted pack, the data stays valid until the pack is unmounted or buffer is changed
+* \return false if no pack is mounted or the file is not packed, the loader then reads the disk
+*/
+bool ReadPackedFile(const std::string& path, const char*& data, size_t& size, std::vector<char>& buffer);
+
+}
+#endif
@@ -31,7 +31,12 @@ namespace py = pybind11;
 
 namespace sfge
 {
-py::object import(const std::string& module, const std::string& path, py::object& globals);
+/**
+* \brief Import the script as a module, with a cache folder its compiled code is marshaled
+* in a file keyed by the hash of its path and source, and reused while the source is unchanged.
+* Writing a new version removes the cached versions of the same script
+*/
+py::object import(const std::string& module, const std::string& path, py::object& globals, const std::string& cacheDirname = "");
 
 std::string module2class(const std::string& module_name);
 
@@ -29,8 +29,10 @@ class MouseRaycastSystem(System):
             print("Ray fraction: "+str(self.lengths[i]))
 
     def on_draw(self):
+        points = []
         for i in range(self.ray_nmb):
             direction = Vec2f(0.0, 1.0)
             direction = direction.rotate(self.angles[i])
-            graphics2d_manager.draw_line(self.mouse_pos, self.mouse_pos + direction * self.max_length * self.lengths[i],
-                                         Color.White)
+            points.append(self.mouse_pos)
+            points.append(self.mouse_pos + direction * self.max_length * self.lengths[i])
+        graphics2d_manager.debug_draw.draw_lines(points, Color.White, DebugDraw.Raycast)
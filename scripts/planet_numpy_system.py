@@ -0,0 +1,53 @@
+from SFGE import *
+
+try:
+    import numpy as np
+except ImportError:
+    np = None
+
+sprite_manager = graphics2d_manager.sprite_manager
+
+
+class PlanetNumpySystem(System):
+    """Same orbits as the C++ PlanetSystem, every planet is updated at once through the transform2d_manager.positions view"""
+    entity_nmb = None  # type: int
+    center_mass = 1000.0
+    planet_mass = 1.0
+    gravity_const = 1000.0
+
+    def init(self):
+        if np is None:
+            print("[Error] PlanetNumpySystem needs numpy")
+            return
+        self.entity_nmb = 10000
+        screen_size = engine.config.screen_size
+        self.center = np.array([screen_size.x / 2.0, screen_size.y / 2.0], dtype=np.float32)
+        self.dt = engine.config.fixed_delta_time
+        entity_manager.resize(self.entity_nmb)
+
+        for i in range(self.entity_nmb):
+            new_entity = entity_manager.create_entity(i + 1)
+            transform2d_manager.add_component(new_entity)
+            sprite_manager.create_component(new_entity, "data/sprites/round.png")
+
+        # The views are taken after the resize, a resize moves the component arrays
+        positions = transform2d_manager.positions[:self.entity_nmb]
+        positions[:, 0] = np.random.randint(0, int(screen_size.x), self.entity_nmb)
+        positions[:, 1] = np.random.randint(0, int(screen_size.y), self.entity_nmb)
+
+        delta_to_center = self.center - positions
+        r = np.maximum(np.linalg.norm(delta_to_center, axis=1), 1.0)
+        # perpendicular direction, a = v^2 / r <=> v = sqrt(a * r)
+        vel_dir = np.stack((-delta_to_center[:, 1], delta_to_center[:, 0]), axis=1) / r[:, None]
+        speed = np.sqrt(self.gravity_const * self.center_mass / r)
+        self.velocities = (vel_dir * speed[:, None]).astype(np.float32)
+
+    def fixed_update(self):
+        if np is None:
+            return
+        positions = transform2d_manager.positions[:self.entity_nmb]
+        delta_to_center = self.center - positions
+        r = np.maximum(np.linalg.norm(delta_to_center, axis=1), 1.0)
+        force = self.gravity_const * self.center_mass * self.planet_mass / (r * r)
+        self.velocities += delta_to_center / r[:, None] * (force / self.planet_mass * self.dt)[:, None]
+        positions += self.velocities * self.dt
@@ -0,0 +1,952 @@
+"""
+MIT License
+
+Copyright (c) 2018 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+"""
+
+# Translate an annotated Python System subclass of scripts/ to a C++ System registered like PlanetSystem.
+#
+# The members need a type hint (annotation or type comment) unless their first assignment gives it,
+# helper methods need annotated arguments. Only the SFGE bindings listed in the tables below are
+# translated, anything else stops the generation with the line of the script, the system then stays in Python.
+# Integer // and % keep the Python rounding, and a list.index without the item logs and skips the rest of the method
+# like the ValueError of the PySystem hook.
+#
+# Usage: python3 scripts/tools/generate_native_system.py --output-dir build/native_systems scripts/contact_debug_system.py ...
+# The sources are only written in the output folder, CMake generates them in the build folder at configure time.
+# A scene uses the compiled system with {"systemClassName": "ContactDebugSystem"} instead of its script_path.
+
+import argparse
+import ast
+import os
+import re
+import sys
+from pathlib import Path
+
+from license_generator import get_license_str
+
+NATIVE_SYSTEMS_DIR = "native_systems"
+
+# Python hooks of System, with their C++ override
+HOOKS = {
+    "init": ("void OnEngineInit()", []),
+    "update": ("void OnUpdate(float dt)", ["dt"]),
+    "fixed_update": ("void OnFixedUpdate()", []),
+    "on_draw": ("void OnDraw()", []),
+    "on_contact": ("void OnContact(ColliderData* c1, ColliderData* c2, bool enter)", ["c1", "c2", "enter"]),
+}
+HOOK_ARG_TYPES = {"dt": "float", "c1": "ColliderData*", "c2": "ColliderData*", "enter": "bool"}
+
+TYPE_HINTS = {
+    "float": "float",
+    "int": "int",
+    "bool": "bool",
+    "str": "std::string",
+    "Vector2f": "Vec2f",
+    "Vec2f": "Vec2f",
+    "p2Vec2": "p2Vec2",
+    "Color": "sf::Color",
+    "Transform2d": "Transform2d*",
+    "Body2d": "Body2d*",
+    "Shape": "Shape*",
+    "Sprite": "Sprite*",
+    "Animation2d": "Animation2d*",
+    "ColliderData": "ColliderData*",
+}
+
+# Module attributes of SFGE set by the PythonEngine
+GLOBALS = {
+    "engine": ("m_Engine", "Engine&"),
+    "scene_manager": ("m_Engine.GetSceneManager()", "SceneManager*"),
+    "input_manager": ("m_Engine.GetInputManager()", "InputManager*"),
+    "physics2d_manager": ("m_Engine.GetPhysicsManager()", "Physics2dManager*"),
+    "transform2d_manager": ("m_Engine.GetTransform2dManager()", "Transform2dManager*"),
+    "entity_manager": ("m_Engine.GetEntityManager()", "EntityManager*"),
+    "graphics2d_manager": ("m_Engine.GetGraphics2dManager()", "Graphics2dManager*"),
+}
+
+# Readable attributes by C++ type, {0} is the object
+ATTRIBUTES = {
+    "Engine&": {"config": ("{0}.GetConfig()", "Configuration*")},
+    "Configuration*": {"screen_size": ("Vec2f({0}->screenResolution.x, {0}->screenResolution.y)", "Vec2f")},
+    "Physics2dManager*": {"body2d_manager": ("{0}->GetBodyManager()", "Body2dManager*")},
+    "Graphics2dManager*": {
+        "sprite_manager": ("{0}->GetSpriteManager()", "SpriteManager*"),
+        "texture_manager": ("{0}->GetTextureManager()", "TextureManager*"),
+        "shape_manager": ("{0}->GetShapeManager()", "ShapeManager*"),
+        "animation2d_manager": ("{0}->GetAnimation2dManager()", "Animation2dManager*"),
+    },
+    "Transform2d*": {
+        "position": ("{0}->Position", "Vec2f"),
+        "scale": ("{0}->Scale", "Vec2f"),
+        "euler_angle": ("{0}->EulerAngle", "float"),
+    },
+    "Body2d*": {
+        "velocity": ("{0}->GetLinearVelocity()", "p2Vec2"),
+        "mass": ("{0}->GetMass()", "float"),
+    },
+    "Animation2d*": {"speed": ("{0}->speed", "float"), "time": ("{0}->time", "float")},
+    "ColliderData*": {"entity": ("{0}->entity", "Entity")},
+    "Vec2f": {
+        "x": ("{0}.x", "float"),
+        "y": ("{0}.y", "float"),
+        "magnitude": ("{0}.GetMagnitude()", "float"),
+    },
+    "p2Vec2": {
+        "x": ("{0}.x", "float"),
+        "y": ("{0}.y", "float"),
+        "magnitude": ("{0}.GetMagnitude()", "float"),
+    },
+    "sf::Color": {"r": ("{0}.r", "int"), "g": ("{0}.g", "int"), "b": ("{0}.b", "int"), "a": ("{0}.a", "int")},
+}
+
+# Python properties with a setter instead of a C++ member, {0} is the object and {1} the value
+SETTERS = {
+    "Body2d*": {"velocity": "{0}->SetLinearVelocity({1})"},
+}
+
+COMPONENT_MANAGERS = {
+    "Transform2dManager*": "Transform2d*",
+    "Body2dManager*": "Body2d*",
+    "ShapeManager*": "Shape*",
+    "SpriteManager*": "Sprite*",
+    "Animation2dManager*": "Animation2d*",
+}
+
+# Methods by C++ type, {0} is the object and {1} the comma separated arguments
+METHODS = {
+    "EntityManager*": {
+        "get_entities_with_type": ("{0}->GetEntitiesWithType({1})", "std::vector<Entity>"),
+        "has_component": ("{0}->HasComponent({1})", "bool"),
+    },
+    "Body2d*": {"apply_force": ("{0}->ApplyForce({1})", "void")},
+    "Shape*": {"set_fill_color": ("{0}->SetFillColor({1})", "void")},
+    "Graphics2dManager*": {
+        "draw_line": ("{0}->DrawLine({1})", "void"),
+        "draw_vector": ("{0}->DrawVector({1})", "void"),
+    },
+    "Vec2f": {
+        "normalized": ("{0}.Normalized()", "Vec2f"),
+        "rotate": ("{0}.Rotate({1})", "Vec2f"),
+    },
+    "p2Vec2": {"normalized": ("{0}.Normalized()", "p2Vec2")},
+}
+for manager_type, component_type in COMPONENT_MANAGERS.items():
+    METHODS.setdefault(manager_type, {})["get_component"] = ("{0}->GetComponentPtr({1})", component_type)
+
+COMPONENT_TYPES = {
+    "Transform2d": "TRANSFORM2D",
+    "Sprite": "SPRITE2D",
+    "Shape": "SHAPE2D",
+    "Body": "BODY2D",
+    "Sound": "SOUND",
+    "PyComponent": "PYCOMPONENT",
+    "Animation2d": "ANIMATION2D",
+}
+
+COLORS = ["Black", "White", "Red", "Green", "Blue", "Yellow", "Magenta", "Cyan", "Transparent"]
+
+MATH_FUNCTIONS = {"sqrt": "std::sqrt", "cos": "std::cos", "sin": "std::sin", "tan": "std::tan",
+                  "atan2": "std::atan2", "floor": "std::floor", "ceil": "std::ceil", "fabs": "std::fabs"}
+
+# static methods of the vectors
+VECTOR_FUNCTIONS = {"dot": ("Dot", "float"), "angle_between": ("AngleBetween", "float"), "lerp": ("Lerp", None)}
+
+ENTITY_TYPE_HINTS = [("int", "Entity"), ("std::vector<int>", "std::vector<Entity>")]
+
+VECTOR_TYPES = ("Vec2f", "p2Vec2")
+NUMBER_TYPES = ("float", "int", "Entity")
+
+# Python rounds the integer division toward minus infinity and gives the modulo the sign of the divisor,
+# added to the generated source when used
+HELPER_FUNCTIONS = {
+    "FloorDiv": ["static int FloorDiv(int a, int b)", "{",
+                 "\tconst int quotient = a / b;",
+                 "\treturn (a % b != 0 && (a < 0) != (b < 0)) ? quotient - 1 : quotient;", "}"],
+    "FloorMod": ["static int FloorMod(int a, int b)", "{",
+                 "\tconst int remainder = a % b;",
+                 "\treturn (remainder != 0 && (remainder < 0) != (b < 0)) ? remainder + b : remainder;", "}"],
+    "FloorModf": ["static float FloorModf(float a, float b)", "{",
+                  "\tconst float remainder = std::fmod(a, b);",
+                  "\treturn (remainder != 0.0f && (remainder < 0.0f) != (b < 0.0f)) ? remainder + b : remainder;", "}"],
+}
+
+# Marker of the early return of a failed list.index, replaced once the return type of the method is known
+SKIP_RETURN = "return @skip@;"
+
+
+class GenerationError(Exception):
+    def __init__(self, node, message):
+        super().__init__("line {0}: {1}".format(getattr(node, "lineno", "?"), message))
+
+
+def camel_case(name: str):
+    parts = [part for part in name.split("_") if part]
+    return parts[0] + "".join(part[:1].upper() + part[1:] for part in parts[1:])
+
+
+def pascal_case(name: str):
+    return "".join(part[:1].upper() + part[1:] for part in name.split("_") if part)
+
+
+def snake_case(name: str):
+    return name[0].lower() + re.sub(r"([A-Z])", r"_\1", name[1:]).lower()
+
+
+def member_name(name: str):
+    return "m_" + pascal_case(name)
+
+
+def is_pointer(cpp_type: str):
+    return cpp_type is not None and cpp_type.endswith("*")
+
+
+def element_type(cpp_type: str):
+    if cpp_type is not None and cpp_type.startswith("std::vector<"):
+        return cpp_type[len("std::vector<"):-1]
+    return None
+
+
+def strip_parentheses(code: str):
+    if not (code.startswith("(") and code.endswith(")")):
+        return code
+    depth = 0
+    for i, c in enumerate(code):
+        depth += 1 if c == "(" else -1 if c == ")" else 0
+        if depth == 0 and i != len(code) - 1:
+            return code
+    return code[1:-1]
+
+
+def parse_type_hint(node, hint):
+    """Python type hint, as an ast node or a type comment, to the C++ type, None for a bare list"""
+    if hint is None:
+        return None
+    if isinstance(hint, str):
+        hint = ast.parse(hint, mode="eval").body
+    if isinstance(hint, ast.Name):
+        if hint.id in ("list", "List"):
+            return None
+        if hint.id in TYPE_HINTS:
+            return TYPE_HINTS[hint.id]
+    if isinstance(hint, ast.Subscript) and isinstance(hint.value, ast.Name) and hint.value.id in ("list", "List"):
+        element = hint.slice.value if isinstance(hint.slice, ast.Index) else hint.slice
+        element_cpp = parse_type_hint(node, element)
+        if element_cpp is None:
+            raise GenerationError(node, "unsupported list element type")
+        return "std::vector<{0}>".format(element_cpp)
+    raise GenerationError(node, "unsupported type hint: " + ast.dump(hint))
+
+
+class Member:
+    def __init__(self, name, cpp_type, default=None):
+        self.name = name
+        self.cpp_type = cpp_type
+        self.default = default
+
+
+class Method:
+    def __init__(self, node):
+        self.node = node
+        self.args = []
+        self.return_type = None
+        self.body = []
+
+
+class SystemTranslator:
+    def __init__(self, module: ast.Module, class_node: ast.ClassDef):
+        self.class_name = class_node.name
+        self.class_node = class_node
+        self.aliases = {}
+        self.members = {}
+        self.methods = {}
+        self.scopes = []
+        self.includes = set()
+        self.helpers = set()
+        # checks emitted before the statement being translated
+        self.pending_lines = []
+        self.lookup_count = 0
+        self.current_method = None
+        self.read_module_aliases(module)
+
+    def read_module_aliases(self, module: ast.Module):
+        """Module level aliases like body2d_manager = physics2d_manager.body2d_manager"""
+        for statement in module.body:
+            if isinstance(statement, ast.Assign) and len(statement.targets) == 1 \
+                    and isinstance(statement.targets[0], ast.Name):
+                try:
+                    self.aliases[statement.targets[0].id] = self.expression(statement.value)
+                except GenerationError:
+                    pass
+                self.pending_lines = []
+
+    # Names and types
+
+    def declare_local(self, name, cpp_type):
+        self.scopes[-1][name] = cpp_type
+
+    def find_local(self, name):
+        for scope in reversed(self.scopes):
+            if name in scope:
+                return scope[name]
+        return None
+
+    def is_declared(self, name):
+        return any(name in scope for scope in self.scopes)
+
+    # Expressions, each returns the C++ code and its type
+
+    def expression(self, node, expected_type=None):
+        if isinstance(node, ast.Constant):
+            return self.constant(node)
+        if isinstance(node, ast.Name):
+            return self.name(node)
+        if isinstance(node, ast.Attribute):
+            return self.attribute(node)
+        if isinstance(node, ast.Subscript):
+            value, value_type = self.expression(node.value)
+            index_node = node.slice.value if isinstance(node.slice, ast.Index) else node.slice
+            index, _ = self.expression(index_node)
+            item_type = element_type(value_type)
+            if item_type is None:
+                raise GenerationError(node, "only lists can be indexed")
+            return "{0}[{1}]".format(value, strip_parentheses(index)), item_type
+        if isinstance(node, ast.BinOp):
+            return self.binary_operation(node)
+        if isinstance(node, ast.UnaryOp):
+            operand, operand_type = self.expression(node.operand)
+            if isinstance(node.op, ast.Not):
+                return "!" + operand, "bool"
+            if isinstance(node.op, ast.USub):
+                if operand_type in VECTOR_TYPES:
+                    return "({0} * -1.0f)".format(operand), operand_type
+                return "-" + operand, operand_type
+            return operand, operand_type
+        if isinstance(node, ast.BoolOp):
+            operator = " && " if isinstance(node.op, ast.And) else " || "
+            return "(" + operator.join(self.expression(value)[0] for value in node.values) + ")", "bool"
+        if isinstance(node, ast.Compare):
+            return self.compare(node)
+        if isinstance(node, ast.IfExp):
+            test, _ = self.expression(node.test)
+            body, body_type = self.expression(node.body)
+            orelse, _ = self.expression(node.orelse)
+            return "({0} ? {1} : {2})".format(test, body, orelse), body_type
+        if isinstance(node, ast.Call):
+            return self.call(node)
+        if isinstance(node, ast.ListComp):
+            return self.list_comprehension(node)
+        if isinstance(node, (ast.List, ast.Tuple)):
+            items = [self.expression(item) for item in node.elts]
+            list_type = expected_type
+            if list_type is None and items:
+                list_type = "std::vector<{0}>".format(items[0][1])
+            if list_type is None:
+                raise GenerationError(node, "the type of an empty list needs a type hint")
+            return "{0}{{{1}}}".format(list_type, ", ".join(item[0] for item in items)), list_type
+        raise GenerationError(node, "unsupported expression: " + type(node).__name__)
+
+    def constant(self, node):
+        value = node.value
+        if isinstance(value, bool):
+            return ("true" if value else "false"), "bool"
+        if isinstance(value, int):
+            return str(value), "int"
+        if isinstance(value, float):
+            literal = repr(value)
+            if "." not in literal and "e" not in literal:
+                literal += ".0"
+            return literal + "f", "float"
+        if isinstance(value, str):
+            return "\"{0}\"".format(value.replace("\\", "\\\\").replace("\"", "\\\"")), "std::string"
+        raise GenerationError(node, "unsupported constant: " + repr(value))
+
+    def name(self, node):
+        local_type = self.find_local(node.id)
+        if local_type is not None or self.is_declared(node.id):
+            return camel_case(node.id), local_type
+        if node.id in GLOBALS:
+            return GLOBALS[node.id]
+        if node.id in self.aliases:
+            return self.aliases[node.id]
+        raise GenerationError(node, "unknown name: " + node.id)
+
+    def attribute(self, node):
+        owner = node.value
+        if isinstance(owner, ast.Name):
+            if owner.id == "self":
+                if node.attr not in self.members:
+                    raise GenerationError(node, "unknown member: self." + node.attr)
+                member = self.members[node.attr]
+                return member_name(member.name), member.cpp_type
+            if owner.id == "Color" and node.attr in COLORS:
+                self.includes.add("SFML/Graphics/Color.hpp")
+                return "sf::Color::" + node.attr, "sf::Color"
+            if owner.id == "System" and node.attr in COMPONENT_TYPES:
+                return "ComponentType::" + COMPONENT_TYPES[node.attr], "ComponentType"
+            if owner.id == "math" and node.attr == "pi":
+                return "3.14159265f", "float"
+        if isinstance(owner, ast.Attribute) and isinstance(owner.value, ast.Name) \
+                and owner.value.id == "System" and owner.attr == "ComponentType" and node.attr in COMPONENT_TYPES:
+            return "ComponentType::" + COMPONENT_TYPES[node.attr], "ComponentType"
+        value, value_type = self.expression(owner)
+        attributes = ATTRIBUTES.get(value_type, {})
+        if node.attr not in attributes:
+            raise GenerationError(node, "unsupported attribute {0} of {1}".format(node.attr, value_type))
+        code, cpp_type = attributes[node.attr]
+        return code.format(value), cpp_type
+
+    def binary_operation(self, node):
+        left, left_type = self.expression(node.left)
+        right, right_type = self.expression(node.right)
+        if isinstance(node.op, ast.Pow):
+            return "std::pow({0}, {1})".format(strip_parentheses(left), strip_parentheses(right)), "float"
+        operators = {ast.Add: "+", ast.Sub: "-", ast.Mult: "*", ast.Div: "/", ast.FloorDiv: "/", ast.Mod: "%"}
+        operator = operators.get(type(node.op))
+        if operator is None:
+            raise GenerationError(node, "unsupported operator: " + type(node.op).__name__)
+        if left_type in VECTOR_TYPES or right_type in VECTOR_TYPES:
+            if isinstance(node.op, (ast.FloorDiv, ast.Mod)):
+                raise GenerationError(node, "unsupported vector operator: " + type(node.op).__name__)
+            if left_type not in VECTOR_TYPES:
+                # the vectors only define vector * scalar, only the commutative operators can be swapped
+                if not isinstance(node.op, (ast.Add, ast.Mult)):
+                    raise GenerationError(node, "a scalar cannot be on the left of a vector " + operator)
+                left, right, left_type, right_type = right, left, right_type, left_type
+            if isinstance(node.op, (ast.Add, ast.Sub)) != (right_type in VECTOR_TYPES):
+                raise GenerationError(node, "unsupported operation {0} {1} {2}".format(left_type, operator, right_type))
+            return "({0} {1} {2})".format(left, operator, right), left_type
+        result_type = "float" if "float" in (left_type, right_type) else left_type
+        if isinstance(node.op, ast.Div) and result_type != "float":
+            return "(static_cast<float>({0}) / {1})".format(strip_parentheses(left), right), "float"
+        if isinstance(node.op, ast.FloorDiv) and result_type == "float":
+            self.includes.add("cmath")
+            return "std::floor({0} / {1})".format(left, right), "float"
+        if isinstance(node.op, ast.Mod) and result_type == "float":
+            self.includes.add("cmath")
+            self.helpers.add("FloorModf")
+            return "FloorModf({0}, {1})".format(strip_parentheses(left), strip_parentheses(right)), "float"
+        if isinstance(node.op, (ast.FloorDiv, ast.Mod)) and result_type == "int":
+            helper = "FloorDiv" if isinstance(node.op, ast.FloorDiv) else "FloorMod"
+            self.helpers.add(helper)
+            return "{0}({1}, {2})".format(helper, strip_parentheses(left), strip_parentheses(right)), "int"
+        return "({0} {1} {2})".format(left, operator, right), result_type
+
+    def compare(self, node):
+        if len(node.ops) != 1:
+            raise GenerationError(node, "chained comparisons are not supported")
+        left, _ = self.expression(node.left)
+        right, right_type = self.expression(node.comparators[0])
+        op = node.ops[0]
+        if isinstance(op, (ast.In, ast.NotIn)):
+            if element_type(right_type) is None:
+                raise GenerationError(node, "'in' is only supported on lists")
+            self.includes.add("algorithm")
+            comparison = "==" if isinstance(op, ast.NotIn) else "!="
+            return "(std::find({1}.begin(), {1}.end(), {0}) {2} {1}.end())".format(
+                strip_parentheses(left), right, comparison), "bool"
+        operators = {ast.Eq: "==", ast.NotEq: "!=", ast.Lt: "<", ast.LtE: "<=", ast.Gt: ">", ast.GtE: ">="}
+        if type(op) not in operators:
+            raise GenerationError(node, "unsupported comparison: " + type(op).__name__)
+        return "({0} {1} {2})".format(left, operators[type(op)], right), "bool"
+
+    def arguments(self, node):
+        return [self.expression(arg) for arg in node.args]
+
+    def call(self, node):
+        if node.keywords:
+            raise GenerationError(node, "keyword arguments are not supported")
+        function = node.func
+        args = self.arguments(node)
+        arg_codes = ", ".join(strip_parentheses(arg[0]) for arg in args)
+        if isinstance(function, ast.Name):
+            return self.builtin_call(node, function.id, args, arg_codes)
+        if not isinstance(function, ast.Attribute):
+            raise GenerationError(node, "unsupported call")
+        owner = function.value
+        if isinstance(owner, ast.Name) and not self.is_declared(owner.id):
+            if owner.id == "self":
+                if function.attr not in self.methods:
+                    raise GenerationError(node, "unknown method: self." + function.attr)
+                method = self.methods[function.attr]
+                if method.return_type is None:
+                    raise GenerationError(node, "the return type of {0} is not known yet, annotate it".format(
+                        function.attr))
+                return "{0}({1})".format(pascal_case(function.attr), arg_codes), method.return_type
+            if owner.id == "math" and function.attr in MATH_FUNCTIONS:
+                self.includes.add("cmath")
+                return "{0}({1})".format(MATH_FUNCTIONS[function.attr], arg_codes), "float"
+            if owner.id == "random":
+                self.includes.add("cstdlib")
+                if function.attr == "random":
+                    return "(static_cast<float>(std::rand()) / RAND_MAX)", "float"
+                if function.attr == "randint" and len(args) == 2:
+                    return "({0} + std::rand() % ({1} - {0} + 1))".format(args[0][0], args[1][0]), "int"
+                if function.attr == "uniform" and len(args) == 2:
+                    return "({0} + static_cast<float>(std::rand()) / RAND_MAX * ({1} - {0}))".format(
+                        args[0][0], args[1][0]), "float"
+            if owner.id in ("Vec2f", "Vector2f", "p2Vec2") and function.attr in VECTOR_FUNCTIONS:
+                vector_type = "p2Vec2" if owner.id == "p2Vec2" else "Vec2f"
+                function_name, return_type = VECTOR_FUNCTIONS[function.attr]
+                return "{0}::{1}({2})".format(vector_type, function_name, arg_codes), return_type or vector_type
+            if owner.id == "Physics2dManager" and function.attr in ("pixel2meter", "meter2pixel") and len(args) == 1:
+                arg_type = args[0][1]
+                if arg_type in NUMBER_TYPES:
+                    return "{0}({1})".format(function.attr, arg_codes), "float"
+                return "{0}({1})".format(function.attr, arg_codes), \
+                    "p2Vec2" if function.attr == "pixel2meter" else "Vec2f"
+        value, value_type = self.expression(owner)
+        if element_type(value_type) is not None:
+            return self.list_method(node, function.attr, value, value_type, arg_codes)
+        methods = METHODS.get(value_type, {})
+        if function.attr not in methods:
+            raise GenerationError(node, "unsupported method {0} of {1}".format(function.attr, value_type))
+        code, return_type = methods[function.attr]
+        return code.format(value, arg_codes), return_type
+
+    def builtin_call(self, node, function_name, args, arg_codes):
+        if function_name in ("Vector2f", "Vec2f"):
+            return "Vec2f({0})".format(arg_codes), "Vec2f"
+        if function_name == "p2Vec2":
+            return "p2Vec2({0})".format(arg_codes), "p2Vec2"
+        if function_name == "len" and len(args) == 1:
+            return "static_cast<int>({0}.size())".format(args[0][0]), "int"
+        if function_name == "int" and len(args) == 1:
+            return "static_cast<int>({0})".format(arg_codes), "int"
+        if function_name == "float" and len(args) == 1:
+            return "static_cast<float>({0})".format(arg_codes), "float"
+        if function_name == "abs" and len(args) == 1:
+            self.includes.add("cmath")
+            return "std::abs({0})".format(arg_codes), args[0][1]
+        if function_name in ("min", "max") and len(args) == 2:
+            self.includes.add("algorithm")
+            cpp_type = "float" if "float" in (args[0][1], args[1][1]) else args[0][1]
+            return "std::{0}<{1}>({2})".format(function_name, cpp_type, arg_codes), cpp_type
+        raise GenerationError(node, "unsupported function: " + function_name)
+
+    def list_method(self, node, method_name, value, value_type, arg_codes):
+        if method_name == "append":
+            return "{0}.push_back({1})".format(value, arg_codes), "void"
+        if method_name == "clear":
+            return "{0}.clear()".format(value), "void"
+        if method_name == "index":
+            # Python raises a ValueError for a missing item, the rest of the method is skipped like the PySystem hook
+            if self.current_method is None:
+                raise GenerationError(node, "list.index is only supported in methods")
+            self.includes.add("algorithm")
+            self.includes.add("utility/log.h")
+            self.lookup_count += 1
+            index_name = "foundIndex{0}".format(self.lookup_count)
+            self.pending_lines += [
+                "const auto {0}It = std::find({1}.begin(), {1}.end(), {2});".format(index_name, value, arg_codes),
+                "if ({0}It == {1}.end())".format(index_name, value),
+                "{",
+                "\tLog::GetInstance()->Error(\"[Error] {0}.{1} line {2}: list.index did not find the item, "
+                "the rest of {1} is skipped\");".format(self.class_name, self.current_method.node.name, node.lineno),
+                "\t" + SKIP_RETURN,
+                "}",
+                "const int {0} = static_cast<int>({0}It - {1}.begin());".format(index_name, value)]
+            return index_name, "int"
+        raise GenerationError(node, "unsupported list method: " + method_name)
+
+    def list_comprehension(self, node):
+        """[value for i in range(count)] with a value independent of i, like self.contact_count"""
+        if len(node.generators) != 1:
+            raise GenerationError(node, "only one for in list comprehensions")
+        generator = node.generators[0]
+        iterator = generator.iter
+        if generator.ifs or not (isinstance(iterator, ast.Call) and isinstance(iterator.func, ast.Name)
+                                 and iterator.func.id == "range" and len(iterator.args) == 1):
+            raise GenerationError(node, "only [value for i in range(count)] comprehensions are supported")
+        target = generator.target.id if isinstance(generator.target, ast.Name) else None
+        if any(isinstance(child, ast.Name) and child.id == target for child in ast.walk(node.elt)):
+            raise GenerationError(node, "the value of the comprehension cannot depend on " + str(target))
+        count, _ = self.expression(iterator.args[0])
+        value, value_type = self.expression(node.elt)
+        list_type = "std::vector<{0}>".format(value_type)
+        return "{0}({1}, {2})".format(list_type, strip_parentheses(count), strip_parentheses(value)), list_type
+
+    # Statements
+
+    def block(self, statements, indent):
+        self.scopes.append({})
+        lines = []
+        for statement in statements:
+            outer_lines = self.pending_lines
+            self.pending_lines = []
+            statement_lines = self.statement(statement, indent)
+            lines += ["\t" * indent + line for line in self.pending_lines] + statement_lines
+            self.pending_lines = outer_lines
+        self.scopes.pop()
+        return lines
+
+    def statement(self, node, indent):
+        tab = "\t" * indent
+        if isinstance(node, ast.Expr):
+            if isinstance(node.value, ast.Constant) and isinstance(node.value.value, str):
+                return []  # docstring
+            code, _ = self.expression(node.value)
+            return [tab + strip_parentheses(code) + ";"]
+        if isinstance(node, ast.Pass):
+            return []
+        if isinstance(node, ast.Assign):
+            if len(node.targets) != 1:
+                raise GenerationError(node, "multiple assignment is not supported")
+            hint = parse_type_hint(node, getattr(node, "type_comment", None))
+            return [tab + line for line in self.assign(node, node.targets[0], node.value, hint)]
+        if isinstance(node, ast.AnnAssign):
+            if node.value is None:
+                raise GenerationError(node, "annotated local without value")
+            return [tab + line for line in self.assign(node, node.target, node.value,
+                                                       parse_type_hint(node, node.annotation))]
+        if isinstance(node, ast.AugAssign):
+            target, target_type = self.expression(node.target)
+            value, _ = self.expression(node.value)
+            operators = {ast.Add: "+=", ast.Sub: "-=", ast.Mult: "*=", ast.Div: "/="}
+            if type(node.op) not in operators:
+                raise GenerationError(node, "unsupported operator: " + type(node.op).__name__)
+            if target_type in VECTOR_TYPES and type(node.op) in (ast.Mult, ast.Div):
+                symbol = "*" if isinstance(node.op, ast.Mult) else "/"
+                return ["{0}{1} = {1} {2} {3};".format(tab, target, symbol, strip_parentheses(value))]
+            return ["{0}{1} {2} {3};".format(tab, target, operators[type(node.op)], strip_parentheses(value))]
+        if isinstance(node, ast.If):
+            return self.if_statement(node, indent)
+        if isinstance(node, ast.For):
+            return self.for_statement(node, indent)
+        if isinstance(node, ast.While):
+            test, _ = self.expression(node.test)
+            if self.pending_lines:
+                raise GenerationError(node, "list.index is not supported in a while condition, assign it first")
+            return [tab + "while ({0})".format(strip_parentheses(test)), tab + "{"] + \
+                self.block(node.body, indent + 1) + [tab + "}"]
+        if isinstance(node, ast.Return):
+            if node.value is None:
+                return [tab + "return;"]
+            value, value_type = self.expression(node.value)
+            if self.current_method.return_type is None:
+                self.current_method.return_type = value_type
+            return [tab + "return {0};".format(strip_parentheses(value))]
+        if isinstance(node, ast.Break):
+            return [tab + "break;"]
+        if isinstance(node, ast.Continue):
+            return [tab + "continue;"]
+        raise GenerationError(node, "unsupported statement: " + type(node).__name__)
+
+    def assign(self, node, target, value_node, hint):
+        if isinstance(target, ast.Attribute) and isinstance(target.value, ast.Name) and target.value.id == "self":
+            member = self.members.get(target.attr)
+            if member is None:
+                member = self.members[target.attr] = Member(target.attr, hint)
+            value, value_type = self.expression(value_node, member.cpp_type)
+            if (member.cpp_type, value_type) in ENTITY_TYPE_HINTS:
+                # entities hinted as int in Python
+                member.cpp_type = value_type
+            if member.cpp_type is None:
+                if value_type is None or value_type == "void":
+                    raise GenerationError(node, "the type of self.{0} is unknown, add a type hint".format(
+                        target.attr))
+                member.cpp_type = value_type
+            return ["{0} = {1};".format(member_name(member.name), strip_parentheses(value))]
+        if isinstance(target, ast.Attribute):
+            owner, owner_type = self.expression(target.value)
+            value, _ = self.expression(value_node)
+            setter = SETTERS.get(owner_type, {}).get(target.attr)
+            if setter is not None:
+                return [setter.format(owner, strip_parentheses(value)) + ";"]
+            code, _ = self.attribute(target)
+            return ["{0} = {1};".format(code, strip_parentheses(value))]
+        if isinstance(target, ast.Subscript):
+            code, code_type = self.expression(target)
+            value, _ = self.expression(value_node, code_type)
+            return ["{0} = {1};".format(code, strip_parentheses(value))]
+        if isinstance(target, ast.Name):
+            value, value_type = self.expression(value_node, hint)
+            value = strip_parentheses(value)
+            if self.is_declared(target.id):
+                return ["{0} = {1};".format(camel_case(target.id), value)]
+            cpp_type = hint if hint is not None else value_type
+            if cpp_type is None or cpp_type == "void":
+                raise GenerationError(node, "the type of {0} is unknown, add a type hint".format(target.id))
+            self.declare_local(target.id, cpp_type)
+            if hint is not None:
+                return ["{0} {1} = {2};".format(hint, camel_case(target.id), value)]
+            return ["auto {0} = {1};".format(camel_case(target.id), value)]
+        raise GenerationError(node, "unsupported assignment target")
+
+    def if_statement(self, node, indent):
+        tab = "\t" * indent
+        test, _ = self.expression(node.test)
+        lines = [tab + "if ({0})".format(strip_parentheses(test)), tab + "{"] + \
+            self.block(node.body, indent + 1) + [tab + "}"]
+        if len(node.orelse) == 1 and isinstance(node.orelse[0], ast.If):
+            checked_lines = len(self.pending_lines)
+            else_lines = self.if_statement(node.orelse[0], indent)
+            if len(self.pending_lines) != checked_lines:
+                raise GenerationError(node.orelse[0], "list.index is not supported in an elif condition, assign it first")
+            return lines + [tab + "else " + else_lines[0].lstrip("\t")] + else_lines[1:]
+        if node.orelse:
+            lines += [tab + "else", tab + "{"] + self.block(node.orelse, indent + 1) + [tab + "}"]
+        return lines
+
+    def for_statement(self, node, indent):
+        tab = "\t" * indent
+        if node.orelse or not isinstance(node.target, ast.Name):
+            raise GenerationError(node, "only for name in ... loops without else are supported")
+        name = camel_case(node.target.id)
+        iterator = node.iter
+        self.scopes.append({})
+        if isinstance(iterator, ast.Call) and isinstance(iterator.func, ast.Name) and iterator.func.id == "range":
+            bounds = [strip_parentheses(self.expression(arg)[0]) for arg in iterator.args]
+            if len(bounds) == 1:
+                bounds = ["0"] + bounds
+            if len(bounds) != 2:
+                raise GenerationError(node, "range with a step is not supported")
+            self.declare_local(node.target.id, "int")
+            header = "for (int {0} = {1}; {0} < {2}; {0}++)".format(name, bounds[0], bounds[1])
+        else:
+            values, values_type = self.expression(iterator)
+            item_type = element_type(values_type)
+            if item_type is None:
+                raise GenerationError(node, "only ranges and lists can be iterated")
+            self.declare_local(node.target.id, item_type)
+            header = "for (auto& {0} : {1})".format(name, values)
+        lines = [tab + header, tab + "{"] + self.block(node.body, indent + 1) + [tab + "}"]
+        self.scopes.pop()
+        return lines
+
+    # Class
+
+    def translate(self):
+        for statement in self.class_node.body:
+            if isinstance(statement, ast.AnnAssign) and isinstance(statement.target, ast.Name):
+                self.class_member(statement, statement.target.id, statement.annotation, statement.value)
+            elif isinstance(statement, ast.Assign) and len(statement.targets) == 1 \
+                    and isinstance(statement.targets[0], ast.Name):
+                self.class_member(statement, statement.targets[0].id,
+                                  getattr(statement, "type_comment", None), statement.value)
+            elif isinstance(statement, ast.FunctionDef):
+                self.methods[statement.name] = Method(statement)
+            elif not isinstance(statement, (ast.Expr, ast.Pass)):
+                raise GenerationError(statement, "unsupported class statement")
+        # the helpers first, their return type is then known in the hooks
+        helpers = [method for name, method in self.methods.items() if name not in HOOKS]
+        hooks = [method for name, method in self.methods.items() if name in HOOKS]
+        for method in helpers + hooks:
+            self.translate_method(method)
+
+    def class_member(self, node, name, hint, value_node):
+        cpp_type = parse_type_hint(node, hint)
+        default = None
+        if value_node is not None and not (isinstance(value_node, ast.Constant) and value_node.value is None):
+            self.scopes.append({})
+            default, value_type = self.expression(value_node, cpp_type)
+            self.scopes.pop()
+            cpp_type = cpp_type if cpp_type is not None else value_type
+        self.members[name] = Member(name, cpp_type, default)
+
+    def translate_method(self, method: Method):
+        node = method.node
+        self.current_method = method
+        self.scopes = [{}]
+        if node.name in HOOKS:
+            for arg in HOOKS[node.name][1]:
+                self.declare_local(arg, HOOK_ARG_TYPES[arg])
+        else:
+            for arg in node.args.args[1:]:
+                cpp_type = parse_type_hint(node, arg.annotation)
+                if cpp_type is None:
+                    raise GenerationError(node, "argument {0} of {1} needs a type hint".format(arg.arg, node.name))
+                self.declare_local(arg.arg, cpp_type)
+                method.args.append((arg.arg, cpp_type))
+            if node.returns is not None:
+                method.return_type = parse_type_hint(node, node.returns)
+        method.body = self.block(node.body, 1)
+        if node.name not in HOOKS and method.return_type is None:
+            method.return_type = "void"
+        skip_return = "return;" if node.name in HOOKS or method.return_type == "void" else "return {};"
+        method.body = [line.replace(SKIP_RETURN, skip_return) for line in method.body]
+        self.current_method = None
+
+    def signature(self, method: Method, qualified: bool):
+        prefix = self.class_name + "::" if qualified else ""
+        if method.node.name in HOOKS:
+            signature = HOOKS[method.node.name][0]
+            return_type, function = signature.split(" ", 1)
+            return "{0} {1}{2}{3}".format(return_type, prefix, function, "" if qualified else " override")
+        args = ", ".join("{0} {1}".format(cpp_type, camel_case(name)) for name, cpp_type in method.args)
+        return "{0} {1}{2}({3})".format(method.return_type, prefix, pascal_case(method.node.name), args)
+
+    def header(self):
+        guard = "SFGE_NATIVE_SYSTEMS_{0}_H".format(snake_case(self.class_name).upper())
+        lines = ["/*" + get_license_str() + "*/", "",
+                 "//Generated by scripts/tools/generate_native_system.py, edit the Python system instead", "",
+                 "#ifndef " + guard, "#define " + guard, "",
+                 "#include <string>", "#include <vector>", "",
+                 "#include <SFML/Graphics/Color.hpp>", "",
+                 "#include <engine/system.h>", "#include <engine/entity.h>", "#include <engine/vector.h>",
+                 "#include <p2vector.h>", "",
+                 "namespace sfge", "{", "struct Transform2d;", "struct ColliderData;", "struct Animation2d;",
+                 "class Body2d;", "class Shape;", "class Sprite;", "}", "",
+                 "namespace sfge::ext", "{", "",
+                 "class {0} : public System".format(self.class_name), "{", "public:",
+                 "\tusing System::System;", ""]
+        for method in self.methods.values():
+            if method.node.name in HOOKS:
+                lines.append("\t" + self.signature(method, False) + ";")
+        helpers = [method for method in self.methods.values() if method.node.name not in HOOKS]
+        if helpers or self.members:
+            lines += ["", "private:"]
+        for method in helpers:
+            lines.append("\t" + self.signature(method, False) + ";")
+        if self.members:
+            lines.append("")
+            for member in self.members.values():
+                if member.cpp_type is None:
+                    raise GenerationError(self.class_node, "the type of self.{0} is unknown, add a type hint".format(
+                        member.name))
+                default = member.default
+                if default is None:
+                    default = "nullptr" if is_pointer(member.cpp_type) else \
+                        "0" if member.cpp_type in ("int", "Entity") else \
+                        "0.0f" if member.cpp_type == "float" else \
+                        "false" if member.cpp_type == "bool" else ""
+                lines.append("\t{0} {1}{{{2}}};".format(member.cpp_type, member_name(member.name),
+                                                         strip_parentheses(default)))
+        lines += ["};", "", "}", "", "#endif", ""]
+        return "\n".join(line for line in lines if line is not None)
+
+    def source(self):
+        includes = ["engine/engine.h", "engine/config.h", "engine/transform2d.h", "graphics/graphics2d.h",
+                    "graphics/shape2d.h", "graphics/sprite2d.h", "graphics/animation2d.h",
+                    "physics/physics2d.h", "physics/body2d.h", "physics/collider2d.h"]
+        lines = ["/*" + get_license_str() + "*/", "",
+                 "//Generated by scripts/tools/generate_native_system.py, edit the Python system instead", ""]
+        lines += ["#include <{0}>".format(include) for include in sorted(self.includes)]
+        lines += ["", "#include <{0}/{1}.h>".format(NATIVE_SYSTEMS_DIR, snake_case(self.class_name))]
+        lines += ["#include <{0}>".format(include) for include in includes]
+        lines += ["", "namespace sfge::ext", "{"]
+        for helper in sorted(self.helpers):
+            lines += [""] + HELPER_FUNCTIONS[helper]
+        for method in self.methods.values():
+            lines += ["", self.signature(method, True), "{"]
+            if method.node.name in HOOKS:
+                lines.append("\trmt_ScopedCPUSample({0}{1}, 0);".format(self.class_name,
+                                                                         pascal_case(method.node.name)))
+                if method.node.name == "init":
+                    lines.append("\tSystem::OnEngineInit();")
+                lines += ["\t(void) {0};".format(arg) for arg in HOOKS[method.node.name][1]
+                          if not any(re.search(r"\b{0}\b".format(arg), line) for line in method.body)]
+            lines += method.body
+            lines.append("}")
+        lines += ["", "}", ""]
+        return "\n".join(lines)
+
+
+def generate_native_system(script_path: Path, include_dir: Path, src_dir: Path):
+    source = script_path.read_text()
+    try:
+        module = ast.parse(source, filename=str(script_path), type_comments=True)
+    except TypeError:
+        module = ast.parse(source, filename=str(script_path))
+    class_nodes = [node for node in module.body if isinstance(node, ast.ClassDef)
+                   and any(isinstance(base, ast.Name) and base.id == "System" for base in node.bases)]
+    if len(class_nodes) != 1:
+        raise GenerationError(module, "{0} needs exactly one System subclass".format(script_path))
+    translator = SystemTranslator(module, class_nodes[0])
+    translator.translate()
+    file_name = snake_case(translator.class_name)
+    (include_dir / (file_name + ".h")).write_text(translator.header())
+    (src_dir / (file_name + ".cpp")).write_text(translator.source())
+    return translator.class_name
+
+
+def generate_registration(registry_name: str, class_names: list, include_dir: Path, src_dir: Path):
+    """Register the generated systems in the SystemRegistry and expose them to Python, like PlanetSystem"""
+    function_suffix = pascal_case(registry_name)
+    (include_dir / (registry_name + ".h")).write_text("/*" + get_license_str() + "*/" + """
+
+//Generated by scripts/tools/generate_native_system.py
+
+#ifndef SFGE_{0}_H
+#define SFGE_{0}_H
+
+#include <utility/python_utility.h>
+
+namespace sfge
+{{
+class SystemRegistry;
+}}
+
+namespace sfge::ext
+{{
+void Register{1}(SystemRegistry& systemRegistry);
+void ExtendPython{1}(py::module& m);
+}}
+
+#endif
+""".format(registry_name.upper(), function_suffix))
+    lines = ["/*" + get_license_str() + "*/", "", "//Generated by scripts/tools/generate_native_system.py", "",
+             "#include <engine/engine.h>", "#include <engine/system_registry.h>", "",
+             "#include <{0}/{1}.h>".format(NATIVE_SYSTEMS_DIR, registry_name)]
+    lines += ["#include <{0}/{1}.h>".format(NATIVE_SYSTEMS_DIR, snake_case(name)) for name in class_names]
+    lines += ["", "namespace sfge::ext", "{", "",
+              "void Register{0}(SystemRegistry& systemRegistry)".format(function_suffix), "{"]
+    if not class_names:
+        lines.append("\t(void) systemRegistry;")
+    lines += ["\tsystemRegistry.RegisterSystem<{0}>(\"{0}\");".format(name) for name in class_names]
+    lines += ["}", "", "void ExtendPython{0}(py::module& m)".format(function_suffix), "{"]
+    if not class_names:
+        lines.append("\t(void) m;")
+    for name in class_names:
+        variable = camel_case(snake_case(name))
+        lines += ["\tpy::class_<{0}, System> {1}(m, \"{0}\");".format(name, variable),
+                  "\t{0}".format(variable), "\t\t.def(py::init<Engine&>());"]
+    lines += ["}", "", "}", ""]
+    (src_dir / (registry_name + ".cpp")).write_text("\n".join(lines))
+
+
+def generate_native_systems(script_paths: list, output_dir: Path, registry_name: str):
+    include_dir = output_dir / "include" / NATIVE_SYSTEMS_DIR
+    src_dir = output_dir / "src" / NATIVE_SYSTEMS_DIR
+    for directory in (include_dir, src_dir):
+        os.makedirs(directory, exist_ok=True)
+        for old_file in directory.iterdir():
+            old_file.unlink()
+    class_names = []
+    for script_path in script_paths:
+        try:
+            class_names.append(generate_native_system(Path(script_path), include_dir, src_dir))
+            print("Generate native system from: " + script_path)
+        except (GenerationError, SyntaxError, OSError) as e:
+            sys.stderr.write("[Error] Could not generate a native system from {0}, {1}\n".format(script_path, e))
+    generate_registration(registry_name, class_names, include_dir, src_dir)
+    return len(class_names) == len(script_paths)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Generate C++ systems from annotated Python systems")
+    parser.add_argument("--output-dir", required=True, type=Path,
+                        help="the sources are written in its include/native_systems and src/native_systems folders")
+    parser.add_argument("--registry", default="generated_systems",
+                        help="name of the registration files and of their Register and ExtendPython functions")
+    parser.add_argument("scripts", nargs="*")
+    args = parser.parse_args()
+    sys.exit(0 if generate_native_systems(args.scripts, args.output_dir, args.registry) else 1)
@@ -34,7 +34,9 @@ SOFTWARE.
 #include <utility/log.h>
 #include <engine/engine.h>
 #include <engine/config.h>
+#include <engine/asset.h>
 #include <utility/file_utility.h>
+#include <utility/pack_file.h>
 #include <utility/json_utility.h>
 
 
@@ -83,49 +85,71 @@ void SoundManager::CreateComponent(json & componentJson, Entity entity)
 
 	if (CheckJsonParameter(componentJson, "path", json::value_t::string))
 	{
-		const auto path = componentJson["path"].get<std::string>();
-		sf::SoundBuffer* soundBuffer = nullptr;
-		if (FileExists(path))
+		CreateComponent(componentJson["path"].get<std::string>(), entity);
+	}
+	else
+	{
+		Log::GetInstance()->Error("[Error] No Path for Sound");
+	}
+
+}
+
+void SoundManager::CreateComponent(const std::string& path, Entity entity)
+{
+	sf::SoundBuffer* soundBuffer = nullptr;
+	if (FileExists(path))
+	{
+		auto* sound = AddComponent(entity);
+		if(sound == nullptr)
 		{
-			auto* sound = AddComponent(entity);
-			if(sound == nullptr)
-			{
-				std::ostringstream oss;
-				oss << "All sound channels used";
-				Log::GetInstance()->Error(oss.str());
-				return;
-			}
-			sound->SetEntity(entity);
-			const int index = sound - &m_Components[0];
-			auto* soundInfo = &m_ComponentsInfo[index];
-			const SoundBufferId soundBufferId = m_SoundBufferManager->LoadSoundBuffer(path);
-			if (soundBufferId != INVALID_SOUND_BUFFER)
-			{
-				soundInfo->SetEntity(entity);
-				soundInfo->path = path;
-				soundBuffer = m_SoundBufferManager->GetSoundBuffer(soundBufferId);
-				sound->SetBuffer(soundBuffer);
-				soundInfo->SoundBufferId = soundBufferId;
-			}
-			else
-			{
-				std::ostringstream oss;
-				oss << "Sound file " << path << " cannot be loaded";
-				Log::GetInstance()->Error(oss.str());
-			}
+			std::ostringstream oss;
+			oss << "All sound channels used";
+			Log::GetInstance()->Error(oss.str());
+			return;
+		}
+		sound->SetEntity(entity);
+		const int index = sound - &m_Components[0];
+		auto* soundInfo = &m_ComponentsInfo[index];
+		const SoundBufferId soundBufferId = m_SoundBufferManager->LoadSoundBuffer(path);
+		if (soundBufferId != INVALID_SOUND_BUFFER)
+		{
+			soundInfo->SetEntity(entity);
+			soundInfo->path = path;
+			soundBuffer = m_SoundBufferManager->GetSoundBuffer(soundBufferId);
+			sound->SetBuffer(soundBuffer);
+			soundInfo->SoundBufferId = soundBufferId;
 		}
 		else
 		{
 			std::ostringstream oss;
-			oss << "Sound file " << path << " does not exist";
+			oss << "Sound file " << path << " cannot be loaded";
 			Log::GetInstance()->Error(oss.str());
 		}
 	}
 	else
 	{
-		Log::GetInstance()->Error("[Error] No Path for Sound");
+		std::ostringstream oss;
+		oss << "Sound file " << path << " does not exist";
+		Log::GetInstance()->Error(oss.str());
 	}
+}
 
+void SoundManager::SerializeComponents(Entity entity, json& componentsJson)
+{
+	ForEachComponentOf(entity, [this, &componentsJson](size_t i)
+	{
+		if (m_ComponentsInfo[i].path.empty())
+			return;
+		json componentJson;
+		componentJson["type"] = static_cast<int>(ComponentType::SOUND);
+		componentJson["path"] = m_ComponentsInfo[i].path;
+		componentsJson.push_back(componentJson);
+	});
+}
+
+Entity SoundManager::GetComponentEntity(size_t index)
+{
+	return m_Components[index].GetEntity();
 }
 
 void SoundManager::DestroyComponent(Entity entity)
@@ -278,8 +302,9 @@ void SoundBufferManager::OnAfterSceneLoad()
 	}
 	for (auto unusedTextureId : unusedBufferIds)
 	{
-		m_SoundBuffers[unusedTextureId] = nullptr;
+		m_SoundBuffers[unusedTextureId - 1] = nullptr;
 	}
+	m_PreloadedSoundBuffers.clear();
 }
 
 SoundBufferId SoundBufferManager::LoadSoundBuffer(std::string filename)
@@ -299,21 +324,22 @@ SoundBufferId SoundBufferManager::LoadSoundBuffer(std::string filename)
 		return INVALID_SOUND_BUFFER;
 	}
 
-
-
-	auto soundBufferId = INVALID_SOUND_ID;
-	for (SoundBufferId checkedId = 1U; checkedId <= m_IncrementId; checkedId++)
+	const AssetId assetId = m_Engine.GetAssetManager()->LoadAsset(filename, AssetType::SOUND);
+	if (assetId == INVALID_ASSET)
 	{
-		if (filename == m_SoundBufferPaths[checkedId])
-		{
-			soundBufferId = checkedId;
-		}
+		return INVALID_SOUND_BUFFER;
+	}
+	auto soundBufferId = INVALID_SOUND_BUFFER;
+	const auto soundBufferIt = m_AssetSoundBufferIds.find(assetId);
+	if (soundBufferIt != m_AssetSoundBufferIds.end())
+	{
+		soundBufferId = soundBufferIt->second;
 	}
 	//Was or still is loaded
 	if (soundBufferId != INVALID_SOUND_BUFFER)
 	{
 
-		//Check if the texture was destroyed
+		//Check if the sound buffer was destroyed
 		if (m_SoundBuffers[soundBufferId - 1] != nullptr)
 		{
 			m_SoundBufferCountRefs[soundBufferId - 1]++;
@@ -321,48 +347,103 @@ SoundBufferId SoundBufferManager::LoadSoundBuffer(std::string filename)
 		}
 		else
 		{
-			auto soundBuffer = std::make_unique<sf::SoundBuffer>();
-			if (!soundBuffer->loadFromFile(filename))
+			auto soundBuffer = LoadSoundBufferFile(filename);
+			if (soundBuffer == nullptr)
 			{
-				std::ostringstream oss;
-				oss << "[ERROR] Could not load sound buffer file: " << filename;
-				Log::GetInstance()->Error(oss.str());
 				return INVALID_SOUND_BUFFER;
 			}
 			m_SoundBufferCountRefs[soundBufferId - 1] = 1U;
 			m_SoundBuffers[soundBufferId - 1] = std::move(soundBuffer);
-			return m_IncrementId;
+			return soundBufferId;
 		}
 	}
-	else
+	//SoundBuffer was never loaded
+	if (m_IncrementId >= m_SoundBuffers.size())
 	{
-		//SoundBuffer was never loaded
-		if (FileExists(filename))
-		{
+		std::ostringstream oss;
+		oss << "[ERROR] Sound buffer cache is full, cannot load: " << filename;
+		Log::GetInstance()->Error(oss.str());
+		return INVALID_SOUND_BUFFER;
+	}
+	auto soundBuffer = LoadSoundBufferFile(filename);
+	if (soundBuffer == nullptr)
+	{
+		return INVALID_SOUND_BUFFER;
+	}
 
-			auto soundBuffer = std::make_unique<sf::SoundBuffer>();
-			if (!soundBuffer->loadFromFile(filename))
-			{
-				std::ostringstream oss;
-				oss << "[ERROR] Could not load sound file: " << filename;
-				Log::GetInstance()->Error(oss.str());
-				return INVALID_SOUND_ID;
-			}
+	m_IncrementId++;
+	m_SoundBufferPaths[m_IncrementId - 1] = filename;
+	m_SoundBufferCountRefs[m_IncrementId - 1] = 1U;
+	m_SoundBuffers[m_IncrementId - 1] = std::move(soundBuffer);
+	m_AssetSoundBufferIds[assetId] = m_IncrementId;
+	return m_IncrementId;
+}
+
+std::unique_ptr<sf::SoundBuffer> SoundBufferManager::LoadSoundBufferFile(const std::string& filename)
+{
+	const auto preloadedIt = m_PreloadedSoundBuffers.find(filename);
+	if (preloadedIt != m_PreloadedSoundBuffers.end())
+	{
+		auto soundBuffer = std::move(preloadedIt->second);
+		m_PreloadedSoundBuffers.erase(preloadedIt);
+		return soundBuffer;
+	}
+	auto soundBuffer = std::make_unique<sf::SoundBuffer>();
+	const char* packedData = nullptr;
+	size_t packedSize = 0;
+	std::vector<char> packedBuffer;
+	const bool loaded = ReadPackedFile(filename, packedData, packedSize, packedBuffer) ?
+		soundBuffer->loadFromMemory(packedData, packedSize) : soundBuffer->loadFromFile(filename);
+	if (!loaded)
+	{
+		std::ostringstream oss;
+		oss << "[ERROR] Could not load sound file: " << filename;
+		Log::GetInstance()->Error(oss.str());
+		return nullptr;
+	}
+	return soundBuffer;
+}
 
-			m_IncrementId++;
-			m_SoundBufferPaths[m_IncrementId - 1] = filename;
-			m_SoundBufferCountRefs[m_IncrementId - 1] = 1U;
-			m_SoundBuffers[m_IncrementId - 1] = std::move(soundBuffer);
-			return m_IncrementId;
+void SoundBufferManager::AddPreloadedSoundBuffer(const std::string& filename, std::unique_ptr<sf::SoundBuffer> soundBuffer)
+{
+	const AssetId assetId = m_Engine.GetAssetManager()->FindAsset(filename);
+	const auto soundBufferIt = m_AssetSoundBufferIds.find(assetId);
+	//Already loaded by the current scene, its reference count is enough to keep it
+	if (soundBufferIt != m_AssetSoundBufferIds.end() && m_SoundBuffers[soundBufferIt->second - 1] != nullptr)
+	{
+		return;
+	}
+	m_PreloadedSoundBuffers[filename] = std::move(soundBuffer);
+}
+
+bool SoundBufferManager::ReloadSoundBuffer(const std::string& filename)
+{
+	auto* assetManager = m_Engine.GetAssetManager();
+	const AssetId previousAssetId = assetManager->FindAsset(filename);
+	const auto soundBufferIt = m_AssetSoundBufferIds.find(previousAssetId);
+	if (previousAssetId == INVALID_ASSET || soundBufferIt == m_AssetSoundBufferIds.end())
+		return false;
+	const SoundBufferId soundBufferId = soundBufferIt->second;
+	const AssetId assetId = assetManager->ReloadAsset(filename, AssetType::SOUND);
+	if (assetId != previousAssetId || m_SoundBufferPaths[soundBufferId - 1] != filename)
+		return true;
+	auto& soundBuffer = m_SoundBuffers[soundBufferId - 1];
+	if (soundBuffer != nullptr)
+	{
+		{
+			std::ostringstream oss;
+			oss << "Reloading sound buffer: " << filename;
+			Log::GetInstance()->Msg(oss.str());
 		}
-		else
+		//SFML detaches and attaches again the playing sounds
+		if (!soundBuffer->loadFromFile(filename))
 		{
 			std::ostringstream oss;
-			oss << "[ERROR] Could not load sound file: " << filename;
+			oss << "[ERROR] Could not reload sound buffer: " << filename;
 			Log::GetInstance()->Error(oss.str());
 		}
 	}
-	return INVALID_SOUND_BUFFER;
+	return true;
 }
 
 sf::SoundBuffer* SoundBufferManager::GetSoundBuffer(SoundBufferId soundBufferId)
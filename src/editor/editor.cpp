@@ -106,6 +106,16 @@ void Editor::OnUpdate(float dt)
 					}
                 }
 			}
+			auto& nativeSystems = m_Engine.GetSceneManager()->GetSceneNativeSystems();
+			for (size_t i = 0; i < nativeSystems.size(); i++)
+			{
+				//The native systems are listed after the PySystems
+				const int systemIndex = static_cast<int>(systems.size() + i);
+				if (ImGui::Selectable(nativeSystems[i].systemClassName.c_str(), selectedPySystem == systemIndex))
+				{
+					selectedPySystem = systemIndex;
+				}
+			}
 
 			ImGui::Separator();
 			ImGui::Text("Entities");
@@ -129,9 +139,17 @@ void Editor::OnUpdate(float dt)
 			ImGui::Begin("Inspector");
 
 			ImGui::Separator();
-			if(selectedPySystem != -1)
+			if (selectedPySystem != -1)
 			{
-				systems[selectedPySystem]->OnEditorDraw();
+				const auto systemIndex = static_cast<size_t>(selectedPySystem);
+				if (systemIndex < systems.size())
+				{
+					systems[systemIndex]->OnEditorDraw();
+				}
+				else if (systemIndex - systems.size() < nativeSystems.size())
+				{
+					nativeSystems[systemIndex - systems.size()].system->OnEditorDraw();
+				}
 			}
 			ImGui::Separator();
 
@@ -174,7 +192,13 @@ void Editor::OnDraw()
 {
 	if (m_Enable)
 	{
-		if (m_Window)
+		if (auto* commandList = m_GraphicsManager->GetRenderCommandList())
+		{
+			//The draw lists are copied, the render thread replays them with the frame
+			ImGui::Render();
+			commandList->SetImGuiDrawData(ImGui::GetDrawData());
+		}
+		else if (m_Window)
 		{
 			ImGui::SFML::Render(*m_Window);
 		}
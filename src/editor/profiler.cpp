@@ -22,13 +22,18 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#include <algorithm>
+#include <sstream>
+
 #include <editor/profiler.h>
 #include <engine/engine.h>
+#include <python/python_engine.h>
+#include <python/pysystem.h>
 #include <imgui.h>
 
 namespace sfge::editor
 {
-ProfilerEditorWindow::ProfilerEditorWindow(Engine& engine): m_ProfilerFrameData(engine.GetProfilerFrameData ())
+ProfilerEditorWindow::ProfilerEditorWindow(Engine& engine): m_Engine(engine), m_ProfilerFrameData(engine.GetProfilerFrameData ())
 {
 
 }
@@ -43,7 +48,114 @@ void ProfilerEditorWindow::Update ()
 
     ImGui::Text("%s", oss.str().c_str());
   }
+  if (m_PySystemManager == nullptr && m_Engine.GetPythonEngine () != nullptr)
+  {
+    m_PySystemManager = &m_Engine.GetPythonEngine ()->GetPySystemManager ();
+  }
+  if (m_PySystemManager != nullptr)
+  {
+    UpdateSystemsTable ();
+    UpdatePythonHotspots ();
+  }
 
   ImGui::End();
 }
+
+void ProfilerEditorWindow::UpdateSystemsTable ()
+{
+  if (!ImGui::CollapsingHeader ("Systems", ImGuiTreeNodeFlags_DefaultOpen))
+    return;
+  const PySystemHook columnHooks[] = {PySystemHook::UPDATE, PySystemHook::FIXED_UPDATE, PySystemHook::DRAW};
+  const char* columnNames[] = {"System", "Update (ms)", "Fixed (ms)", "Draw (ms)", "Max (ms)"};
+  const int columnNmb = 5;
+
+  auto systems = m_PySystemManager->GetProfiledSystems ();
+  const auto sortValue = [this, &columnHooks](const PySystemHooks* hooks)
+  {
+    if (m_SortColumn == columnNmb - 1)
+      return hooks->profile.maxTime;
+    return hooks->profile.GetAverageTime (columnHooks[m_SortColumn - 1]);
+  };
+  if (m_SortColumn == 0)
+  {
+    std::sort (systems.begin (), systems.end (), [](const PySystemHooks* h1, const PySystemHooks* h2)
+    { return h1->name < h2->name; });
+  }
+  else
+  {
+    std::sort (systems.begin (), systems.end (), [&sortValue](const PySystemHooks* h1, const PySystemHooks* h2)
+    { return sortValue (h1) > sortValue (h2); });
+  }
+
+  ImGui::Columns (columnNmb, "SystemsTable");
+  for (int column = 0; column < columnNmb; column++)
+  {
+    if (ImGui::Selectable (columnNames[column], m_SortColumn == column))
+    {
+      m_SortColumn = column;
+    }
+    ImGui::NextColumn ();
+  }
+  ImGui::Separator ();
+  const PySystemHooks* selectedHooks = nullptr;
+  for (size_t i = 0; i < systems.size (); i++)
+  {
+    const auto* hooks = systems[i];
+    ImGui::PushID (static_cast<int>(i));
+    const bool selected = hooks->name == m_SelectedSystem;
+    if (ImGui::Selectable (hooks->name.c_str (), selected, ImGuiSelectableFlags_SpanAllColumns))
+    {
+      m_SelectedSystem = selected ? "" : hooks->name;
+    }
+    if (hooks->name == m_SelectedSystem)
+    {
+      selectedHooks = hooks;
+    }
+    ImGui::NextColumn ();
+    for (auto hook : columnHooks)
+    {
+      ImGui::Text ("%.3f", hooks->profile.GetAverageTime (hook));
+      ImGui::NextColumn ();
+    }
+    ImGui::Text ("%.3f", hooks->profile.maxTime);
+    ImGui::NextColumn ();
+    ImGui::PopID ();
+  }
+  ImGui::Columns (1);
+
+  if (selectedHooks != nullptr)
+  {
+    const auto& profile = selectedHooks->profile;
+    for (int column = 1; column < columnNmb - 1; column++)
+    {
+      const auto hook = columnHooks[column - 1];
+      const auto hookIndex = static_cast<size_t>(hook);
+      const int sampleNmb = static_cast<int>(std::min (profile.sampleCounts[hookIndex], PySystemProfile::HISTORY_LENGTH));
+      if (sampleNmb == 0)
+        continue;
+      ImGui::PlotHistogram (columnNames[column], profile.history[hookIndex].data (), sampleNmb,
+          static_cast<int>(profile.GetHistoryOffset (hook)), nullptr, 0.0f, profile.maxTime, ImVec2 (0, 60));
+    }
+  }
+}
+
+void ProfilerEditorWindow::UpdatePythonHotspots ()
+{
+  if (!ImGui::CollapsingHeader ("Python functions"))
+    return;
+  bool pythonProfiling = m_PySystemManager->IsPythonProfiling ();
+  if (ImGui::Checkbox ("Profile Python calls", &pythonProfiling))
+  {
+    m_PySystemManager->SetPythonProfiling (pythonProfiling);
+  }
+  ImGui::SameLine ();
+  if (ImGui::Button ("Reset"))
+  {
+    m_PySystemManager->ResetPythonHotspots ();
+  }
+  for (auto& hotspot : m_PySystemManager->GetPythonHotspots (20))
+  {
+    ImGui::Text ("%8.3f ms %6zu calls  %s", hotspot.time, hotspot.calls, hotspot.location.c_str ());
+  }
+}
 }
\ No newline at end of file
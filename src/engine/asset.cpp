@@ -22,4 +22,173 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
-#include <engine/asset.h>
\ No newline at end of file
+
+#include <array>
+#include <fstream>
+#include <sstream>
+
+#include <engine/asset.h>
+#include <utility/file_utility.h>
+#include <utility/pack_file.h>
+#include <utility/log.h>
+
+namespace sfge
+{
+
+/**
+* \brief Namespace of the name based uuids, so an asset keeps the same uuid between two runs
+*/
+static const uuids::uuid assetNamespaceUuid{ std::string_view("5f1d2c8a-7b3e-4e6a-9c41-0d2b8f6a3e17") };
+
+AssetId AssetManager::LoadAsset(const std::string& path, AssetType type, bool hashContent)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		const auto assetIt = m_PathIndex.find(path);
+		if (assetIt != m_PathIndex.end())
+		{
+			return assetIt->second;
+		}
+	}
+	//The file is read outside the lock, so several loaders can hash at the same time
+	xxh::hash64_t contentHash = 0;
+	const auto* pack = GetMountedPack();
+	const bool found = hashContent ? HashFile(path, contentHash) :
+		(pack != nullptr && pack->FindEntry(path) != nullptr) || FileExists(path);
+	if (!found)
+	{
+		std::ostringstream oss;
+		oss << "[ERROR] Asset file: " << path << " cannot be read";
+		Log::GetInstance()->Error(oss.str());
+		return INVALID_ASSET;
+	}
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	const auto pathIt = m_PathIndex.find(path);
+	if (pathIt != m_PathIndex.end())
+	{
+		return pathIt->second;
+	}
+	const auto contentIt = hashContent ? m_ContentIndex.find(contentHash) : m_ContentIndex.end();
+	if (contentIt != m_ContentIndex.end())
+	{
+		m_PathIndex[path] = contentIt->second;
+		return contentIt->second;
+	}
+
+	Asset asset;
+	asset.path = path;
+	const auto nameIndex = path.find_last_of("/\\");
+	asset.name = nameIndex == std::string::npos ? path : path.substr(nameIndex + 1);
+	asset.hash = contentHash;
+	asset.uuid = uuids::uuid_name_generator(assetNamespaceUuid)(path);
+	asset.type = type;
+	m_Assets.push_back(std::move(asset));
+
+	const AssetId assetId = static_cast<AssetId>(m_Assets.size());
+	m_PathIndex[path] = assetId;
+	if (hashContent)
+	{
+		m_ContentIndex[contentHash] = assetId;
+	}
+	return assetId;
+}
+
+AssetId AssetManager::FindAsset(const std::string& path) const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	const auto assetIt = m_PathIndex.find(path);
+	return assetIt == m_PathIndex.end() ? INVALID_ASSET : assetIt->second;
+}
+
+AssetId AssetManager::ReloadAsset(const std::string& path, AssetType type)
+{
+	xxh::hash64_t contentHash = 0;
+	if (!FileExists(path) || !HashFile(path, contentHash))
+	{
+		std::ostringstream oss;
+		oss << "[ERROR] Asset file: " << path << " cannot be read";
+		Log::GetInstance()->Error(oss.str());
+		return INVALID_ASSET;
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		const auto pathIt = m_PathIndex.find(path);
+		if (pathIt != m_PathIndex.end())
+		{
+			const AssetId assetId = pathIt->second;
+			auto& asset = m_Assets[assetId - 1];
+			if (asset.hash == contentHash)
+			{
+				return assetId;
+			}
+			if (asset.path == path)
+			{
+				const auto contentIt = m_ContentIndex.find(asset.hash);
+				if (contentIt != m_ContentIndex.end() && contentIt->second == assetId)
+				{
+					m_ContentIndex.erase(contentIt);
+				}
+				asset.hash = contentHash;
+				m_ContentIndex.emplace(contentHash, assetId);
+				return assetId;
+			}
+			//The other files keep the shared asset
+			m_PathIndex.erase(pathIt);
+		}
+	}
+	return LoadAsset(path, type);
+}
+
+const Asset* AssetManager::GetAsset(AssetId assetId) const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	if (assetId == INVALID_ASSET || assetId > m_Assets.size())
+		return nullptr;
+	return &m_Assets[assetId - 1];
+}
+
+size_t AssetManager::GetAssetCount() const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Assets.size();
+}
+
+bool AssetManager::HashFile(const std::string& path, xxh::hash64_t& hash)
+{
+	//The pack tool already hashed the content
+	const auto* pack = GetMountedPack();
+	const auto* packEntry = pack == nullptr ? nullptr : pack->FindEntry(path);
+	if (packEntry != nullptr)
+	{
+		hash = packEntry->contentHash;
+		return true;
+	}
+	std::ifstream input(path, std::ios::binary);
+	if (!input)
+	{
+		return false;
+	}
+	xxh::hash_state_t<64> hashStream(0);
+	std::array<char, 64 * 1024> buffer{};
+	while (input)
+	{
+		input.read(buffer.data(), buffer.size());
+		const auto readSize = static_cast<size_t>(input.gcount());
+		if (readSize > 0)
+		{
+			hashStream.update(buffer.data(), readSize);
+		}
+	}
+	hash = hashStream.digest();
+	return true;
+}
+
+void AssetManager::Destroy()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_Assets.clear();
+	m_PathIndex.clear();
+	m_ContentIndex.clear();
+}
+}
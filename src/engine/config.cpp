@@ -70,6 +70,28 @@ std::unique_ptr<Configuration> Configuration::LoadConfig(json& configJson)
 
 	if(CheckJsonExists(configJson, "devMode"))
 		newConfig->devMode = configJson["devMode"];
+	if (CheckJsonExists(configJson, "renderThread"))
+		newConfig->renderThread = configJson["renderThread"];
+	if (CheckJsonExists(configJson, "instancedSprites"))
+		newConfig->instancedSprites = configJson["instancedSprites"];
+	if (CheckJsonNumber(configJson, "textureUploadBudget"))
+		newConfig->textureUploadBudget = configJson["textureUploadBudget"];
+	if (CheckJsonParameter(configJson, "textureCacheDirname", json::value_t::string))
+		newConfig->textureCacheDirname = configJson["textureCacheDirname"].get<std::string>();
+	if (CheckJsonNumber(configJson, "textureCacheMaxSize"))
+		newConfig->textureCacheMaxSize = configJson["textureCacheMaxSize"];
+	if (CheckJsonExists(configJson, "cookScenes"))
+		newConfig->cookScenes = configJson["cookScenes"];
+	if (CheckJsonExists(configJson, "lazySceneSearch"))
+		newConfig->lazySceneSearch = configJson["lazySceneSearch"];
+	if (CheckJsonExists(configJson, "lazyScripts"))
+		newConfig->lazyScripts = configJson["lazyScripts"];
+	if (CheckJsonParameter(configJson, "scriptCacheDirname", json::value_t::string))
+		newConfig->scriptCacheDirname = configJson["scriptCacheDirname"].get<std::string>();
+	if (CheckJsonExists(configJson, "hotReload"))
+		newConfig->hotReload = configJson["hotReload"];
+	if (CheckJsonParameter(configJson, "packFilename", json::value_t::string))
+		newConfig->packFilename = configJson["packFilename"].get<std::string>();
 	return newConfig;
 }
 
@@ -0,0 +1,302 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <fstream>
+#include <sstream>
+
+#include <engine/cooked_scene.h>
+#include <engine/component.h>
+#include <graphics/sprite2d.h>
+#include <graphics/animation2d.h>
+#include <utility/log.h>
+
+namespace sfge
+{
+
+static const std::uint32_t cookedSectionStrides[static_cast<size_t>(CookedSectionType::LENGTH)] =
+{
+	sizeof(std::uint32_t),
+	sizeof(CookedSystem),
+	sizeof(CookedTransform2d),
+	sizeof(CookedSprite),
+	sizeof(CookedShape),
+	sizeof(CookedSound),
+	sizeof(CookedAnimation2d),
+	sizeof(CookedBody2d),
+	sizeof(CookedCollider)
+};
+
+std::string GetCookedScenePath(const std::string& scenePath)
+{
+	const auto extensionIndex = scenePath.find_last_of('.');
+	const auto folderIndex = scenePath.find_last_of("/\\");
+	if (extensionIndex == std::string::npos || (folderIndex != std::string::npos && extensionIndex < folderIndex))
+	{
+		return scenePath + ".cscene";
+	}
+	return scenePath.substr(0, extensionIndex) + ".cscene";
+}
+
+std::uint32_t SceneCooker::AddString(const std::string& value)
+{
+	const auto stringIt = m_StringIndexes.find(value);
+	if (stringIt != m_StringIndexes.end())
+	{
+		return stringIt->second;
+	}
+	const auto index = static_cast<std::uint32_t>(m_StringTable.size());
+	m_StringTable.append(value);
+	m_StringTable.push_back('\0');
+	m_StringIndexes[value] = index;
+	return index;
+}
+
+bool SceneCooker::Cook(const json& sceneJson, std::uint64_t sourceHash)
+{
+	m_Header.sourceHash = sourceHash;
+	if (CheckJsonParameter(sceneJson, "name", json::value_t::string))
+	{
+		m_Header.nameIndex = AddString(sceneJson["name"].get<std::string>());
+	}
+	if (CheckJsonParameter(sceneJson, "systems", json::value_t::array))
+	{
+		for (auto& systemJson : sceneJson["systems"])
+		{
+			CookedSystem system;
+			if (CheckJsonParameter(systemJson, "script_path", json::value_t::string))
+			{
+				system.scriptPathIndex = AddString(systemJson["script_path"].get<std::string>());
+			}
+			if (CheckJsonParameter(systemJson, "systemClassName", json::value_t::string))
+			{
+				system.classNameIndex = AddString(systemJson["systemClassName"].get<std::string>());
+			}
+			m_Systems.push_back(system);
+		}
+	}
+	if (!CheckJsonParameter(sceneJson, "entities", json::value_t::array))
+	{
+		return true;
+	}
+	const auto& entitiesJson = sceneJson["entities"];
+	m_Header.entityCount = static_cast<std::uint32_t>(entitiesJson.size());
+	m_EntityNames.reserve(entitiesJson.size());
+	std::uint32_t entityIndex = 0U;
+	for (auto& entityJson : entitiesJson)
+	{
+		m_EntityNames.push_back(CheckJsonParameter(entityJson, "name", json::value_t::string) ?
+			AddString(entityJson["name"].get<std::string>()) : INVALID_COOKED_STRING);
+		if (CheckJsonExists(entityJson, "components"))
+		{
+			for (auto& componentJson : entityJson["components"])
+			{
+				//Malformed components are reported by the json loading
+				if (!CheckJsonNumber(componentJson, "type"))
+				{
+					return false;
+				}
+				const ComponentType componentType = componentJson["type"];
+				switch (componentType)
+				{
+				case ComponentType::TRANSFORM2D:
+					m_Transforms.push_back({ entityIndex, Transform2dManager::GetDefFromJson(componentJson) });
+					break;
+				case ComponentType::SPRITE2D:
+				{
+					const auto def = SpriteManager::GetDefFromJson(componentJson);
+					CookedSprite sprite;
+					sprite.entityIndex = entityIndex;
+					sprite.pathIndex = def.path.empty() ? INVALID_COOKED_STRING : AddString(def.path);
+					sprite.layer = def.layer;
+					sprite.hasLayer = def.hasLayer ? 1U : 0U;
+					m_Sprites.push_back(sprite);
+					break;
+				}
+				case ComponentType::SHAPE2D:
+					if (!CheckJsonNumber(componentJson, "shape_type"))
+					{
+						return false;
+					}
+					m_Shapes.push_back({ entityIndex, ShapeManager::GetDefFromJson(componentJson) });
+					break;
+				case ComponentType::BODY2D:
+					m_Bodies.push_back({ entityIndex, Body2dManager::GetDefFromJson(componentJson) });
+					break;
+				case ComponentType::COLLIDER2D:
+					m_Colliders.push_back({ entityIndex, ColliderManager::GetDefFromJson(componentJson) });
+					break;
+				case ComponentType::SOUND:
+				{
+					if (!CheckJsonParameter(componentJson, "path", json::value_t::string))
+					{
+						return false;
+					}
+					CookedSound sound;
+					sound.entityIndex = entityIndex;
+					sound.pathIndex = AddString(componentJson["path"].get<std::string>());
+					m_Sounds.push_back(sound);
+					break;
+				}
+				case ComponentType::ANIMATION2D:
+				{
+					const auto def = Animation2dManager::GetDefFromJson(componentJson);
+					CookedAnimation2d animation;
+					animation.entityIndex = entityIndex;
+					animation.pathIndex = def.path.empty() ? INVALID_COOKED_STRING : AddString(def.path);
+					animation.speed = def.speed;
+					m_Animations.push_back(animation);
+					break;
+				}
+				default:
+				{
+					std::ostringstream oss;
+					oss << "[Warning] Component type " << static_cast<int>(componentType) << " cannot be cooked, the scene stays in json";
+					Log::GetInstance()->Msg(oss.str());
+					return false;
+				}
+				}
+			}
+		}
+		entityIndex++;
+	}
+	return true;
+}
+
+template<typename TRecord>
+static void AddCookedSection(std::vector<CookedSection>& sections, std::vector<std::pair<const char*, size_t>>& blocks,
+	CookedSectionType type, const std::vector<TRecord>& records)
+{
+	if (records.empty())
+		return;
+	CookedSection section;
+	section.type = static_cast<std::uint32_t>(type);
+	section.count = static_cast<std::uint32_t>(records.size());
+	section.stride = sizeof(TRecord);
+	sections.push_back(section);
+	blocks.emplace_back(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(TRecord));
+}
+
+bool SceneCooker::Write(const std::string& cookedPath) const
+{
+	std::vector<CookedSection> sections;
+	std::vector<std::pair<const char*, size_t>> blocks;
+	AddCookedSection(sections, blocks, CookedSectionType::ENTITY_NAMES, m_EntityNames);
+	AddCookedSection(sections, blocks, CookedSectionType::SYSTEMS, m_Systems);
+	AddCookedSection(sections, blocks, CookedSectionType::TRANSFORM2D, m_Transforms);
+	AddCookedSection(sections, blocks, CookedSectionType::SPRITE2D, m_Sprites);
+	AddCookedSection(sections, blocks, CookedSectionType::SHAPE2D, m_Shapes);
+	AddCookedSection(sections, blocks, CookedSectionType::SOUND, m_Sounds);
+	AddCookedSection(sections, blocks, CookedSectionType::ANIMATION2D, m_Animations);
+	AddCookedSection(sections, blocks, CookedSectionType::BODY2D, m_Bodies);
+	AddCookedSection(sections, blocks, CookedSectionType::COLLIDER2D, m_Colliders);
+
+	//Every section starts on 8 bytes so the records can be read in place
+	const auto align = [](size_t offset) { return (offset + 7U) & ~size_t(7U); };
+	size_t offset = align(sizeof(CookedSceneHeader) + sections.size() * sizeof(CookedSection));
+	for (size_t i = 0; i < sections.size(); i++)
+	{
+		sections[i].offset = static_cast<std::uint32_t>(offset);
+		offset = align(offset + blocks[i].second);
+	}
+	CookedSceneHeader header = m_Header;
+	header.sectionCount = static_cast<std::uint32_t>(sections.size());
+	header.stringTableOffset = static_cast<std::uint32_t>(offset);
+	header.stringTableSize = static_cast<std::uint32_t>(m_StringTable.size());
+
+	std::ofstream cookedFile(cookedPath, std::ios::binary | std::ios::trunc);
+	if (!cookedFile)
+	{
+		std::ostringstream oss;
+		oss << "[Error] Could not write cooked scene: " << cookedPath;
+		Log::GetInstance()->Error(oss.str());
+		return false;
+	}
+	const char padding[8] = {};
+	const auto writePadding = [&cookedFile, &padding, &align]()
+	{
+		const auto position = static_cast<size_t>(cookedFile.tellp());
+		cookedFile.write(padding, align(position) - position);
+	};
+	cookedFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	cookedFile.write(reinterpret_cast<const char*>(sections.data()), sections.size() * sizeof(CookedSection));
+	writePadding();
+	for (auto& block : blocks)
+	{
+		cookedFile.write(block.first, block.second);
+		writePadding();
+	}
+	cookedFile.write(m_StringTable.data(), m_StringTable.size());
+	return static_cast<bool>(cookedFile);
+}
+
+bool CookedSceneView::Open(const std::string& cookedPath, std::uint64_t sourceHash)
+{
+	m_Header = nullptr;
+	m_Sections = nullptr;
+	if (!m_File.Open(cookedPath) || m_File.GetSize() < sizeof(CookedSceneHeader))
+	{
+		return false;
+	}
+	const auto* header = reinterpret_cast<const CookedSceneHeader*>(m_File.GetData());
+	const size_t fileSize = m_File.GetSize();
+	if (header->magic != COOKED_SCENE_MAGIC ||
+		header->version != COOKED_SCENE_VERSION ||
+		header->sourceHash != sourceHash ||
+		sizeof(CookedSceneHeader) + size_t(header->sectionCount) * sizeof(CookedSection) > fileSize ||
+		size_t(header->stringTableOffset) + header->stringTableSize > fileSize ||
+		(header->stringTableSize > 0 && m_File.GetData()[header->stringTableOffset + header->stringTableSize - 1] != '\0'))
+	{
+		return false;
+	}
+	const auto* sections = reinterpret_cast<const CookedSection*>(m_File.GetData() + sizeof(CookedSceneHeader));
+	for (std::uint32_t i = 0U; i < header->sectionCount; i++)
+	{
+		const auto& section = sections[i];
+		if (section.type >= static_cast<std::uint32_t>(CookedSectionType::LENGTH) ||
+			section.stride != cookedSectionStrides[section.type] ||
+			section.offset % 8U != 0U ||
+			size_t(section.offset) + size_t(section.count) * section.stride > fileSize)
+		{
+			return false;
+		}
+	}
+	m_Header = header;
+	m_Sections = sections;
+	return true;
+}
+
+const CookedSceneHeader& CookedSceneView::GetHeader() const
+{
+	return *m_Header;
+}
+
+const char* CookedSceneView::GetString(std::uint32_t index) const
+{
+	if (index == INVALID_COOKED_STRING || index >= m_Header->stringTableSize)
+		return nullptr;
+	return m_File.GetData() + m_Header->stringTableOffset + index;
+}
+
+}
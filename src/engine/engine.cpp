@@ -33,6 +33,7 @@ SOFTWARE.
 #include <engine/globals.h>
 
 #include <utility/log.h>
+#include <utility/pack_file.h>
 
 #include <graphics/graphics2d.h>
 #include <audio/audio.h>
@@ -43,15 +44,25 @@ SOFTWARE.
 #include <editor/editor.h>
 #include <engine/entity.h>
 #include <engine/transform2d.h>
+#include <engine/asset.h>
+#include <engine/system_registry.h>
+
+#include <extensions/native_extensions.h>
 
 
 namespace sfge
 {
 
+/**
+* \brief Folder of the python scripts loaded by the PythonEngine
+*/
+static const char* hotReloadScriptsDirname = "scripts/";
+
 struct SystemsContainer
 {
 public:
 	SystemsContainer(Engine &engine) :
+		assetManager(engine),
 		graphics2dManager(engine),
 		audioManager(engine),
 		sceneManager(engine),
@@ -66,6 +77,7 @@ public:
 	}
 	SystemsContainer(const SystemsContainer&) = delete;
 
+	AssetManager assetManager;
 	Graphics2dManager graphics2dManager;
 	AudioManager audioManager;
 	SceneManager sceneManager;
@@ -75,6 +87,7 @@ public:
 	Editor editor;
 	EntityManager entityManager;
 	Transform2dManager transformManager;
+	SystemRegistry systemRegistry;
 
 };
 
@@ -128,6 +141,24 @@ void Engine::InitModules()
     }
     m_ThreadPool.resize(std::thread::hardware_concurrency ()-1);
 
+	if (m_Config != nullptr && !m_Config->packFilename.empty())
+	{
+		//The loose files changed on the disk would be hidden by the pack
+		if (m_Config->devMode && m_Config->hotReload)
+		{
+			Log::GetInstance()->Msg("Hot reload is enabled, the pack is not mounted");
+		}
+		else if (!MountPack(m_Config->packFilename))
+		{
+			std::ostringstream oss;
+			oss << "[Warning] Pack file: " << m_Config->packFilename << " cannot be mounted, the loose files are read";
+			Log::GetInstance()->Msg(oss.str());
+		}
+	}
+
+	ext::RegisterNativeSystems(m_SystemsContainer->systemRegistry);
+
+	m_SystemsContainer->assetManager.OnEngineInit();
 	m_SystemsContainer->entityManager.OnEngineInit();
 	m_SystemsContainer->transformManager.OnEngineInit();
 	m_SystemsContainer->graphics2dManager.OnEngineInit();
@@ -138,6 +169,12 @@ void Engine::InitModules()
 	m_SystemsContainer->physicsManager.OnEngineInit();
 	m_SystemsContainer->editor.OnEngineInit();
 
+	if (m_Config != nullptr && m_Config->devMode && m_Config->hotReload)
+	{
+		m_HotReload = m_FileWatcher.Watch(m_Config->dataDirname);
+		m_HotReload = m_FileWatcher.Watch(hotReloadScriptsDirname) || m_HotReload;
+	}
+
 	m_Window = m_SystemsContainer->graphics2dManager.GetWindow();
 	running = true;
 }
@@ -168,6 +205,7 @@ void Engine::Start()
 			if (event.type == sf::Event::Closed)
 			{
 				running = false;
+				m_SystemsContainer->graphics2dManager.StopRenderThread();
 				m_Window->close();
 			}
 
@@ -182,6 +220,10 @@ void Engine::Start()
 		{
 			continue;
 		}
+		if (m_HotReload)
+		{
+			HotReload();
+		}
 
 
 		m_SystemsContainer->inputManager.OnUpdate(dt.asSeconds());
@@ -213,6 +255,8 @@ void Engine::Start()
 
 		m_SystemsContainer->pythonEngine.OnDraw();
 		m_SystemsContainer->sceneManager.OnDraw();
+		m_SystemsContainer->physicsManager.OnDraw();
+		m_SystemsContainer->graphics2dManager.FlushDebugDraw();
 		m_SystemsContainer->editor.OnDraw();
 
         m_SystemsContainer->graphics2dManager.Display();
@@ -232,6 +276,8 @@ void Engine::Start()
 
 void Engine::Destroy() 
 {
+	m_FileWatcher.Stop();
+	m_HotReload = false;
 
 	m_SystemsContainer->pythonEngine.Destroy();
 	m_SystemsContainer->entityManager.Destroy();
@@ -241,6 +287,9 @@ void Engine::Destroy()
 	m_SystemsContainer->inputManager.Destroy();
 	m_SystemsContainer->editor.Destroy();
 	m_SystemsContainer->physicsManager.Destroy();
+	m_SystemsContainer->assetManager.Destroy();
+	m_SystemsContainer->systemRegistry.Clear();
+	UnmountPack();
 	rmt_DestroyGlobalInstance(rmt);
 
 }
@@ -271,6 +320,21 @@ void Engine::Collect()
 }
 
 
+void Engine::HotReload()
+{
+	rmt_ScopedCPUSample(HotReload,0);
+	for (auto& path : m_FileWatcher.Poll())
+	{
+		if (m_SystemsContainer->graphics2dManager.GetTextureManager()->ReloadTexture(path))
+			continue;
+		if (m_SystemsContainer->audioManager.GetSoundBufferManager()->ReloadSoundBuffer(path))
+			continue;
+		if (m_SystemsContainer->pythonEngine.ReloadPyModule(path))
+			continue;
+		m_SystemsContainer->sceneManager.ReloadScene(path);
+	}
+}
+
 Configuration * Engine::GetConfig() const
 {
 	return m_Config.get();
@@ -322,6 +386,16 @@ Editor* Engine::GetEditor()
 	return m_SystemsContainer ? &m_SystemsContainer->editor : nullptr;
 }
 
+AssetManager* Engine::GetAssetManager()
+{
+	return m_SystemsContainer ? &m_SystemsContainer->assetManager : nullptr;
+}
+
+SystemRegistry* Engine::GetSystemRegistry()
+{
+	return m_SystemsContainer ? &m_SystemsContainer->systemRegistry : nullptr;
+}
+
 ctpl::thread_pool & Engine::GetThreadPool()
 {
 	return m_ThreadPool;
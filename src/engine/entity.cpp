@@ -50,6 +50,11 @@ EntityMask EntityManager::GetMask(Entity entity)
 	return m_MaskArray[entity-1];
 }
 
+const std::vector<EntityMask>& EntityManager::GetMasks() const
+{
+	return m_MaskArray;
+}
+
 Entity EntityManager::CreateEntity(Entity wantedEntity)
 {
 
@@ -63,7 +68,7 @@ Entity EntityManager::CreateEntity(Entity wantedEntity)
             }
         }
     }
-    else
+    else if(wantedEntity <= m_MaskArray.size())
     {
         if(m_MaskArray[wantedEntity-1] == INVALID_ENTITY)
         {
@@ -94,7 +99,12 @@ bool EntityManager::HasComponent(Entity entity, ComponentType componentType)
 
 void EntityManager::AddComponentType(Entity entity, ComponentType componentType)
 {
-
+	if (m_DeferComponentTypes)
+	{
+		std::lock_guard<std::mutex> lock(m_MaskMutex);
+		m_DeferredComponentTypes.emplace_back(entity, static_cast<int>(componentType));
+		return;
+	}
 	m_MaskArray[entity - 1] = m_MaskArray[entity - 1] | static_cast<int>(componentType);
 }
 
@@ -103,6 +113,21 @@ void EntityManager::RemoveComponentType(Entity entity, ComponentType componentTy
 	m_MaskArray[entity - 1] &= ~static_cast<int>(componentType);
 }
 
+void EntityManager::DeferComponentTypes()
+{
+	m_DeferComponentTypes = true;
+}
+
+void EntityManager::ApplyDeferredComponentTypes()
+{
+	m_DeferComponentTypes = false;
+	for (const auto& componentType : m_DeferredComponentTypes)
+	{
+		m_MaskArray[componentType.first - 1] |= componentType.second;
+	}
+	m_DeferredComponentTypes.clear();
+}
+
 editor::EntityInfo& EntityManager::GetEntityInfo(Entity entity)
 {
 	return m_EntityInfos[entity - 1];
@@ -121,6 +146,35 @@ Entity EntityManager::GetEntityByName(std::string entityName) const
 	return INVALID_ENTITY;
 }
 
+std::vector<Entity> EntityManager::CreateEntities(size_t count)
+{
+	std::vector<Entity> entities;
+	entities.reserve(count);
+	for (Entity entity = 1U; entity <= m_MaskArray.size() && entities.size() < count; entity++)
+	{
+		if (m_MaskArray[entity - 1] == INVALID_ENTITY)
+		{
+			entities.push_back(entity);
+		}
+	}
+	if (entities.size() < count)
+	{
+		const size_t previousSize = m_MaskArray.size();
+		ResizeEntityNmb(previousSize + count - entities.size());
+		for (Entity entity = previousSize + 1; entities.size() < count; entity++)
+		{
+			entities.push_back(entity);
+		}
+	}
+	for (auto entity : entities)
+	{
+		std::ostringstream oss;
+		oss << "Entity: " << entity;
+		m_EntityInfos[entity - 1].name = oss.str();
+	}
+	return entities;
+}
+
 void EntityManager::ResizeEntityNmb(size_t newSize)
 {
 	m_MaskArray.resize(newSize);
@@ -27,6 +27,11 @@
 
 #include <cmath>
 #include <vector>
+#include <future>
+#include <set>
+#include <chrono>
+#include <algorithm>
+#include <fstream>
 
 //SFGE includes
 #include <engine/scene.h>
@@ -35,6 +40,7 @@
 #include <editor/editor.h>
 #include <engine/config.h>
 #include <utility/file_utility.h>
+#include <utility/pack_file.h>
 #include <engine/entity.h>
 #include <graphics/graphics2d.h>
 #include <python/python_engine.h>
@@ -42,24 +48,72 @@
 #include <physics/physics2d.h>
 #include <audio/audio.h>
 #include <engine/engine.h>
+#include <engine/asset.h>
+#include <engine/system_registry.h>
+#include <engine/cooked_scene.h>
+#include <engine/transform2d.h>
+#include <graphics/sprite2d.h>
+#include <graphics/shape2d.h>
+#include <graphics/animation2d.h>
+#include <physics/body2d.h>
+#include <physics/collider2d.h>
+#include <audio/sound.h>
 
 // for convenience
 
 
 namespace sfge
 {
+
+/**
+* \brief The component types of one stage do not depend on each other, the later stages read the components of the previous ones
+*/
+struct SceneLoadStage
+{
+	std::vector<ComponentType> poolTypes;
+	/**
+	* \brief Types creating GL resources, kept on the thread owning the context
+	*/
+	std::vector<ComponentType> mainThreadTypes;
+};
+
+static const char* sceneIndexFilename = "scene_index.json";
+static const int sceneIndexVersion = 1;
+/**
+* \brief Entities parsed before their components are created when a scene is streamed from its file
+*/
+static const size_t sceneStreamBatchSize = 1024;
+
+static std::uint64_t HashSnapshotJson(const json& value)
+{
+	return value.empty() ? 0U : xxh::xxhash<64>(value.dump());
+}
+
+static const std::vector<SceneLoadStage> sceneLoadStages =
+{
+	{ { ComponentType::TRANSFORM2D, ComponentType::SOUND }, { ComponentType::SPRITE2D } },
+	//The shapes read the transforms when they are created
+	{ { ComponentType::BODY2D, ComponentType::SHAPE2D }, { ComponentType::ANIMATION2D } },
+	{ {}, { ComponentType::COLLIDER2D } }
+};
+
 SceneManager::SceneManager(Engine& engine):
 	System(engine)
 	
 {
 }
 
+SceneManager::~SceneManager() = default;
+
 void SceneManager::OnEngineInit()
 {
 	m_EntityManager = m_Engine.GetEntityManager();
 	if(auto config = m_Engine.GetConfig())
 	{
-		SearchScenes(config->dataDirname);
+		if (!config->lazySceneSearch)
+		{
+			SearchScenes(config->dataDirname);
+		}
 	}
 	else
 	{
@@ -67,27 +121,101 @@ void SceneManager::OnEngineInit()
 	}
 }
 
+/**
+* \brief Parse only the name of the scene, the entities and the systems are skipped by the parser callback
+*/
+static bool ReadSceneName(const std::string& scenePath, std::string& sceneName)
+{
+	const auto sceneJsonPtr = LoadJson(scenePath, [](int depth, json::parse_event_t event, json& parsed)
+	{
+		switch (event)
+		{
+		case json::parse_event_t::object_start:
+		case json::parse_event_t::array_start:
+			return depth == 0;
+		case json::parse_event_t::key:
+			return parsed == "name";
+		default:
+			return true;
+		}
+	});
+	if (sceneJsonPtr == nullptr || !CheckJsonParameter(*sceneJsonPtr, "name", json::value_t::string))
+		return false;
+	sceneName = (*sceneJsonPtr)["name"].get<std::string>();
+	return true;
+}
+
+/**
+* \brief Same text as json::dump, but with the name and the systems before the entities,
+* so LoadSceneFromStream can create the entities as soon as they are parsed
+*/
+static std::string DumpSceneJson(const json& sceneJson, int indent)
+{
+	std::vector<std::string> keys = { "name", "systems" };
+	for (auto memberIt = sceneJson.begin(); memberIt != sceneJson.end(); ++memberIt)
+	{
+		if (std::find(keys.begin(), keys.end(), memberIt.key()) == keys.end())
+		{
+			keys.push_back(memberIt.key());
+		}
+	}
+	std::string sceneText = "{";
+	bool firstMember = true;
+	for (const auto& key : keys)
+	{
+		const auto memberIt = sceneJson.find(key);
+		if (memberIt == sceneJson.end())
+			continue;
+		//Each member is dumped alone in an object, so it keeps the indentation of the whole document
+		json memberJson = json::object();
+		memberJson[key] = *memberIt;
+		const std::string memberText = memberJson.dump(indent);
+		sceneText += firstMember ? "\n" : ",\n";
+		sceneText += memberText.substr(2, memberText.size() - 4);
+		firstMember = false;
+	}
+	sceneText += firstMember ? "}" : "\n}";
+	return sceneText;
+}
+
 void SceneManager::SearchScenes(std::string& dataDirname)
 {
+	rmt_ScopedCPUSample(SearchScenes,0);
+	m_ScenesSearched = true;
+	const std::string indexPath = dataDirname + sceneIndexFilename;
+	LoadSceneIndex(indexPath);
+
+	std::map<std::string, SceneIndexEntry> foundScenes;
+	size_t parsedScenes = 0;
 	std::function<void(std::string)> SearchAllScenes;
-	SearchAllScenes = [&SearchAllScenes, this](std::string entry)
+	SearchAllScenes = [&](std::string entry)
 	{
-		
-		if (IsRegularFile(entry))
+		//The extension is checked first, only the scene files and the folders are stat
+		const std::string::size_type filenameExtensionIndex = entry.find_last_of('.');
+		const bool isSceneFile = filenameExtensionIndex != std::string::npos &&
+			entry.compare(filenameExtensionIndex, std::string::npos, ".scene") == 0;
+		if (isSceneFile && IsRegularFile(entry))
 		{
-			const std::string::size_type filenameExtensionIndex = entry.find_last_of('.');
-			const std::string extension = entry.substr(filenameExtensionIndex);
-			if(extension == ".scene")
+			SceneIndexEntry indexEntry;
+			indexEntry.modificationTime = GetFileModificationTime(entry);
+			indexEntry.size = static_cast<long long>(CalculateFileSize(entry));
+			const auto indexIt = m_SceneIndex.find(entry);
+			if (indexIt != m_SceneIndex.end() &&
+				indexIt->second.modificationTime == indexEntry.modificationTime &&
+				indexIt->second.size == indexEntry.size)
 			{
-				const auto sceneJsonPtr = LoadJson(entry);
-				if(sceneJsonPtr && CheckJsonExists(*sceneJsonPtr, "name"))
-				{
-					m_ScenePathMap.insert(std::pair<std::string, std::string>((*sceneJsonPtr)["name"],entry));
-				}
+				foundScenes.emplace(entry, indexIt->second);
+				return;
 			}
+			//Scenes without name are indexed too, they are not parsed at each search
+			ReadSceneName(entry, indexEntry.name);
+			xxh::hash64_t sourceHash = 0;
+			AssetManager::HashFile(entry, sourceHash);
+			indexEntry.hash = sourceHash;
+			foundScenes.emplace(entry, indexEntry);
+			parsedScenes++;
 		}
-
-		if (IsDirectory(entry))
+		else if (!isSceneFile && IsDirectory(entry))
 		{
 			{
 				std::ostringstream oss;
@@ -98,23 +226,154 @@ void SceneManager::SearchScenes(std::string& dataDirname)
 		}
 	};
 	IterateDirectory(dataDirname, SearchAllScenes);
+
+	const bool indexChanged = parsedScenes != 0 || foundScenes.size() != m_SceneIndex.size();
+	m_SceneIndex = std::move(foundScenes);
+	m_ScenePathMap.clear();
+	for (auto& indexPair : m_SceneIndex)
+	{
+		if (!indexPair.second.name.empty())
+		{
+			m_ScenePathMap.insert(std::pair<std::string, std::string>(indexPair.second.name, indexPair.first));
+		}
+	}
+	if (indexChanged)
+	{
+		SaveSceneIndex(indexPath);
+	}
+	{
+		std::ostringstream oss;
+		oss << "Scenes found: " << m_SceneIndex.size() << ", parsed: " << parsedScenes;
+		Log::GetInstance()->Msg(oss.str());
+	}
+}
+
+void SceneManager::EnsureScenesSearched()
+{
+	if (m_ScenesSearched)
+		return;
+	if (auto config = m_Engine.GetConfig())
+	{
+		SearchScenes(config->dataDirname);
+	}
+}
+
+void SceneManager::LoadSceneIndex(const std::string& indexPath)
+{
+	m_SceneIndex.clear();
+	if (!FileExists(indexPath))
+		return;
+	const auto indexJsonPtr = LoadJson(indexPath);
+	if (indexJsonPtr == nullptr ||
+		!CheckJsonNumber(*indexJsonPtr, "version") ||
+		(*indexJsonPtr)["version"].get<int>() != sceneIndexVersion ||
+		!CheckJsonParameter(*indexJsonPtr, "scenes", json::value_t::array))
+	{
+		return;
+	}
+	for (auto& sceneJson : (*indexJsonPtr)["scenes"])
+	{
+		if (!CheckJsonParameter(sceneJson, "path", json::value_t::string) ||
+			!CheckJsonParameter(sceneJson, "name", json::value_t::string) ||
+			!CheckJsonNumber(sceneJson, "mtime") ||
+			!CheckJsonNumber(sceneJson, "size") ||
+			!CheckJsonNumber(sceneJson, "hash"))
+		{
+			continue;
+		}
+		SceneIndexEntry indexEntry;
+		indexEntry.name = sceneJson["name"].get<std::string>();
+		indexEntry.modificationTime = sceneJson["mtime"].get<long long>();
+		indexEntry.size = sceneJson["size"].get<long long>();
+		indexEntry.hash = sceneJson["hash"].get<std::uint64_t>();
+		m_SceneIndex.emplace(sceneJson["path"].get<std::string>(), indexEntry);
+	}
+}
+
+void SceneManager::SaveSceneIndex(const std::string& indexPath)
+{
+	json indexJson;
+	indexJson["version"] = sceneIndexVersion;
+	indexJson["scenes"] = json::array();
+	for (auto& indexPair : m_SceneIndex)
+	{
+		json sceneJson;
+		sceneJson["path"] = indexPair.first;
+		sceneJson["name"] = indexPair.second.name;
+		sceneJson["mtime"] = indexPair.second.modificationTime;
+		sceneJson["size"] = indexPair.second.size;
+		sceneJson["hash"] = indexPair.second.hash;
+		indexJson["scenes"].push_back(sceneJson);
+	}
+	std::ofstream indexFile(indexPath, std::ios::trunc);
+	if (!indexFile)
+	{
+		std::ostringstream oss;
+		oss << "[Error] Could not write the scene index: " << indexPath;
+		Log::GetInstance()->Error(oss.str());
+		return;
+	}
+	indexFile << indexJson.dump(1, '\t');
+}
+
+bool SceneManager::GetSceneSourceHash(const std::string& scenePath, std::uint64_t& sourceHash)
+{
+	const auto indexIt = m_SceneIndex.find(scenePath);
+	if (indexIt != m_SceneIndex.end() && FileExists(scenePath) &&
+		indexIt->second.modificationTime == GetFileModificationTime(scenePath) &&
+		indexIt->second.size == static_cast<long long>(CalculateFileSize(scenePath)))
+	{
+		sourceHash = indexIt->second.hash;
+		return true;
+	}
+	xxh::hash64_t fileHash = 0;
+	if (!AssetManager::HashFile(scenePath, fileHash))
+		return false;
+	sourceHash = fileHash;
+	return true;
 }
 
 
 void SceneManager::LoadSceneFromPath(const std::string& scenePath)
 {
+	if (DeferSceneLoad([this, scenePath] { LoadSceneFromPath(scenePath); }))
+	{
+		return;
+	}
 	{
 		std::ostringstream oss;
 		oss << "Loading scene from: " << scenePath;
 		Log::GetInstance()->Msg(oss.str());
 	}
+	const std::string cookedPath = GetCookedScenePath(scenePath);
+	std::uint64_t sourceHash = 0;
+	const bool hasSourceHash = GetSceneSourceHash(scenePath, sourceHash);
+	if (hasSourceHash && LoadCookedScene(scenePath, cookedPath, sourceHash))
+	{
+		m_SceneSourceHash = sourceHash;
+		return;
+	}
+	auto sceneInfo = std::make_unique<editor::SceneInfo>();
+	sceneInfo->path = scenePath;
+	const auto* config = m_Engine.GetConfig();
+	if (!hasSourceHash || config == nullptr || !config->cookScenes)
+	{
+		LoadSceneFromStream(scenePath, std::move(sceneInfo));
+		m_SceneSourceHash = sourceHash;
+		return;
+	}
+	//The cooker needs the whole document
 	const auto sceneJsonPtr = LoadJson(scenePath);
 	
 	if(sceneJsonPtr != nullptr)
 	{
-		auto sceneInfo = std::make_unique<editor::SceneInfo>();
-		sceneInfo->path = scenePath;
+		SceneCooker sceneCooker;
+		if (sceneCooker.Cook(*sceneJsonPtr, sourceHash))
+		{
+			sceneCooker.Write(cookedPath);
+		}
 		LoadSceneFromJson(*sceneJsonPtr, std::move(sceneInfo));
+		m_SceneSourceHash = sourceHash;
 	}
 	else
 	{
@@ -131,226 +390,1323 @@ void SceneManager::LoadSceneFromJson(json& sceneJson, std::unique_ptr<editor::Sc
 	m_Engine.Clear();
 	if(!sceneInfo)
 		sceneInfo = std::make_unique<editor::SceneInfo>();
+	LoadSceneHeader(sceneJson, *sceneInfo);
+	if (CheckJsonParameter(sceneJson, "entities", json::value_t::array))
+	{
+		m_LoadStats = SceneLoadStats();
+		Entity lastEntity = INVALID_ENTITY;
+		LoadSceneEntities(sceneJson["entities"], lastEntity);
+	}
+	else
+	{
+		std::ostringstream oss;
+		oss << "No Entities in " << sceneInfo->name;
+		Log::GetInstance()->Error(oss.str());
+	}
+
+	FinishSceneLoad(std::move(sceneInfo));
+}
+
+void SceneManager::LoadSceneHeader(json& sceneJson, editor::SceneInfo& sceneInfo)
+{
 	if (CheckJsonParameter(sceneJson, "name", json::value_t::string))
 	{
-		sceneInfo->name = sceneJson["name"].get<std::string>();
+		sceneInfo.name = sceneJson["name"].get<std::string>();
 	}
 	else
 	{
-		sceneInfo->name = "NewScene";
+		sceneInfo.name = "NewScene";
 	}
 	{
 		std::ostringstream oss;
-		oss << "Loading scene: " << sceneInfo->name;
+		oss << "Loading scene: " << sceneInfo.name;
 		Log::GetInstance()->Msg(oss.str());
 	}
 	if (CheckJsonParameter(sceneJson, "systems", json::value_t::array))
 	{
 		for (auto& systemJson : sceneJson["systems"])
 		{
-			auto* pythonEngine = m_Engine.GetPythonEngine();
 			if (CheckJsonExists(systemJson, "script_path"))
 			{
-				std::string path = systemJson["script_path"];
-				const ModuleId moduleId = pythonEngine->LoadPyModule(path);
-				if (moduleId != INVALID_MODULE)
-				{
-					const InstanceId instanceId = pythonEngine->GetPySystemManager().LoadPySystem(moduleId);
-					PySystem* pySystem = pythonEngine->GetPySystemManager().GetPySystemFromInstanceId(instanceId);
-					if(pySystem != nullptr)
-					{
-						m_ScenePySystems.push_back(pySystem);
-					}
-					else
-					{
-						Log::GetInstance()->Error("[Python Error] Returned PySystem is null");
-					}
-				}
-				else
-				{
-					std::ostringstream oss;
-					oss << "Could not load PySystem at "<<path;
-					Log::GetInstance()->Error(oss.str());
-				}
+				LoadScenePySystem(systemJson["script_path"]);
 			}
 			if(CheckJsonExists(systemJson, "systemClassName"))
 			{
-				const std::string systemClassName = systemJson["systemClassName"];
-				auto instanceId = pythonEngine->GetPySystemManager().LoadCppExtensionSystem(systemClassName);
-				if(instanceId != INVALID_INSTANCE)
-				{
-					PySystem* pySystem = pythonEngine->GetPySystemManager().GetPySystemFromInstanceId(instanceId);
-					if(pySystem != nullptr)
-					{
-						m_ScenePySystems.push_back(pySystem);
-					}
-				}
+				LoadSceneCppSystem(systemJson["systemClassName"]);
 			}
 		}
 	}
-	if (CheckJsonParameter(sceneJson, "entities", json::value_t::array))
+}
+
+void SceneManager::LoadSceneFromStream(const std::string& scenePath, std::unique_ptr<editor::SceneInfo> sceneInfo)
+{
+	m_Engine.Clear();
+	m_LoadStats = SceneLoadStats();
+	Entity lastEntity = INVALID_ENTITY;
+	bool hasEntities = false;
+	bool entitiesLeft = true;
+	std::string rootKey;
+	json headerJson = json::object();
+	bool headerLoaded = false;
+	json entitiesBatch = json::array();
+	//The systems are loaded before the entities like in the other paths, the batches parsed before the end of the systems wait for them
+	std::vector<json> deferredBatches;
+	const auto loadEntitiesBatch = [&](json& batch)
 	{
-		const auto entityNmb = sceneJson["entities"].size();
-		if(entityNmb > INIT_ENTITY_NMB)
+		if (!headerLoaded)
 		{
-			m_EntityManager->ResizeEntityNmb(entityNmb);
+			deferredBatches.push_back(std::move(batch));
 		}
-		for(auto& entityJson : sceneJson["entities"])
+		else if (entitiesLeft)
 		{
-			Entity entity = INVALID_ENTITY;
-			entity = m_EntityManager->CreateEntity(INVALID_ENTITY);
-			if(entity == INVALID_ENTITY)
-			{
-				std::ostringstream oss;
-				oss << "[Error] Scene: not enough entities left";
-				Log::GetInstance()->Error(oss.str());
-				continue;
-			}
-			if(CheckJsonExists(entityJson, "name"))
-			{
-				m_EntityManager->GetEntityInfo(entity).name = entityJson["name"].get<std::string>();
-			}
-			else
-			{
-				std::ostringstream oss;
-				oss << "Entity " << entity;
-				m_EntityManager->GetEntityInfo(entity).name = oss.str();
-			}
-			if (entity != INVALID_ENTITY && 
-				CheckJsonExists(entityJson, "components"))
-			{
-				
-				for (auto& componentJson : entityJson["components"])
-				{
-					if (CheckJsonExists(componentJson, "type"))
-					{
-						const ComponentType componentType = componentJson["type"];
-						const auto index = static_cast<int>(log2(static_cast<double>(componentType)));
-						if(m_ComponentManager[index] != nullptr)
-						{
-							m_ComponentManager[index]->CreateComponent(componentJson, entity);
-							m_EntityManager->AddComponentType(entity, componentType);
-						}
-					}
-					else
-					{
-						std::ostringstream oss;
-						oss << "[Error] No type specified for component with json content: " << componentJson;
-						Log::GetInstance()->Error(oss.str());
-					}
-				}
-			}
-			else
+			entitiesLeft = LoadSceneEntities(batch, lastEntity);
+		}
+		batch = json::array();
+	};
+	const auto loadHeader = [&]()
+	{
+		LoadSceneHeader(headerJson, *sceneInfo);
+		headerLoaded = true;
+		for (auto& deferredBatch : deferredBatches)
+		{
+			loadEntitiesBatch(deferredBatch);
+		}
+		deferredBatches.clear();
+	};
+	//Only one pass over the file, the entities are moved out of the document as soon as they are parsed and created by batch
+	const auto sceneJsonPtr = LoadJson(scenePath, [&](int depth, json::parse_event_t event, json& parsed)
+	{
+		if (depth == 1 && event == json::parse_event_t::key)
+		{
+			rootKey = parsed.get<std::string>();
+			return rootKey == "entities" || rootKey == "name" || rootKey == "systems";
+		}
+		if (depth == 1 && event == json::parse_event_t::value && rootKey == "name")
+		{
+			headerJson["name"] = parsed;
+		}
+		if (depth == 1 && event == json::parse_event_t::array_end && rootKey == "systems" && !headerLoaded)
+		{
+			headerJson["systems"] = parsed;
+			loadHeader();
+		}
+		if (depth == 1 && event == json::parse_event_t::array_start && rootKey == "entities")
+		{
+			hasEntities = true;
+		}
+		if (depth == 2 && event == json::parse_event_t::object_end && rootKey == "entities")
+		{
+			entitiesBatch.push_back(std::move(parsed));
+			if (entitiesBatch.size() == sceneStreamBatchSize)
 			{
-				std::ostringstream oss;
-				oss << "[Error] No components attached in the JSON entity: " << entity << "with json content: " << entityJson;
-				Log::GetInstance()->Error(oss.str());
+				loadEntitiesBatch(entitiesBatch);
 			}
+			return false;
 		}
+		return true;
+	});
+	if (sceneJsonPtr == nullptr)
+	{
+		Log::GetInstance()->Error("Invalid JSON format for scene");
+		m_Engine.Clear();
+		return;
 	}
-	else
+	if (!entitiesBatch.empty())
+	{
+		loadEntitiesBatch(entitiesBatch);
+	}
+	//Without systems the whole entities array waited for the end of the file
+	if (!headerLoaded)
+	{
+		loadHeader();
+	}
+	else if (CheckJsonParameter(headerJson, "name", json::value_t::string))
+	{
+		//The name may follow the systems
+		sceneInfo->name = headerJson["name"].get<std::string>();
+	}
+	if (!hasEntities)
 	{
 		std::ostringstream oss;
 		oss << "No Entities in " << sceneInfo->name;
 		Log::GetInstance()->Error(oss.str());
 	}
 
-	//remove previous scene assets
-
-	m_Engine.Collect();
-
-	auto* editor = m_Engine.GetEditor();
-	editor->SetCurrentScene(std::move(sceneInfo));
-	
-	auto* pythonEngine = m_Engine.GetPythonEngine();
-	pythonEngine->InitScriptsInstances();
-
-	InitScenePySystems();
-	
-	
-}
-
-std::list<std::string> SceneManager::GetAllScenes()
-{
-	std::list<std::string> scenes;
-	std::for_each(m_ScenePathMap.begin(),m_ScenePathMap.end(), [&](const std::pair<const std::string, std::string>& ref) {
-		scenes.push_back(ref.first);
-	});
-	return scenes;
+	FinishSceneLoad(std::move(sceneInfo));
 }
 
-
-void SceneManager::LoadSceneFromName(const std::string& sceneName)
+bool SceneManager::LoadSceneEntities(json& entitiesJson, Entity& lastEntity)
 {
-	if (m_ScenePathMap.find(sceneName) != m_ScenePathMap.end())
+	rmt_ScopedCPUSample(LoadSceneEntities,0);
+	sf::Clock entitiesClock;
+	bool entitiesLeft = true;
+	if (auto* config = m_Engine.GetConfig())
 	{
-
-		sf::Clock loadingClock;
-		m_Engine.Clear();
-		LoadSceneFromPath(m_ScenePathMap[sceneName]);
+		const auto entityNmb = lastEntity + entitiesJson.size();
+		if(entityNmb > config->currentEntitiesNmb)
 		{
-			sf::Time loadingTime = loadingClock.getElapsedTime();
-			std::ostringstream oss;
-			oss << "Scene Loading Time: " << loadingTime.asSeconds();
-			Log::GetInstance()->Msg(oss.str());
+			m_EntityManager->ResizeEntityNmb(entityNmb);
 		}
 	}
-	else
+	//First allocate all the entities and sort the components json by type
+	std::vector<std::vector<std::pair<json*, Entity>>> componentsJsonByType(m_ComponentManager.size());
+	for(auto& entityJson : entitiesJson)
 	{
-		std::ostringstream oss;
-		oss << "[ERROR] No scene is named: " << sceneName <<"\n";
-		oss << "Here are the list of scenes:\n";
-		for(auto& sceneNamePair : m_ScenePathMap)
+		const Entity entity = m_EntityManager->CreateEntity(lastEntity + 1);
+		if(entity == INVALID_ENTITY)
 		{
-			oss << "- " << sceneNamePair.first << "\n";
+			std::ostringstream oss;
+			oss << "[Error] Scene: not enough entities left";
+			Log::GetInstance()->Error(oss.str());
+			entitiesLeft = false;
+			break;
+		}
+		lastEntity = entity;
+		if(CheckJsonExists(entityJson, "name"))
+		{
+			m_EntityManager->GetEntityInfo(entity).name = entityJson["name"].get<std::string>();
+		}
+		else
+		{
+			std::ostringstream oss;
+			oss << "Entity " << entity;
+			m_EntityManager->GetEntityInfo(entity).name = oss.str();
+		}
+		if (CheckJsonExists(entityJson, "components"))
+		{
+			
+			for (auto& componentJson : entityJson["components"])
+			{
+				if (CheckJsonNumber(componentJson, "type"))
+				{
+					const int componentType = componentJson["type"];
+					const auto index = componentType > 0 ? static_cast<size_t>(log2(static_cast<double>(componentType))) : m_ComponentManager.size();
+					if(index < m_ComponentManager.size() && m_ComponentManager[index] != nullptr)
+					{
+						componentsJsonByType[index].emplace_back(&componentJson, entity);
+					}
+				}
+				else
+				{
+					std::ostringstream oss;
+					oss << "[Error] No type specified for component with json content: " << componentJson;
+					Log::GetInstance()->Error(oss.str());
+				}
+			}
+		}
+		else
+		{
+			std::ostringstream oss;
+			oss << "[Error] No components attached in the JSON entity: " << entity << "with json content: " << entityJson;
+			Log::GetInstance()->Error(oss.str());
 		}
-		Log::GetInstance()->Error(oss.str());
 	}
+	m_LoadStats.entitiesTime += entitiesClock.getElapsedTime().asSeconds();
+	CreateComponentsByStage(componentsJsonByType);
+	return entitiesLeft;
 }
-void SceneManager::AddComponentManager(IComponentFactory *componentFactory, ComponentType componentType)
-{
-	const auto index = static_cast<int>(log2((double)componentType));
-	m_ComponentManager[index] = componentFactory;
-}
-void SceneManager::OnUpdate(float dt)
+
+bool SceneManager::CookScene(const std::string& scenePath)
 {
-	rmt_ScopedCPUSample(PySceneSystemUpdate,0);
-	for(auto* pySystem: m_ScenePySystems)
+	xxh::hash64_t sourceHash = 0;
+	if (!AssetManager::HashFile(scenePath, sourceHash))
 	{
-		pySystem->OnUpdate(dt);
+		std::ostringstream oss;
+		oss << "[Error] Could not read scene to cook: " << scenePath;
+		Log::GetInstance()->Error(oss.str());
+		return false;
 	}
-}
-void SceneManager::OnFixedUpdate()
-{
-	rmt_ScopedCPUSample(PySceneSystemFixedUpdate,0);
-	for(auto* pySystem: m_ScenePySystems)
+	const auto sceneJsonPtr = LoadJson(scenePath);
+	if (sceneJsonPtr == nullptr)
 	{
-		pySystem->OnFixedUpdate();
+		return false;
 	}
+	SceneCooker sceneCooker;
+	return sceneCooker.Cook(*sceneJsonPtr, sourceHash) && sceneCooker.Write(GetCookedScenePath(scenePath));
 }
-void SceneManager::Destroy()
-{
-	m_ScenePySystems.clear();
-}
-void SceneManager::InitScenePySystems()
+
+bool SceneManager::LoadCookedScene(const std::string& scenePath, const std::string& cookedPath, std::uint64_t sourceHash)
 {
-	rmt_ScopedCPUSample(PySceneSystemInit,0);
-	for(auto* pySystem: m_ScenePySystems)
+	CookedSceneView cookedScene;
+	if (!cookedScene.Open(cookedPath, sourceHash))
 	{
-		if(pySystem != nullptr)
-		{
-			pySystem->OnEngineInit();
-		}
+		return false;
 	}
-}
-void SceneManager::OnDraw()
-{
-	rmt_ScopedCPUSample(PySceneSystemDraw,0);
-	for(auto* pySystem: m_ScenePySystems)
+	rmt_ScopedCPUSample(LoadCookedScene,0);
+	m_Engine.Clear();
+	auto sceneInfo = std::make_unique<editor::SceneInfo>();
+	sceneInfo->path = scenePath;
+	const auto& header = cookedScene.GetHeader();
+	const char* sceneName = cookedScene.GetString(header.nameIndex);
+	sceneInfo->name = sceneName != nullptr ? sceneName : "NewScene";
 	{
-		pySystem->OnDraw();
+		std::ostringstream oss;
+		oss << "Loading cooked scene: " << sceneInfo->name;
+		Log::GetInstance()->Msg(oss.str());
 	}
-}
+
+	size_t count = 0;
+	const auto* systems = cookedScene.GetSection<CookedSystem>(CookedSectionType::SYSTEMS, count);
+	for (size_t i = 0; i < count; i++)
+	{
+		if (const char* scriptPath = cookedScene.GetString(systems[i].scriptPathIndex))
+		{
+			LoadScenePySystem(scriptPath);
+		}
+		if (const char* className = cookedScene.GetString(systems[i].classNameIndex))
+		{
+			LoadSceneCppSystem(className);
+		}
+	}
+
+	const size_t entityNmb = header.entityCount;
+	if (auto* config = m_Engine.GetConfig())
+	{
+		//ResizeEntityNmb also shrinks, the arrays of a bigger previous scene are kept like in LoadSceneEntities
+		if (entityNmb > config->currentEntitiesNmb)
+		{
+			m_EntityManager->ResizeEntityNmb(entityNmb);
+		}
+	}
+	//Entities keep their index of the json, so the records can point directly to them
+	std::vector<Entity> entities(entityNmb, INVALID_ENTITY);
+	const auto* entityNames = cookedScene.GetSection<std::uint32_t>(CookedSectionType::ENTITY_NAMES, count);
+	for (size_t i = 0; i < entityNmb; i++)
+	{
+		const Entity entity = m_EntityManager->CreateEntity(static_cast<Entity>(i + 1));
+		entities[i] = entity;
+		if (entity == INVALID_ENTITY)
+			continue;
+		const char* entityName = i < count ? cookedScene.GetString(entityNames[i]) : nullptr;
+		if (entityName != nullptr)
+		{
+			m_EntityManager->GetEntityInfo(entity).name = entityName;
+		}
+		else
+		{
+			std::ostringstream oss;
+			oss << "Entity " << entity;
+			m_EntityManager->GetEntityInfo(entity).name = oss.str();
+		}
+	}
+	const auto getEntity = [&entities](std::uint32_t entityIndex)
+	{
+		return entityIndex < entities.size() ? entities[entityIndex] : INVALID_ENTITY;
+	};
+
+	auto* transformManager = m_Engine.GetTransform2dManager();
+	const auto* transforms = cookedScene.GetSection<CookedTransform2d>(CookedSectionType::TRANSFORM2D, count);
+	for (size_t i = 0; i < count; i++)
+	{
+		const Entity entity = getEntity(transforms[i].entityIndex);
+		if (entity != INVALID_ENTITY)
+			transformManager->CreateComponent(transforms[i].def, entity);
+	}
+
+	auto* graphicsManager = m_Engine.GetGraphics2dManager();
+	auto* spriteManager = graphicsManager->GetSpriteManager();
+	const auto* sprites = cookedScene.GetSection<CookedSprite>(CookedSectionType::SPRITE2D, count);
+	for (size_t i = 0; i < count; i++)
+	{
+		const Entity entity = getEntity(sprites[i].entityIndex);
+		if (entity == INVALID_ENTITY)
+			continue;
+		SpriteDef def;
+		const char* path = cookedScene.GetString(sprites[i].pathIndex);
+		def.path = path != nullptr ? path : "";
+		def.hasLayer = sprites[i].hasLayer != 0U;
+		def.layer = sprites[i].layer;
+		spriteManager->CreateComponent(def, entity);
+		m_EntityManager->AddComponentType(entity, ComponentType::SPRITE2D);
+	}
+
+	auto* shapeManager = graphicsManager->GetShapeManager();
+	const auto* shapes = cookedScene.GetSection<CookedShape>(CookedSectionType::SHAPE2D, count);
+	for (size_t i = 0; i < count; i++)
+	{
+		const Entity entity = getEntity(shapes[i].entityIndex);
+		if (entity == INVALID_ENTITY)
+			continue;
+		shapeManager->CreateComponent(shapes[i].def, entity);
+		m_EntityManager->AddComponentType(entity, ComponentType::SHAPE2D);
+	}
+
+	auto* soundManager = m_Engine.GetAudioManager()->GetSoundManager();
+	const auto* sounds = cookedScene.GetSection<CookedSound>(CookedSectionType::SOUND, count);
+	for (size_t i = 0; i < count; i++)
+	{
+		const Entity entity = getEntity(sounds[i].entityIndex);
+		const char* path = cookedScene.GetString(sounds[i].pathIndex);
+		if (entity == INVALID_ENTITY || path == nullptr)
+			continue;
+		soundManager->CreateComponent(path, entity);
+		m_EntityManager->AddComponentType(entity, ComponentType::SOUND);
+	}
+
+	auto* animationManager = graphicsManager->GetAnimation2dManager();
+	const auto* animations = cookedScene.GetSection<CookedAnimation2d>(CookedSectionType::ANIMATION2D, count);
+	for (size_t i = 0; i < count; i++)
+	{
+		const Entity entity = getEntity(animations[i].entityIndex);
+		if (entity == INVALID_ENTITY)
+			continue;
+		Animation2dDef def;
+		const char* path = cookedScene.GetString(animations[i].pathIndex);
+		def.path = path != nullptr ? path : "";
+		def.speed = animations[i].speed;
+		animationManager->CreateComponent(def, entity);
+	}
+
+	auto* bodyManager = m_Engine.GetPhysicsManager()->GetBodyManager();
+	const auto* bodies = cookedScene.GetSection<CookedBody2d>(CookedSectionType::BODY2D, count);
+	for (size_t i = 0; i < count; i++)
+	{
+		const Entity entity = getEntity(bodies[i].entityIndex);
+		if (entity == INVALID_ENTITY)
+			continue;
+		bodyManager->CreateComponent(bodies[i].def, entity);
+		m_EntityManager->AddComponentType(entity, ComponentType::BODY2D);
+	}
+
+	auto* colliderManager = m_Engine.GetPhysicsManager()->GetColliderManager();
+	const auto* colliders = cookedScene.GetSection<CookedCollider>(CookedSectionType::COLLIDER2D, count);
+	for (size_t i = 0; i < count; i++)
+	{
+		const Entity entity = getEntity(colliders[i].entityIndex);
+		if (entity == INVALID_ENTITY)
+			continue;
+		colliderManager->CreateComponent(colliders[i].def, entity);
+		m_EntityManager->AddComponentType(entity, ComponentType::COLLIDER2D);
+	}
+
+	FinishSceneLoad(std::move(sceneInfo));
+	return true;
+}
+
+void SceneManager::LoadScenePySystem(const std::string& scriptPath)
+{
+	m_SceneSystemsJson.push_back({ { "script_path", scriptPath } });
+	auto* pythonEngine = m_Engine.GetPythonEngine();
+	const ModuleId moduleId = pythonEngine->LoadPyModule(scriptPath);
+	if (moduleId != INVALID_MODULE)
+	{
+		const InstanceId instanceId = pythonEngine->GetPySystemManager().LoadPySystem(moduleId);
+		PySystem* pySystem = pythonEngine->GetPySystemManager().GetPySystemFromInstanceId(instanceId);
+		if(pySystem != nullptr)
+		{
+			m_ScenePySystems.push_back(pySystem);
+		}
+		else
+		{
+			Log::GetInstance()->Error("[Python Error] Returned PySystem is null");
+		}
+	}
+	else
+	{
+		std::ostringstream oss;
+		oss << "Could not load PySystem at "<<scriptPath;
+		Log::GetInstance()->Error(oss.str());
+	}
+}
+
+void SceneManager::LoadSceneCppSystem(const std::string& systemClassName)
+{
+	m_SceneSystemsJson.push_back({ { "systemClassName", systemClassName } });
+	//The registered C++ systems are created without going through the Python interpreter
+	auto* systemRegistry = m_Engine.GetSystemRegistry();
+	if (systemRegistry != nullptr && systemRegistry->HasSystem(systemClassName))
+	{
+		auto system = systemRegistry->CreateSystem(systemClassName, m_Engine);
+		if (system != nullptr)
+		{
+			m_SceneNativeSystems.push_back({ systemClassName, std::move(system) });
+		}
+		return;
+	}
+	auto* pythonEngine = m_Engine.GetPythonEngine();
+	auto instanceId = pythonEngine->GetPySystemManager().LoadCppExtensionSystem(systemClassName);
+	if(instanceId != INVALID_INSTANCE)
+	{
+		PySystem* pySystem = pythonEngine->GetPySystemManager().GetPySystemFromInstanceId(instanceId);
+		if(pySystem != nullptr)
+		{
+			m_ScenePySystems.push_back(pySystem);
+		}
+	}
+}
+
+void SceneManager::CreateComponentsByStage(std::vector<std::vector<std::pair<json*, Entity>>>& componentsJsonByType)
+{
+	std::vector<bool> createdTypes(componentsJsonByType.size(), false);
+	const auto createComponents = [this, &componentsJsonByType](size_t index)
+	{
+		sf::Clock componentClock;
+		auto* componentManager = m_ComponentManager[index];
+		const auto componentType = static_cast<ComponentType>(1 << index);
+		for (auto& componentJson : componentsJsonByType[index])
+		{
+			componentManager->CreateComponent(*componentJson.first, componentJson.second);
+			m_EntityManager->AddComponentType(componentJson.second, componentType);
+		}
+		m_LoadStats.componentCounts[index] += componentsJsonByType[index].size();
+		m_LoadStats.componentTimes[index] += componentClock.getElapsedTime().asSeconds();
+	};
+	const auto getIndex = [](ComponentType componentType)
+	{
+		return static_cast<size_t>(log2(static_cast<double>(componentType)));
+	};
+
+	auto& threadPool = m_Engine.GetThreadPool();
+	for (auto& stage : sceneLoadStages)
+	{
+		rmt_ScopedCPUSample(LoadSceneStage,0);
+		std::vector<std::future<void>> stageTasks;
+		//The stage only sees the component bits of the previous stages
+		m_EntityManager->DeferComponentTypes();
+		for (auto componentType : stage.poolTypes)
+		{
+			const auto index = getIndex(componentType);
+			createdTypes[index] = true;
+			if (componentsJsonByType[index].empty())
+				continue;
+			if (threadPool.size() == 0)
+			{
+				createComponents(index);
+			}
+			else
+			{
+				stageTasks.push_back(threadPool.push([&createComponents, index](int)
+				{
+					createComponents(index);
+				}));
+			}
+		}
+		for (auto componentType : stage.mainThreadTypes)
+		{
+			const auto index = getIndex(componentType);
+			createdTypes[index] = true;
+			if (!componentsJsonByType[index].empty())
+			{
+				createComponents(index);
+			}
+		}
+		for (auto& stageTask : stageTasks)
+		{
+			stageTask.get();
+		}
+		m_EntityManager->ApplyDeferredComponentTypes();
+	}
+	//Types without a known dependency are created last, one after the other
+	for (size_t index = 0; index < componentsJsonByType.size(); index++)
+	{
+		if (!createdTypes[index] && !componentsJsonByType[index].empty())
+		{
+			createComponents(index);
+		}
+	}
+
+	std::ostringstream oss;
+	oss << "Scene entities allocation: " << m_LoadStats.entitiesTime * 1000.0f << " ms";
+	for (size_t index = 0; index < componentsJsonByType.size(); index++)
+	{
+		if (m_LoadStats.componentCounts[index] > 0)
+		{
+			oss << "\n- component type " << (1 << index) << ": " << m_LoadStats.componentCounts[index]
+				<< " components in " << m_LoadStats.componentTimes[index] * 1000.0f << " ms";
+		}
+	}
+	Log::GetInstance()->Msg(oss.str());
+}
+
+const SceneLoadStats& SceneManager::GetLoadStats() const
+{
+	return m_LoadStats;
+}
+
+void SceneManager::FinishSceneLoad(std::unique_ptr<editor::SceneInfo> sceneInfo)
+{
+	//remove previous scene assets
+
+	m_Engine.Collect();
+
+	m_SceneName = sceneInfo->name;
+	m_ScenePath = sceneInfo->path;
+	m_SceneSourceHash = 0;
+	m_SnapshotHashes.clear();
+	auto* editor = m_Engine.GetEditor();
+	editor->SetCurrentScene(std::move(sceneInfo));
+	
+	auto* pythonEngine = m_Engine.GetPythonEngine();
+	pythonEngine->InitScriptsInstances();
+
+	InitScenePySystems();
+}
+
+json SceneManager::SerializeScene()
+{
+	std::vector<std::uint64_t> snapshotHashes;
+	return SerializeLiveScene(snapshotHashes);
+}
+
+json SceneManager::SerializeLiveScene(std::vector<std::uint64_t>& snapshotHashes)
+{
+	rmt_ScopedCPUSample(SerializeScene,0);
+	const size_t snapshotStride = m_ComponentManager.size() + 1;
+	const auto* config = m_Engine.GetConfig();
+	const size_t entityNmb = config != nullptr ? config->currentEntitiesNmb : INIT_ENTITY_NMB;
+	snapshotHashes.assign(entityNmb * snapshotStride, 0U);
+
+	json sceneJson;
+	sceneJson["name"] = m_SceneName;
+	sceneJson["systems"] = m_SceneSystemsJson;
+	sceneJson["entities"] = json::array();
+	BeginSerialization();
+	size_t emptyEntities = 0;
+	for (Entity entity = 1U; entity <= entityNmb; entity++)
+	{
+		if (m_EntityManager->GetMask(entity) == 0)
+		{
+			emptyEntities++;
+			continue;
+		}
+		//The gaps are only written before a live entity, the scene loading gives the ids in order
+		for (; emptyEntities > 0; emptyEntities--)
+		{
+			sceneJson["entities"].push_back({ { "components", json::array() } });
+		}
+		auto* entityHashes = &snapshotHashes[(entity - 1) * snapshotStride];
+		json entityJson;
+		entityJson["name"] = m_EntityManager->GetEntityInfo(entity).name;
+		entityHashes[m_ComponentManager.size()] = HashSnapshotJson(entityJson["name"]);
+		entityJson["components"] = json::array();
+		for (size_t typeIndex = 0; typeIndex < m_ComponentManager.size(); typeIndex++)
+		{
+			auto componentsJson = SerializeEntityComponents(entity, typeIndex);
+			entityHashes[typeIndex] = HashSnapshotJson(componentsJson);
+			for (auto& componentJson : componentsJson)
+			{
+				entityJson["components"].push_back(std::move(componentJson));
+			}
+		}
+		sceneJson["entities"].push_back(std::move(entityJson));
+	}
+	EndSerialization();
+	return sceneJson;
+}
+
+void SceneManager::BeginSerialization()
+{
+	for (auto* componentManager : m_ComponentManager)
+	{
+		if (componentManager != nullptr)
+			componentManager->BeginSerialization();
+	}
+}
+
+void SceneManager::EndSerialization()
+{
+	for (auto* componentManager : m_ComponentManager)
+	{
+		if (componentManager != nullptr)
+			componentManager->EndSerialization();
+	}
+}
+
+json SceneManager::SerializeEntityComponents(Entity entity, size_t typeIndex)
+{
+	json componentsJson = json::array();
+	auto* componentManager = m_ComponentManager[typeIndex];
+	if (componentManager != nullptr && (m_EntityManager->GetMask(entity) & (1 << typeIndex)) != 0)
+	{
+		componentManager->SerializeComponents(entity, componentsJson);
+	}
+	return componentsJson;
+}
+
+bool SceneManager::SaveScene(const std::string& scenePath, SceneSaveFormat format)
+{
+	sf::Clock savingClock;
+	std::vector<std::uint64_t> snapshotHashes;
+	const json sceneJson = SerializeLiveScene(snapshotHashes);
+	switch (format)
+	{
+	case SceneSaveFormat::JSON:
+	{
+		std::ofstream sceneFile(scenePath, std::ios::trunc);
+		if (!sceneFile)
+		{
+			std::ostringstream oss;
+			oss << "[Error] Could not write the scene: " << scenePath;
+			Log::GetInstance()->Error(oss.str());
+			return false;
+		}
+		const std::string sceneText = DumpSceneJson(sceneJson, 4);
+		sceneFile << sceneText;
+		//Saving the current scene does not trigger its hot reload
+		if (scenePath == m_ScenePath)
+		{
+			m_SceneSourceHash = xxh::xxhash<64>(sceneText);
+		}
+		break;
+	}
+	case SceneSaveFormat::BINARY:
+	{
+		SceneCooker sceneCooker;
+		if (!sceneCooker.Cook(sceneJson, 0U) || !sceneCooker.Write(scenePath))
+		{
+			std::ostringstream oss;
+			oss << "[Error] Could not write the binary scene: " << scenePath;
+			Log::GetInstance()->Error(oss.str());
+			return false;
+		}
+		break;
+	}
+	}
+	m_SnapshotHashes = std::move(snapshotHashes);
+	{
+		std::ostringstream oss;
+		oss << "Scene Saving Time: " << savingClock.getElapsedTime().asSeconds();
+		Log::GetInstance()->Msg(oss.str());
+	}
+	return true;
+}
+
+bool SceneManager::SaveSceneDelta(const std::string& deltaPath)
+{
+	rmt_ScopedCPUSample(SaveSceneDelta,0);
+	const size_t snapshotStride = m_ComponentManager.size() + 1;
+	const auto* config = m_Engine.GetConfig();
+	const size_t entityNmb = config != nullptr ? config->currentEntitiesNmb : INIT_ENTITY_NMB;
+	std::vector<std::uint64_t> snapshotHashes(entityNmb * snapshotStride, 0U);
+	const auto getPreviousHash = [this](size_t hashIndex)
+	{
+		return hashIndex < m_SnapshotHashes.size() ? m_SnapshotHashes[hashIndex] : 0U;
+	};
+
+	json deltaJson;
+	deltaJson["delta"] = true;
+	deltaJson["name"] = m_SceneName;
+	deltaJson["entities"] = json::array();
+	deltaJson["destroyed"] = json::array();
+	BeginSerialization();
+	for (Entity entity = 1U; entity <= entityNmb; entity++)
+	{
+		const size_t firstHashIndex = (entity - 1) * snapshotStride;
+		if (m_EntityManager->GetMask(entity) == 0)
+		{
+			for (size_t slot = 0; slot < snapshotStride; slot++)
+			{
+				if (getPreviousHash(firstHashIndex + slot) != 0U)
+				{
+					deltaJson["destroyed"].push_back(entity);
+					break;
+				}
+			}
+			continue;
+		}
+		auto* entityHashes = &snapshotHashes[firstHashIndex];
+		bool hasChanged = false;
+		json entityJson;
+		entityJson["entity"] = entity;
+		const json nameJson = m_EntityManager->GetEntityInfo(entity).name;
+		entityHashes[m_ComponentManager.size()] = HashSnapshotJson(nameJson);
+		if (entityHashes[m_ComponentManager.size()] != getPreviousHash(firstHashIndex + m_ComponentManager.size()))
+		{
+			entityJson["name"] = nameJson;
+			hasChanged = true;
+		}
+		entityJson["components"] = json::array();
+		entityJson["removed"] = json::array();
+		for (size_t typeIndex = 0; typeIndex < m_ComponentManager.size(); typeIndex++)
+		{
+			auto componentsJson = SerializeEntityComponents(entity, typeIndex);
+			entityHashes[typeIndex] = HashSnapshotJson(componentsJson);
+			if (entityHashes[typeIndex] == getPreviousHash(firstHashIndex + typeIndex))
+				continue;
+			hasChanged = true;
+			if (componentsJson.empty())
+			{
+				entityJson["removed"].push_back(1 << typeIndex);
+			}
+			for (auto& componentJson : componentsJson)
+			{
+				entityJson["components"].push_back(std::move(componentJson));
+			}
+		}
+		if (hasChanged)
+		{
+			deltaJson["entities"].push_back(std::move(entityJson));
+		}
+	}
+	EndSerialization();
+
+	std::ofstream deltaFile(deltaPath, std::ios::trunc);
+	if (!deltaFile)
+	{
+		std::ostringstream oss;
+		oss << "[Error] Could not write the scene delta: " << deltaPath;
+		Log::GetInstance()->Error(oss.str());
+		return false;
+	}
+	deltaFile << deltaJson;
+	m_SnapshotHashes = std::move(snapshotHashes);
+	return true;
+}
+
+void SceneManager::MergeSceneDelta(json& sceneJson, const json& deltaJson)
+{
+	if (!CheckJsonParameter(sceneJson, "entities", json::value_t::array))
+	{
+		sceneJson["entities"] = json::array();
+	}
+	auto& entitiesJson = sceneJson["entities"];
+	const auto getEntityJson = [&entitiesJson](Entity entity) -> json&
+	{
+		while (entitiesJson.size() < entity)
+		{
+			entitiesJson.push_back({ { "components", json::array() } });
+		}
+		return entitiesJson[entity - 1];
+	};
+	if (CheckJsonParameter(deltaJson, "destroyed", json::value_t::array))
+	{
+		for (auto& entityId : deltaJson["destroyed"])
+		{
+			getEntityJson(entityId.get<Entity>()) = { { "components", json::array() } };
+		}
+	}
+	if (!CheckJsonParameter(deltaJson, "entities", json::value_t::array))
+		return;
+	for (auto& entityDeltaJson : deltaJson["entities"])
+	{
+		if (!CheckJsonNumber(entityDeltaJson, "entity"))
+			continue;
+		auto& entityJson = getEntityJson(entityDeltaJson["entity"].get<Entity>());
+		if (CheckJsonParameter(entityDeltaJson, "name", json::value_t::string))
+		{
+			entityJson["name"] = entityDeltaJson["name"];
+		}
+		//The types of the delta replace all the components of the same type
+		int replacedTypes = 0;
+		if (CheckJsonParameter(entityDeltaJson, "removed", json::value_t::array))
+		{
+			for (auto& componentType : entityDeltaJson["removed"])
+			{
+				replacedTypes |= componentType.get<int>();
+			}
+		}
+		const bool hasComponents = CheckJsonParameter(entityDeltaJson, "components", json::value_t::array);
+		if (hasComponents)
+		{
+			for (auto& componentJson : entityDeltaJson["components"])
+			{
+				if (CheckJsonNumber(componentJson, "type"))
+				{
+					replacedTypes |= componentJson["type"].get<int>();
+				}
+			}
+		}
+		json componentsJson = json::array();
+		if (CheckJsonParameter(entityJson, "components", json::value_t::array))
+		{
+			for (auto& componentJson : entityJson["components"])
+			{
+				if (!CheckJsonNumber(componentJson, "type") || (componentJson["type"].get<int>() & replacedTypes) == 0)
+				{
+					componentsJson.push_back(std::move(componentJson));
+				}
+			}
+		}
+		if (hasComponents)
+		{
+			for (auto& componentJson : entityDeltaJson["components"])
+			{
+				componentsJson.push_back(componentJson);
+			}
+		}
+		entityJson["components"] = std::move(componentsJson);
+	}
+}
+
+bool SceneManager::LoadSceneSnapshot(const std::string& snapshotPath)
+{
+	if (!LoadCookedScene(snapshotPath, snapshotPath, 0U))
+	{
+		std::ostringstream oss;
+		oss << "[Error] Could not load the binary scene: " << snapshotPath;
+		Log::GetInstance()->Error(oss.str());
+		return false;
+	}
+	return true;
+}
+
+bool SceneManager::ReloadScene(const std::string& scenePath)
+{
+	const std::string::size_type filenameExtensionIndex = scenePath.find_last_of('.');
+	if (filenameExtensionIndex == std::string::npos ||
+		scenePath.compare(filenameExtensionIndex, std::string::npos, ".scene") != 0)
+	{
+		return false;
+	}
+	//The index is validated again at the next scene request
+	m_ScenesSearched = false;
+	xxh::hash64_t sourceHash = 0;
+	if (scenePath == m_ScenePath && AssetManager::HashFile(scenePath, sourceHash) && sourceHash != m_SceneSourceHash)
+	{
+		LoadSceneFromPath(scenePath);
+	}
+	return true;
+}
+
+void SceneManager::ReplacePySystem(PySystem* previousPySystem, PySystem* newPySystem)
+{
+	std::replace(m_ScenePySystems.begin(), m_ScenePySystems.end(), previousPySystem, newPySystem);
+	BuildSystemWaves();
+}
+
+std::list<std::string> SceneManager::GetAllScenes()
+{
+	EnsureScenesSearched();
+	std::list<std::string> scenes;
+	std::for_each(m_ScenePathMap.begin(),m_ScenePathMap.end(), [&](const std::pair<const std::string, std::string>& ref) {
+		scenes.push_back(ref.first);
+	});
+	return scenes;
+}
+
+
+void SceneManager::LoadSceneFromName(const std::string& sceneName)
+{
+	if (DeferSceneLoad([this, sceneName] { LoadSceneFromName(sceneName); }))
+	{
+		return;
+	}
+	EnsureScenesSearched();
+	if (m_ScenePathMap.find(sceneName) != m_ScenePathMap.end())
+	{
+
+		sf::Clock loadingClock;
+		LoadSceneFromPath(m_ScenePathMap[sceneName]);
+		{
+			sf::Time loadingTime = loadingClock.getElapsedTime();
+			std::ostringstream oss;
+			oss << "Scene Loading Time: " << loadingTime.asSeconds();
+			Log::GetInstance()->Msg(oss.str());
+		}
+	}
+	else
+	{
+		std::ostringstream oss;
+		oss << "[ERROR] No scene is named: " << sceneName <<"\n";
+		oss << "Here are the list of scenes:\n";
+		for(auto& sceneNamePair : m_ScenePathMap)
+		{
+			oss << "- " << sceneNamePair.first << "\n";
+		}
+		Log::GetInstance()->Error(oss.str());
+	}
+}
+void SceneManager::PreloadScene(const std::string& sceneName)
+{
+	EnsureScenesSearched();
+	const auto scenePathIt = m_ScenePathMap.find(sceneName);
+	if (scenePathIt == m_ScenePathMap.end())
+	{
+		std::ostringstream oss;
+		oss << "[ERROR] Cannot preload, no scene is named: " << sceneName;
+		Log::GetInstance()->Error(oss.str());
+		return;
+	}
+	if (m_PreloadTask.valid())
+	{
+		m_PreloadTask.wait();
+	}
+	m_PreloadedScene = nullptr;
+	auto preloadedScene = std::make_unique<PreloadedScene>();
+	preloadedScene->name = sceneName;
+	preloadedScene->path = scenePathIt->second;
+
+	//Only the parsing and the decoding are done on the worker, the managers are not touched before the activation
+	const auto preloadFunction = [](std::unique_ptr<PreloadedScene> preloadedScene)
+	{
+		rmt_ScopedCPUSample(PreloadScene,0);
+		preloadedScene->sceneJson = LoadJson(preloadedScene->path);
+		if (preloadedScene->sceneJson == nullptr ||
+			!CheckJsonParameter(*preloadedScene->sceneJson, "entities", json::value_t::array))
+		{
+			return preloadedScene;
+		}
+		std::set<std::string> soundPaths;
+		std::set<std::string> texturePaths;
+		for (auto& entityJson : (*preloadedScene->sceneJson)["entities"])
+		{
+			if (!CheckJsonParameter(entityJson, "components", json::value_t::array))
+				continue;
+			for (auto& componentJson : entityJson["components"])
+			{
+				if (!CheckJsonNumber(componentJson, "type") ||
+					!CheckJsonParameter(componentJson, "path", json::value_t::string))
+					continue;
+				const ComponentType componentType = componentJson["type"];
+				if (componentType == ComponentType::SPRITE2D)
+				{
+					texturePaths.insert(componentJson["path"].get<std::string>());
+				}
+				else if (componentType == ComponentType::SOUND)
+				{
+					soundPaths.insert(componentJson["path"].get<std::string>());
+				}
+			}
+		}
+		preloadedScene->texturePaths.assign(texturePaths.begin(), texturePaths.end());
+		std::vector<char> packedBuffer;
+		for (auto& soundPath : soundPaths)
+		{
+			auto soundBuffer = std::make_unique<sf::SoundBuffer>();
+			const char* packedData = nullptr;
+			size_t packedSize = 0;
+			if (ReadPackedFile(soundPath, packedData, packedSize, packedBuffer) ?
+				soundBuffer->loadFromMemory(packedData, packedSize) : soundBuffer->loadFromFile(soundPath))
+			{
+				preloadedScene->soundBuffers.emplace_back(soundPath, std::move(soundBuffer));
+			}
+		}
+		return preloadedScene;
+	};
+	auto& threadPool = m_Engine.GetThreadPool();
+	if (threadPool.size() == 0)
+	{
+		std::promise<std::unique_ptr<PreloadedScene>> preloadPromise;
+		preloadPromise.set_value(preloadFunction(std::move(preloadedScene)));
+		m_PreloadTask = preloadPromise.get_future();
+	}
+	else
+	{
+		//ctpl copies its tasks, so the unique_ptr is moved through a shared_ptr
+		auto sharedScene = std::make_shared<std::unique_ptr<PreloadedScene>>(std::move(preloadedScene));
+		m_PreloadTask = threadPool.push([preloadFunction, sharedScene](int)
+		{
+			return preloadFunction(std::move(*sharedScene));
+		});
+	}
+}
+
+bool SceneManager::IsScenePreloaded()
+{
+	if (m_PreloadTask.valid() &&
+		m_PreloadTask.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+	{
+		FinishPreload();
+	}
+	return m_PreloadedScene != nullptr;
+}
+
+void SceneManager::FinishPreload()
+{
+	m_PreloadedScene = m_PreloadTask.get();
+	if (m_PreloadedScene->sceneJson == nullptr)
+	{
+		std::ostringstream oss;
+		oss << "[ERROR] Could not preload scene: " << m_PreloadedScene->path;
+		Log::GetInstance()->Error(oss.str());
+		m_PreloadedScene = nullptr;
+		return;
+	}
+	//The textures are decoded by the TextureManager workers, the GL upload stays on this thread
+	auto* textureManager = m_Engine.GetGraphics2dManager()->GetTextureManager();
+	for (auto& texturePath : m_PreloadedScene->texturePaths)
+	{
+		textureManager->PreloadTexture(texturePath);
+	}
+	auto* soundBufferManager = m_Engine.GetAudioManager()->GetSoundBufferManager();
+	for (auto& soundBuffer : m_PreloadedScene->soundBuffers)
+	{
+		soundBufferManager->AddPreloadedSoundBuffer(soundBuffer.first, std::move(soundBuffer.second));
+	}
+	m_PreloadedScene->soundBuffers.clear();
+}
+
+bool SceneManager::ActivateScene()
+{
+	if (DeferSceneLoad([this] { ActivateScene(); }))
+	{
+		return m_PreloadedScene != nullptr || m_PreloadTask.valid();
+	}
+	if (m_PreloadedScene == nullptr && m_PreloadTask.valid())
+	{
+		FinishPreload();
+	}
+	if (m_PreloadedScene == nullptr)
+	{
+		Log::GetInstance()->Error("[ERROR] No preloaded scene to activate");
+		return false;
+	}
+	sf::Clock activationClock;
+	auto preloadedScene = std::move(m_PreloadedScene);
+	auto sceneInfo = std::make_unique<editor::SceneInfo>();
+	sceneInfo->path = preloadedScene->path;
+	LoadSceneFromJson(*preloadedScene->sceneJson, std::move(sceneInfo));
+	{
+		std::ostringstream oss;
+		oss << "Scene Activation Time: " << activationClock.getElapsedTime().asSeconds();
+		Log::GetInstance()->Msg(oss.str());
+	}
+	return true;
+}
+
+void SceneManager::AddComponentManager(IComponentFactory *componentFactory, ComponentType componentType)
+{
+	const auto index = static_cast<int>(log2((double)componentType));
+	m_ComponentManager[index] = componentFactory;
+}
+void SceneManager::OnUpdate(float dt)
+{
+	rmt_ScopedCPUSample(SceneSystemUpdate,0);
+	auto& pySystemManager = m_Engine.GetPythonEngine()->GetPySystemManager();
+	RunSystemWaves(PySystemHook::UPDATE, [dt](System* system) { system->OnUpdate(dt); },
+		[&pySystemManager, dt](const std::vector<PySystem*>& pySystems) { pySystemManager.UpdateSystems(pySystems, dt); });
+}
+void SceneManager::OnFixedUpdate()
+{
+	rmt_ScopedCPUSample(SceneSystemFixedUpdate,0);
+	auto& pySystemManager = m_Engine.GetPythonEngine()->GetPySystemManager();
+	RunSystemWaves(PySystemHook::FIXED_UPDATE, [](System* system) { system->OnFixedUpdate(); },
+		[&pySystemManager](const std::vector<PySystem*>& pySystems) { pySystemManager.FixedUpdateSystems(pySystems); });
+}
+void SceneManager::BuildSystemWaves()
+{
+	m_SystemWaves.clear();
+	std::vector<std::pair<System*, size_t>> placedSystems;
+	const auto placeSystem = [this, &placedSystems](System* system) -> SceneSystemWave&
+	{
+		size_t waveIndex = 0;
+		for (auto& placedSystem : placedSystems)
+		{
+			if (placedSystem.first->ConflictsWith(*system))
+			{
+				waveIndex = std::max(waveIndex, placedSystem.second + 1);
+			}
+		}
+		if (waveIndex == m_SystemWaves.size())
+		{
+			m_SystemWaves.emplace_back();
+		}
+		placedSystems.emplace_back(system, waveIndex);
+		return m_SystemWaves[waveIndex];
+	};
+	for (auto& nativeSystem : m_SceneNativeSystems)
+	{
+		placeSystem(nativeSystem.system.get()).nativeSystems.push_back(nativeSystem.system.get());
+	}
+	m_ScenePyUpdateSystems.clear();
+	m_ScenePyFixedUpdateSystems.clear();
+	m_ScenePyDrawSystems.clear();
+	const auto& pySystemManager = m_Engine.GetPythonEngine()->GetPySystemManager();
+	for (auto* pySystem : m_ScenePySystems)
+	{
+		if (pySystem == nullptr)
+			continue;
+		if (pySystemManager.HasHook(pySystem, PySystemHook::DRAW))
+		{
+			m_ScenePyDrawSystems.push_back(pySystem);
+		}
+		const bool hasUpdate = pySystemManager.HasHook(pySystem, PySystemHook::UPDATE);
+		const bool hasFixedUpdate = pySystemManager.HasHook(pySystem, PySystemHook::FIXED_UPDATE);
+		if (!hasUpdate && !hasFixedUpdate)
+			continue;
+		auto& wave = placeSystem(pySystem);
+		if (hasUpdate)
+		{
+			wave.pyUpdateSystems.push_back(pySystem);
+			m_ScenePyUpdateSystems.push_back(pySystem);
+		}
+		if (hasFixedUpdate)
+		{
+			wave.pyFixedUpdateSystems.push_back(pySystem);
+			m_ScenePyFixedUpdateSystems.push_back(pySystem);
+		}
+	}
+}
+void SceneManager::RunSystemWaves(PySystemHook hook, const std::function<void(System*)>& nativeCall,
+	const std::function<void(const std::vector<PySystem*>&)>& pyCall)
+{
+	m_RunningSystems = true;
+	//Without native systems the PySystems are called in one batch in the scene order
+	if (m_SceneNativeSystems.empty())
+	{
+		pyCall(hook == PySystemHook::UPDATE ? m_ScenePyUpdateSystems : m_ScenePyFixedUpdateSystems);
+		ApplyDeferredSceneLoad();
+		return;
+	}
+	auto& threadPool = m_Engine.GetThreadPool();
+	for (auto& wave : m_SystemWaves)
+	{
+		rmt_ScopedCPUSample(SceneSystemWave,0);
+		const auto& wavePySystems = hook == PySystemHook::UPDATE ? wave.pyUpdateSystems : wave.pyFixedUpdateSystems;
+		//The main thread takes the first native system when it has no PySystem to call
+		size_t mainThreadNativeCount = wavePySystems.empty() ? 1 : 0;
+		if (threadPool.size() == 0)
+		{
+			mainThreadNativeCount = wave.nativeSystems.size();
+		}
+		std::vector<std::future<void>> waveTasks;
+		for (size_t i = mainThreadNativeCount; i < wave.nativeSystems.size(); i++)
+		{
+			auto* system = wave.nativeSystems[i];
+			waveTasks.push_back(threadPool.push([&nativeCall, system](int)
+			{
+				nativeCall(system);
+			}));
+		}
+		if (!wavePySystems.empty())
+		{
+			pyCall(wavePySystems);
+		}
+		for (size_t i = 0; i < mainThreadNativeCount && i < wave.nativeSystems.size(); i++)
+		{
+			nativeCall(wave.nativeSystems[i]);
+		}
+		for (auto& waveTask : waveTasks)
+		{
+			waveTask.get();
+		}
+	}
+	ApplyDeferredSceneLoad();
+}
+bool SceneManager::DeferSceneLoad(std::function<void()> sceneLoad)
+{
+	if (!m_RunningSystems)
+	{
+		return false;
+	}
+	std::lock_guard<std::mutex> lock(m_DeferredSceneLoadMutex);
+	if (m_DeferredSceneLoad)
+	{
+		Log::GetInstance()->Msg("[Warning] A scene load was already requested this frame, the last request is kept");
+	}
+	m_DeferredSceneLoad = std::move(sceneLoad);
+	return true;
+}
+void SceneManager::ApplyDeferredSceneLoad()
+{
+	m_RunningSystems = false;
+	std::function<void()> sceneLoad;
+	{
+		std::lock_guard<std::mutex> lock(m_DeferredSceneLoadMutex);
+		sceneLoad.swap(m_DeferredSceneLoad);
+	}
+	if (sceneLoad)
+	{
+		sceneLoad();
+	}
+}
+void SceneManager::Destroy()
+{
+	for (auto& nativeSystem : m_SceneNativeSystems)
+	{
+		nativeSystem.system->Destroy();
+	}
+	m_SceneNativeSystems.clear();
+	m_SystemWaves.clear();
+	m_ScenePySystems.clear();
+	m_ScenePyUpdateSystems.clear();
+	m_ScenePyFixedUpdateSystems.clear();
+	m_ScenePyDrawSystems.clear();
+	m_SceneSystemsJson = json::array();
+}
+void SceneManager::InitScenePySystems()
+{
+	{
+		rmt_ScopedCPUSample(NativeSceneSystemInit, 0);
+		for (auto& nativeSystem : m_SceneNativeSystems)
+		{
+			nativeSystem.system->OnEngineInit();
+		}
+	}
+	rmt_ScopedCPUSample(PySceneSystemInit,0);
+	m_Engine.GetPythonEngine()->GetPySystemManager().InitSystems(m_ScenePySystems);
+	//The systems can declare their component access up to their init
+	BuildSystemWaves();
+}
+void SceneManager::OnDraw()
+{
+	m_RunningSystems = true;
+	{
+		rmt_ScopedCPUSample(NativeSceneSystemDraw, 0);
+		for (auto& nativeSystem : m_SceneNativeSystems)
+		{
+			nativeSystem.system->OnDraw();
+		}
+	}
+	rmt_ScopedCPUSample(PySceneSystemDraw,0);
+	m_Engine.GetPythonEngine()->GetPySystemManager().DrawSystems(m_ScenePyDrawSystems);
+	ApplyDeferredSceneLoad();
+}
+std::vector<Entity> SceneManager::SpawnEntities(size_t count, const EntitySpawnDef& spawnDef)
+{
+	rmt_ScopedCPUSample(SpawnEntities,0);
+	auto entities = m_EntityManager->CreateEntities(count);
+	const auto hasType = [&spawnDef](ComponentType componentType)
+	{
+		return (spawnDef.archetype & static_cast<int>(componentType)) != 0;
+	};
+	if (hasType(ComponentType::TRANSFORM2D) || hasType(ComponentType::BODY2D))
+	{
+		auto* transformManager = m_Engine.GetTransform2dManager();
+		for (size_t i = 0; i < entities.size(); i++)
+		{
+			Transform2d transformDef;
+			if (spawnDef.positions != nullptr)
+			{
+				transformDef.Position = Vec2f(spawnDef.positions[2 * i], spawnDef.positions[2 * i + 1]);
+			}
+			transformManager->CreateComponent(transformDef, entities[i]);
+		}
+	}
+	if (hasType(ComponentType::BODY2D))
+	{
+		auto* bodyManager = m_Engine.GetPhysicsManager()->GetBodyManager();
+		Body2dDef bodyDef;
+		bodyDef.bodyType = spawnDef.bodyType;
+		size_t bodyIndex = 0;
+		for (; bodyIndex < entities.size() && bodyManager->GetBodyCount() < MAX_BODY_LEN; bodyIndex++)
+		{
+			const Entity entity = entities[bodyIndex];
+			bodyManager->CreateComponent(bodyDef, entity);
+			m_EntityManager->AddComponentType(entity, ComponentType::BODY2D);
+			if (spawnDef.velocities != nullptr)
+			{
+				bodyManager->GetComponentRef(entity).SetLinearVelocity(
+					p2Vec2(spawnDef.velocities[2 * bodyIndex], spawnDef.velocities[2 * bodyIndex + 1]));
+			}
+		}
+		if (bodyIndex < entities.size())
+		{
+			std::ostringstream oss;
+			oss << "[Warning] Spawned entities without Body2d, the world is limited to " << MAX_BODY_LEN << " bodies";
+			Log::GetInstance()->Msg(oss.str());
+		}
+	}
+	if (hasType(ComponentType::SPRITE2D))
+	{
+		SpriteDef spriteDef;
+		spriteDef.path = spawnDef.texturePath;
+		m_Engine.GetGraphics2dManager()->GetSpriteManager()->CreateComponents(spriteDef, entities);
+		for (auto entity : entities)
+		{
+			m_EntityManager->AddComponentType(entity, ComponentType::SPRITE2D);
+		}
+	}
+	return entities;
+}
+
+void SceneManager::ContactNativeSystems(ColliderData* c1, ColliderData* c2, bool enter)
+{
+	for (auto& nativeSystem : m_SceneNativeSystems)
+	{
+		nativeSystem.system->OnContact(c1, c2, enter);
+	}
+}
 
 	void SceneManager::OnBeforeSceneLoad() {
 		Destroy();
@@ -360,4 +1716,13 @@ std::vector<PySystem*>& SceneManager::GetSceneSystems()
 {
 	return m_ScenePySystems;
 }
+
+std::vector<NativeSceneSystem>& SceneManager::GetSceneNativeSystems()
+{
+	return m_SceneNativeSystems;
+}
+const std::vector<SceneSystemWave>& SceneManager::GetSystemWaves() const
+{
+	return m_SystemWaves;
+}
 }
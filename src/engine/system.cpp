@@ -48,4 +48,34 @@ bool System::GetInitlialized() const
 {
 	return m_Initialized;
 }
+
+void System::SetComponentAccess(int readComponents, int writeComponents)
+{
+	m_ReadComponents = readComponents;
+	m_WriteComponents = writeComponents;
+	m_ComponentAccessDeclared = true;
+}
+
+int System::GetReadComponents() const
+{
+	return m_ReadComponents;
+}
+
+int System::GetWriteComponents() const
+{
+	return m_WriteComponents;
+}
+
+bool System::HasComponentAccess() const
+{
+	return m_ComponentAccessDeclared;
+}
+
+bool System::ConflictsWith(const System& system) const
+{
+	if (!m_ComponentAccessDeclared || !system.m_ComponentAccessDeclared)
+		return true;
+	return (m_WriteComponents & (system.m_ReadComponents | system.m_WriteComponents)) != 0 ||
+		(system.m_WriteComponents & m_ReadComponents) != 0;
+}
 }
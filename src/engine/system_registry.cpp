@@ -0,0 +1,66 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <sstream>
+
+#include <engine/system_registry.h>
+#include <utility/log.h>
+
+namespace sfge
+{
+
+bool SystemRegistry::RegisterSystem(const std::string& systemClassName, SystemFactory factory)
+{
+	if (!m_Factories.emplace(systemClassName, std::move(factory)).second)
+	{
+		std::ostringstream oss;
+		oss << "[Error] System class: " << systemClassName << " is already registered";
+		Log::GetInstance()->Error(oss.str());
+		return false;
+	}
+	return true;
+}
+
+bool SystemRegistry::HasSystem(const std::string& systemClassName) const
+{
+	return m_Factories.find(systemClassName) != m_Factories.end();
+}
+
+std::unique_ptr<System> SystemRegistry::CreateSystem(const std::string& systemClassName, Engine& engine) const
+{
+	const auto factoryIt = m_Factories.find(systemClassName);
+	if (factoryIt == m_Factories.end())
+	{
+		return nullptr;
+	}
+	return factoryIt->second(engine);
+}
+
+void SystemRegistry::Clear()
+{
+	m_Factories.clear();
+}
+
+}
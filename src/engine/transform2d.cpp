@@ -37,15 +37,37 @@ Transform2d* Transform2dManager::AddComponent(Entity entity)
 
 void Transform2dManager::CreateComponent(json& componentJson, Entity entity)
 {
+	CreateComponent(GetDefFromJson(componentJson), entity);
+}
 
+void Transform2dManager::CreateComponent(const Transform2d& def, Entity entity)
+{
 	//Log::GetInstance()->Msg("Create component Transform");
 	auto* transform = AddComponent(entity);
+	*transform = def;
+}
+
+Transform2d Transform2dManager::GetDefFromJson(const json& componentJson)
+{
+	Transform2d def;
 	if (CheckJsonExists(componentJson, "position"))
-		transform->Position = GetVectorFromJson(componentJson, "position");
+		def.Position = GetVectorFromJson(componentJson, "position");
 	if (CheckJsonExists(componentJson, "scale"))
-		transform->Scale = GetVectorFromJson(componentJson, "scale");
+		def.Scale = GetVectorFromJson(componentJson, "scale");
 	if (CheckJsonExists(componentJson, "angle") && CheckJsonNumber(componentJson, "angle"))
-		transform->EulerAngle = componentJson["angle"];
+		def.EulerAngle = componentJson["angle"];
+	return def;
+}
+
+void Transform2dManager::SerializeComponents(Entity entity, json& componentsJson)
+{
+	const auto& transform = m_Components[entity - 1];
+	json componentJson;
+	componentJson["type"] = static_cast<int>(ComponentType::TRANSFORM2D);
+	componentJson["position"] = GetJsonFromVector(transform.Position);
+	componentJson["scale"] = GetJsonFromVector(transform.Scale);
+	componentJson["angle"] = transform.EulerAngle;
+	componentsJson.push_back(componentJson);
 }
 
 void Transform2dManager::DestroyComponent(Entity entity)
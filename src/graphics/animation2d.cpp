@@ -0,0 +1,308 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <sstream>
+#include <cmath>
+#include <algorithm>
+
+#include <graphics/animation2d.h>
+#include <graphics/graphics2d.h>
+#include <graphics/sprite2d.h>
+#include <utility/file_utility.h>
+#include <utility/log.h>
+
+#include <imgui.h>
+
+namespace sfge
+{
+
+void editor::Animation2dInfo::DrawOnInspector()
+{
+	ImGui::Separator();
+	ImGui::Text("Animation");
+	if (animationManager == nullptr)
+		return;
+	auto& animation = animationManager->GetComponentRef(m_Entity);
+	if (const auto* clip = animationManager->GetClip(animation.clipId))
+	{
+		ImGui::LabelText("Clip", "%s", clip->name.c_str());
+		ImGui::LabelText("Frame", "%d / %d", animation.currentFrame, static_cast<int>(clip->frames.size()));
+	}
+	ImGui::InputFloat("Speed", &animation.speed);
+}
+
+void Animation2dManager::OnEngineInit()
+{
+	SingleComponentManager::OnEngineInit();
+	auto* graphicsManager = m_Engine.GetGraphics2dManager();
+	m_SpriteManager = graphicsManager->GetSpriteManager();
+	m_TextureManager = graphicsManager->GetTextureManager();
+}
+
+void Animation2dManager::OnUpdate(float dt)
+{
+	rmt_ScopedCPUSample(Animation2dUpdate, 0);
+	const AnimationClip* clips = m_Clips.data();
+	for (auto i = 0u; i < m_Components.size(); i++)
+	{
+		auto& animation = m_Components[i];
+		if (animation.clipId == INVALID_ANIMATION_CLIP ||
+			!m_EntityManager->HasComponent(i + 1, ComponentType::ANIMATION2D))
+			continue;
+
+		const auto& clip = clips[animation.clipId - 1];
+		const int frameCount = static_cast<int>(clip.frames.size());
+		if (frameCount == 0)
+			continue;
+		animation.time += dt * animation.speed;
+		const float clipDuration = clip.frameDuration * frameCount;
+		if (clip.isLooped)
+		{
+			//Keep the time in [0, clipDuration) in both directions, a negative speed plays the clip backward
+			animation.time = std::fmod(animation.time, clipDuration);
+			if (animation.time < 0.0f)
+				animation.time += clipDuration;
+		}
+		else
+		{
+			animation.time = std::max(0.0f, std::min(animation.time, clipDuration));
+		}
+		int frameIndex = static_cast<int>(animation.time / clip.frameDuration);
+		if (clip.isLooped)
+		{
+			frameIndex = ((frameIndex % frameCount) + frameCount) % frameCount;
+		}
+		else
+		{
+			frameIndex = std::max(0, std::min(frameIndex, frameCount - 1));
+		}
+
+		if (frameIndex != animation.currentFrame)
+		{
+			animation.currentFrame = frameIndex;
+			ApplyFrame(i + 1, clip.frames[frameIndex]);
+		}
+	}
+}
+
+void Animation2dManager::OnBeforeSceneLoad()
+{
+	//Clip textures are ref counted by the scene, the next scene loads the clips it needs again
+	m_Clips.clear();
+	m_ClipIds.clear();
+	for (auto& animation : m_Components)
+	{
+		animation = Animation2d();
+	}
+}
+
+Animation2d* Animation2dManager::AddComponent(Entity entity)
+{
+	auto& animation = GetComponentRef(entity);
+	animation = Animation2d();
+	auto& animationInfo = GetComponentInfo(entity);
+	animationInfo.SetEntity(entity);
+	animationInfo.animationManager = this;
+	if (!m_EntityManager->HasComponent(entity, ComponentType::SPRITE2D))
+	{
+		m_SpriteManager->AddComponent(entity);
+	}
+	m_EntityManager->AddComponentType(entity, ComponentType::ANIMATION2D);
+	return &animation;
+}
+
+void Animation2dManager::CreateComponent(json& componentJson, Entity entity)
+{
+	CreateComponent(GetDefFromJson(componentJson), entity);
+}
+
+Animation2dDef Animation2dManager::GetDefFromJson(const json& componentJson)
+{
+	Animation2dDef def;
+	if (CheckJsonNumber(componentJson, "speed"))
+	{
+		def.speed = componentJson["speed"];
+	}
+	if (CheckJsonParameter(componentJson, "path", json::value_t::string))
+	{
+		def.path = componentJson["path"].get<std::string>();
+	}
+	return def;
+}
+
+void Animation2dManager::CreateComponent(const Animation2dDef& def, Entity entity)
+{
+	auto* animation = AddComponent(entity);
+	auto& animationInfo = GetComponentInfo(entity);
+	animationInfo.name = "Animation";
+	animation->speed = def.speed;
+	if (!def.path.empty())
+	{
+		SetClip(entity, LoadClip(def.path));
+	}
+	else
+	{
+		Log::GetInstance()->Error("[Error] No Path for Animation");
+	}
+}
+
+void Animation2dManager::SerializeComponents(Entity entity, json& componentsJson)
+{
+	const auto& animation = m_Components[entity - 1];
+	json componentJson;
+	componentJson["type"] = static_cast<int>(ComponentType::ANIMATION2D);
+	componentJson["speed"] = animation.speed;
+	if (const auto* clip = GetClip(animation.clipId))
+	{
+		componentJson["path"] = clip->path;
+	}
+	componentsJson.push_back(componentJson);
+}
+
+void Animation2dManager::DestroyComponent(Entity entity)
+{
+	GetComponentRef(entity) = Animation2d();
+	m_EntityManager->RemoveComponentType(entity, ComponentType::ANIMATION2D);
+}
+
+AnimationClipId Animation2dManager::LoadClip(const std::string& clipPath)
+{
+	const auto clipIt = m_ClipIds.find(clipPath);
+	if (clipIt != m_ClipIds.end())
+	{
+		return clipIt->second;
+	}
+	auto clipJsonPtr = LoadJson(clipPath);
+	if (clipJsonPtr == nullptr)
+	{
+		std::ostringstream oss;
+		oss << "[Error] Animation file " << clipPath << " cannot be loaded";
+		Log::GetInstance()->Error(oss.str());
+		return INVALID_ANIMATION_CLIP;
+	}
+	auto& clipJson = *clipJsonPtr;
+	AnimationClip clip;
+	clip.path = clipPath;
+	if (CheckJsonParameter(clipJson, "name", json::value_t::string))
+	{
+		clip.name = clipJson["name"].get<std::string>();
+	}
+	if (CheckJsonNumber(clipJson, "speed"))
+	{
+		const float frameDurationMs = clipJson["speed"];
+		clip.frameDuration = frameDurationMs / 1000.0f;
+	}
+	if (CheckJsonExists(clipJson, "isLooped"))
+	{
+		clip.isLooped = clipJson["isLooped"];
+	}
+	//Frame textures are saved next to the json, in a folder named after the clip
+	const auto folderIndex = clipPath.find_last_of("/\\");
+	const std::string clipFolder = folderIndex == std::string::npos ? "" : clipPath.substr(0, folderIndex + 1);
+	if (CheckJsonParameter(clipJson, "frames", json::value_t::array))
+	{
+		std::unordered_map<std::string, TextureId> frameTextures;
+		for (auto& frameJson : clipJson["frames"])
+		{
+			if (!CheckJsonParameter(frameJson, "filename", json::value_t::string))
+				continue;
+			const std::string filename = frameJson["filename"].get<std::string>();
+			auto textureIt = frameTextures.find(filename);
+			if (textureIt == frameTextures.end())
+			{
+				std::string texturePath = clipFolder + clip.name + "/" + filename;
+				if (!FileExists(texturePath))
+				{
+					texturePath = clipFolder + filename;
+				}
+				textureIt = frameTextures.emplace(filename, m_TextureManager->LoadTexture(texturePath, true)).first;
+			}
+			if (textureIt->second == INVALID_TEXTURE)
+			{
+				std::ostringstream oss;
+				oss << "[Error] Texture " << filename << " of animation " << clipPath << " cannot be loaded";
+				Log::GetInstance()->Error(oss.str());
+				return INVALID_ANIMATION_CLIP;
+			}
+			const sf::Vector2f position = GetVectorFromJson(frameJson, "position");
+			const sf::Vector2f size = GetVectorFromJson(frameJson, "size");
+			AnimationFrame frame;
+			frame.textureId = textureIt->second;
+			frame.textureRect = sf::IntRect(
+				static_cast<int>(position.x), static_cast<int>(position.y),
+				static_cast<int>(size.x), static_cast<int>(size.y));
+			clip.frames.push_back(frame);
+		}
+	}
+	if (clip.frames.empty() || clip.frameDuration <= 0.0f)
+	{
+		std::ostringstream oss;
+		oss << "[Error] Animation file " << clipPath << " has no valid frame or speed";
+		Log::GetInstance()->Error(oss.str());
+		return INVALID_ANIMATION_CLIP;
+	}
+	m_Clips.push_back(std::move(clip));
+	const auto clipId = static_cast<AnimationClipId>(m_Clips.size());
+	m_ClipIds[clipPath] = clipId;
+	return clipId;
+}
+
+const AnimationClip* Animation2dManager::GetClip(AnimationClipId clipId) const
+{
+	if (clipId == INVALID_ANIMATION_CLIP || clipId > m_Clips.size())
+		return nullptr;
+	return &m_Clips[clipId - 1];
+}
+
+void Animation2dManager::SetClip(Entity entity, AnimationClipId clipId)
+{
+	auto& animation = GetComponentRef(entity);
+	animation.clipId = clipId;
+	animation.time = 0.0f;
+	animation.currentFrame = -1;
+	if (const auto* clip = GetClip(clipId))
+	{
+		animation.currentFrame = 0;
+		ApplyFrame(entity, clip->frames[0]);
+	}
+}
+
+size_t Animation2dManager::GetClipCount() const
+{
+	return m_Clips.size();
+}
+
+void Animation2dManager::ApplyFrame(Entity entity, const AnimationFrame& frame)
+{
+	auto& sprite = m_SpriteManager->GetComponentRef(entity);
+	auto& spriteInfo = m_SpriteManager->GetComponentInfo(entity);
+	if (spriteInfo.textureId != frame.textureId)
+	{
+		spriteInfo.textureId = frame.textureId;
+		sprite.SetTexture(m_TextureManager->GetTexture(frame.textureId));
+	}
+	sprite.SetTextureRect(frame.textureRect);
+}
+}
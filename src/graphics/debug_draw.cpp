@@ -0,0 +1,268 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <cmath>
+#include <sstream>
+
+#include <graphics/debug_draw.h>
+#include <graphics/render_thread.h>
+#include <utility/log.h>
+
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <Remotery.h>
+
+namespace sfge
+{
+
+void DebugDraw::SetCategoryEnabled(DebugDrawCategory category, bool enable)
+{
+	if (enable)
+		m_EnabledCategories |= static_cast<int>(category);
+	else
+		m_EnabledCategories &= ~static_cast<int>(category);
+}
+
+bool DebugDraw::IsCategoryEnabled(DebugDrawCategory category) const
+{
+	return (m_EnabledCategories & static_cast<int>(category)) != 0;
+}
+
+void DebugDraw::SetEnabledCategories(int categories)
+{
+	m_EnabledCategories = categories;
+}
+
+int DebugDraw::GetEnabledCategories() const
+{
+	return m_EnabledCategories;
+}
+
+void DebugDraw::DrawLine(Vec2f from, Vec2f to, sf::Color color, DebugDrawCategory category)
+{
+	if (!IsCategoryEnabled(category))
+		return;
+	m_LineVertices.emplace_back(from, color);
+	m_LineVertices.emplace_back(to, color);
+}
+
+void DebugDraw::DrawLines(const float* points, size_t pointCount, sf::Color color, DebugDrawCategory category)
+{
+	if (!IsCategoryEnabled(category) || points == nullptr)
+		return;
+	pointCount -= pointCount % 2;
+	const size_t begin = m_LineVertices.size();
+	m_LineVertices.resize(begin + pointCount);
+	for (size_t i = 0; i < pointCount; i++)
+	{
+		m_LineVertices[begin + i] = sf::Vertex(sf::Vector2f(points[2 * i], points[2 * i + 1]), color);
+	}
+}
+
+void DebugDraw::DrawVector(Vec2f drawingVector, Vec2f originPos, sf::Color color, float pixelResolution,
+                           DebugDrawCategory category)
+{
+	if (!IsCategoryEnabled(category))
+		return;
+	const Vec2f destination = originPos + drawingVector * pixelResolution;
+	//Draw length line
+	DrawLine(originPos, destination, color, category);
+	const Vec2f dir = drawingVector.Normalized();
+	const float length = (drawingVector * pixelResolution).GetMagnitude();
+	DrawLine(destination, destination + dir.Rotate(135.0f) * length / 5, color, category);
+	DrawLine(destination, destination + dir.Rotate(-135.0f) * length / 5, color, category);
+}
+
+void DebugDraw::DrawCircle(Vec2f center, float radius, sf::Color color, DebugDrawCategory category)
+{
+	if (!IsCategoryEnabled(category))
+		return;
+	const float angleStep = 2.0f * static_cast<float>(M_PI) / circleSegments;
+	const size_t begin = m_LineVertices.size();
+	m_LineVertices.resize(begin + 2 * circleSegments);
+	sf::Vector2f previous(center.x + radius, center.y);
+	for (size_t i = 1; i <= circleSegments; i++)
+	{
+		const float angle = angleStep * i;
+		const sf::Vector2f current(center.x + radius * std::cos(angle), center.y + radius * std::sin(angle));
+		m_LineVertices[begin + 2 * (i - 1)] = sf::Vertex(previous, color);
+		m_LineVertices[begin + 2 * (i - 1) + 1] = sf::Vertex(current, color);
+		previous = current;
+	}
+}
+
+void DebugDraw::DrawBox(Vec2f center, Vec2f size, float angle, sf::Color color, DebugDrawCategory category)
+{
+	if (!IsCategoryEnabled(category))
+		return;
+	sf::Transform transform;
+	transform.translate(center).rotate(angle);
+	const sf::Vector2f halfSize = sf::Vector2f(size) / 2.0f;
+	const sf::Vector2f corners[4] =
+	{
+		transform.transformPoint(-halfSize.x, -halfSize.y),
+		transform.transformPoint(halfSize.x, -halfSize.y),
+		transform.transformPoint(halfSize.x, halfSize.y),
+		transform.transformPoint(-halfSize.x, halfSize.y)
+	};
+	for (int i = 0; i < 4; i++)
+	{
+		m_LineVertices.emplace_back(corners[i], color);
+		m_LineVertices.emplace_back(corners[(i + 1) % 4], color);
+	}
+}
+
+void DebugDraw::DrawText(Vec2f position, const std::string& text, sf::Color color, DebugDrawCategory category)
+{
+	if (!IsCategoryEnabled(category) || !LoadFont())
+		return;
+	const auto lineSpacing = m_Font.getLineSpacing(textCharacterSize);
+	float x = position.x;
+	float y = position.y + textCharacterSize;
+	for (const char character : text)
+	{
+		if (character == '\n')
+		{
+			x = position.x;
+			y += lineSpacing;
+			continue;
+		}
+		const auto glyphIndex = static_cast<unsigned char>(character);
+		if (!m_LoadedGlyphs[glyphIndex])
+		{
+			//A new glyph is rendered in the page texture, possibly growing it, while the frame in flight may draw it
+			WaitForRenderThread();
+			m_LoadedGlyphs[glyphIndex] = true;
+		}
+		const sf::Glyph& glyph = m_Font.getGlyph(glyphIndex, textCharacterSize, false);
+		const float left = x + glyph.bounds.left;
+		const float top = y + glyph.bounds.top;
+		const float right = left + glyph.bounds.width;
+		const float bottom = top + glyph.bounds.height;
+
+		const auto u1 = static_cast<float>(glyph.textureRect.left);
+		const auto v1 = static_cast<float>(glyph.textureRect.top);
+		const auto u2 = u1 + glyph.textureRect.width;
+		const auto v2 = v1 + glyph.textureRect.height;
+
+		m_TextVertices.emplace_back(sf::Vector2f(left, top), color, sf::Vector2f(u1, v1));
+		m_TextVertices.emplace_back(sf::Vector2f(right, top), color, sf::Vector2f(u2, v1));
+		m_TextVertices.emplace_back(sf::Vector2f(left, bottom), color, sf::Vector2f(u1, v2));
+		m_TextVertices.emplace_back(sf::Vector2f(left, bottom), color, sf::Vector2f(u1, v2));
+		m_TextVertices.emplace_back(sf::Vector2f(right, top), color, sf::Vector2f(u2, v1));
+		m_TextVertices.emplace_back(sf::Vector2f(right, bottom), color, sf::Vector2f(u2, v2));
+
+		x += glyph.advance;
+	}
+}
+
+void DebugDraw::Flush(sf::RenderTarget& target)
+{
+	rmt_ScopedCPUSample(DebugDrawFlush, 0);
+	if (!m_LineVertices.empty())
+	{
+		target.draw(&m_LineVertices[0], m_LineVertices.size(), sf::Lines);
+	}
+	if (!m_TextVertices.empty())
+	{
+		sf::RenderStates renderStates;
+		renderStates.texture = &m_Font.getTexture(textCharacterSize);
+		target.draw(&m_TextVertices[0], m_TextVertices.size(), sf::Triangles, renderStates);
+	}
+	Clear();
+}
+
+void DebugDraw::Flush(RenderCommandList& commandList)
+{
+	rmt_ScopedCPUSample(DebugDrawRecord, 0);
+	if (!m_LineVertices.empty())
+	{
+		commandList.AddVertices(&m_LineVertices[0], m_LineVertices.size(), sf::Lines);
+	}
+	if (!m_TextVertices.empty())
+	{
+		commandList.AddVertices(&m_TextVertices[0], m_TextVertices.size(), sf::Triangles,
+			&m_Font.getTexture(textCharacterSize));
+	}
+	Clear();
+}
+
+void DebugDraw::Clear()
+{
+	//Keep the capacity, the next frame will most likely draw as much
+	m_LineVertices.clear();
+	m_TextVertices.clear();
+}
+
+void DebugDraw::SetFontPath(const std::string& fontPath)
+{
+	if (m_FontLoaded)
+	{
+		//Reloading the font releases the glyph page of the frame in flight
+		WaitForRenderThread();
+	}
+	m_FontPath = fontPath;
+	m_FontLoaded = false;
+	m_FontFailed = false;
+	m_LoadedGlyphs.reset();
+}
+
+void DebugDraw::SetRenderThread(RenderThread* renderThread)
+{
+	m_RenderThread = renderThread;
+}
+
+size_t DebugDraw::GetLineVertexCount() const
+{
+	return m_LineVertices.size();
+}
+
+bool DebugDraw::LoadFont()
+{
+	if (m_FontLoaded)
+		return true;
+	if (m_FontFailed)
+		return false;
+	m_FontLoaded = m_Font.loadFromFile(m_FontPath);
+	if (!m_FontLoaded)
+	{
+		m_FontFailed = true;
+		std::ostringstream oss;
+		oss << "[Error] Debug draw font could not be loaded from: " << m_FontPath;
+		Log::GetInstance()->Error(oss.str());
+	}
+	return m_FontLoaded;
+}
+
+void DebugDraw::WaitForRenderThread()
+{
+	if (m_RenderThread != nullptr)
+	{
+		m_RenderThread->WaitForFrame();
+	}
+}
+
+}
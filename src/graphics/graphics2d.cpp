@@ -23,6 +23,10 @@ SOFTWARE.
 */
 
 #include <sstream>
+#include <mutex>
+
+#include <GL/glew.h>
+
 #include <graphics/graphics2d.h>
 #include <engine/engine.h>
 #include <utility/log.h>
@@ -37,11 +41,27 @@ SOFTWARE.
 namespace sfge
 {
 
+bool InitGlew()
+{
+	static std::once_flag glewFlag;
+	static bool glewInitialized = false;
+	std::call_once(glewFlag, []
+	{
+		glewExperimental = GL_TRUE;
+		glewInitialized = glewInit() == GLEW_OK;
+	});
+	return glewInitialized;
+}
+
 void Graphics2dManager::OnEngineInit()
 {
 	if (const auto configPtr = m_Engine.GetConfig())
 	{
 		m_Windowless = configPtr->windowLess;
+		m_SpriteInstancing = configPtr->instancedSprites;
+		m_SpriteRenderer.SetShaderPaths(
+			configPtr->dataDirname + "shaders/ecs.vert",
+			configPtr->dataDirname + "shaders/ecs.frag");
 		if (!m_Windowless)
 		{
 			sf::ContextSettings settings;
@@ -58,7 +78,12 @@ void Graphics2dManager::OnEngineInit()
 				m_Window->setFramerateLimit(configPtr->maxFramerate);
 				CheckVersion();
 			}
-
+			if (configPtr->renderThread)
+			{
+				m_RenderThread = std::make_unique<RenderThread>(*m_Window);
+				m_RenderThread->SetSpriteRenderer(&m_SpriteRenderer);
+				m_DebugDraw.SetRenderThread(m_RenderThread.get());
+			}
 		}
 	}
 	else
@@ -69,16 +94,41 @@ void Graphics2dManager::OnEngineInit()
 	m_TextureManager.OnEngineInit();
 	m_ShapeManager.OnEngineInit();
 	m_SpriteManager.OnEngineInit();
+	m_AnimationManager.OnEngineInit();
+	if (const auto configPtr = m_Engine.GetConfig())
+	{
+		m_DebugDraw.SetFontPath(configPtr->dataDirname + "font/arial.ttf");
+	}
 
+	if (m_RenderThread)
+	{
+		Log::GetInstance()->Msg("Starting Render Thread");
+		m_RenderThread->Start();
+	}
 }
 
 void Graphics2dManager::OnUpdate(float dt)
 {
+	m_TextureManager.OnUpdate(dt);
+	for (const auto textureId : m_TextureManager.GetReadyTextures())
+	{
+		m_SpriteManager.OnTextureReady(textureId);
+	}
 	if (!m_Windowless)
 	{
 		rmt_ScopedCPUSample(Graphics2dUpdate,0)
-		m_Window->clear();
+		if (m_RenderThread)
+		{
+			m_RenderThread->GetRecordingList().SetClearColor(sf::Color::Black);
+		}
+		else
+		{
+			m_Window->clear();
+		}
 
+		m_AnimationManager.OnUpdate(dt);
+		//Instanced sprites read the transforms directly when drawn, but the sf::Sprite transforms
+		//are still updated for the editor, Python and the non instanced draws of the same sprites
 		m_SpriteManager.OnUpdate(dt);
 		m_ShapeManager.OnUpdate(dt);
 
@@ -91,8 +141,33 @@ void Graphics2dManager::OnDraw()
 	rmt_ScopedCPUSample(Graphics2dDraw,0);
 	if(!m_Windowless)
 	{
-		m_SpriteManager.DrawSprites(*m_Window);
-		m_ShapeManager.DrawShapes(*m_Window);
+		if (m_RenderThread)
+		{
+			auto& commandList = m_RenderThread->GetRecordingList();
+			if (m_SpriteInstancing)
+			{
+				m_SpriteManager.DrawSpriteInstances(commandList);
+			}
+			else
+			{
+				m_SpriteManager.DrawSprites(commandList);
+			}
+			m_ShapeManager.DrawShapes(commandList);
+		}
+		else
+		{
+			if (m_SpriteInstancing)
+			{
+				m_SpriteBatchList.Reset();
+				m_SpriteManager.DrawSpriteInstances(m_SpriteBatchList);
+				m_SpriteBatchList.ExecuteBatches(*m_Window, &m_SpriteRenderer);
+			}
+			else
+			{
+				m_SpriteManager.DrawSprites(*m_Window);
+			}
+			m_ShapeManager.DrawShapes(*m_Window);
+		}
 	}
 }
 
@@ -102,19 +177,95 @@ void Graphics2dManager::Display()
 	rmt_ScopedCPUSample(Graphics2dDisplay,0)
 	if (!m_Windowless)
 	{
-		m_Window->display();
+		if (m_RenderThread)
+		{
+			m_RenderThread->Submit();
+		}
+		else
+		{
+			m_Window->display();
+		}
 	}
 }
 
 void Graphics2dManager::DrawLine(Vec2f from, Vec2f to, sf::Color color)
 {
-	sf::Vertex vertices[2] =
+	m_DebugDraw.DrawLine(from, to, color);
+}
+
+void Graphics2dManager::FlushDebugDraw()
+{
+	if (m_Windowless)
+	{
+		m_DebugDraw.Clear();
+	}
+	else if (m_RenderThread)
 	{
-	    sf::Vertex(from, color),
-	    sf::Vertex(to, color)
-	};
+		m_DebugDraw.Flush(m_RenderThread->GetRecordingList());
+	}
+	else
+	{
+		m_DebugDraw.Flush(*m_Window);
+	}
+}
+
+void Graphics2dManager::DrawVertices(const sf::Vertex* vertices, size_t count, sf::PrimitiveType primitive,
+                                     const sf::Texture* texture)
+{
+	if (m_Windowless)
+		return;
+	if (m_RenderThread)
+	{
+		m_RenderThread->GetRecordingList().AddVertices(vertices, count, primitive, texture);
+	}
+	else
+	{
+		sf::RenderStates renderStates;
+		renderStates.texture = texture;
+		m_Window->draw(vertices, count, primitive, renderStates);
+	}
+}
+
+void Graphics2dManager::DrawSpriteInstances(const SpriteInstance* instances, size_t count, const sf::Texture* texture)
+{
+	if (m_Windowless)
+		return;
+	if (m_RenderThread)
+	{
+		m_RenderThread->GetRecordingList().AddSpriteInstances(instances, count, texture);
+	}
+	else if (!m_SpriteRenderer.Draw(*m_Window, instances, count, texture))
+	{
+		InstancedSpriteRenderer::DrawFallback(*m_Window, instances, count, texture);
+	}
+}
+
+bool Graphics2dManager::IsSpriteInstancingEnabled() const
+{
+	return m_SpriteInstancing;
+}
 
-	m_Window->draw(vertices, 2, sf::Lines);
+void Graphics2dManager::StopRenderThread()
+{
+	if (m_RenderThread)
+	{
+		m_RenderThread->Stop();
+		m_DebugDraw.SetRenderThread(nullptr);
+		m_RenderThread = nullptr;
+	}
+}
+
+void Graphics2dManager::WaitForRenderThread()
+{
+	if (m_RenderThread)
+	{
+		m_RenderThread->WaitForFrame();
+	}
+}
+
+RenderCommandList* Graphics2dManager::GetRenderCommandList()
+{
+	return m_RenderThread ? &m_RenderThread->GetRecordingList() : nullptr;
 }
 
 sf::RenderWindow* Graphics2dManager::GetWindow()
@@ -127,11 +278,21 @@ SpriteManager* Graphics2dManager::GetSpriteManager()
 	return &m_SpriteManager;
 }
 
+Animation2dManager* Graphics2dManager::GetAnimation2dManager()
+{
+	return &m_AnimationManager;
+}
+
 TextureManager* Graphics2dManager::GetTextureManager()
 {
 	return &m_TextureManager;
 }
 
+DebugDraw* Graphics2dManager::GetDebugDraw()
+{
+	return &m_DebugDraw;
+}
+
 ShapeManager* Graphics2dManager::GetShapeManager()
 {
 	return &m_ShapeManager;
@@ -152,6 +313,11 @@ void Graphics2dManager::Destroy()
 	OnBeforeSceneLoad();
 	OnAfterSceneLoad();
 
+	StopRenderThread();
+	if (m_Window)
+	{
+		m_SpriteRenderer.Release();
+	}
 	m_Window = nullptr;
 }
 
@@ -159,6 +325,7 @@ void Graphics2dManager::OnBeforeSceneLoad()
 {
 	m_TextureManager.OnBeforeSceneLoad();
 	m_SpriteManager.OnBeforeSceneLoad();
+	m_AnimationManager.OnBeforeSceneLoad();
 }
 
 void Graphics2dManager::OnAfterSceneLoad()
@@ -170,15 +337,7 @@ void Graphics2dManager::OnAfterSceneLoad()
 
 void Graphics2dManager::DrawVector(Vec2f drawingVector, Vec2f originPos, sf::Color color)
 {
-
-    const Vec2f destination = originPos+drawingVector*debugVectorPixelResolution;
-    //Draw length line
-    DrawLine(originPos, destination, color);
-    const Vec2f dir = drawingVector.Normalized();
-    const float length = (drawingVector*debugVectorPixelResolution).GetMagnitude();
-    DrawLine(destination, destination+dir.Rotate(135.0f)*length/5,color);
-    DrawLine(destination, destination+dir.Rotate(-135.0f)*length/5,color);
-
+	m_DebugDraw.DrawVector(drawingVector, originPos, color, debugVectorPixelResolution);
 }
 
 }
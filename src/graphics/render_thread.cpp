@@ -0,0 +1,360 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <cstddef>
+
+#include <graphics/render_thread.h>
+
+#include <imgui.h>
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/OpenGL.hpp>
+#include <Remotery.h>
+
+namespace sfge
+{
+
+RenderCommandList::~RenderCommandList()
+{
+	ClearImGuiDrawLists();
+}
+
+void RenderCommandList::Reset()
+{
+	m_Vertices.clear();
+	m_Batches.clear();
+	m_SpriteInstances.clear();
+	ClearImGuiDrawLists();
+}
+
+void RenderCommandList::SetClearColor(sf::Color clearColor)
+{
+	m_ClearColor = clearColor;
+}
+
+void RenderCommandList::AddVertices(const sf::Vertex* vertices, size_t count, sf::PrimitiveType primitive,
+                                    const sf::Texture* texture)
+{
+	if (vertices == nullptr || count == 0)
+		return;
+	//Strips and fans cannot be concatenated, only list primitives are merged
+	const bool mergeable = primitive == sf::Points || primitive == sf::Lines ||
+		primitive == sf::Triangles || primitive == sf::Quads;
+	if (mergeable && !m_Batches.empty() && !m_Batches.back().instanced &&
+		m_Batches.back().primitive == primitive &&
+		m_Batches.back().texture == texture)
+	{
+		m_Batches.back().count += count;
+	}
+	else
+	{
+		RenderBatch batch;
+		batch.primitive = primitive;
+		batch.texture = texture;
+		batch.start = m_Vertices.size();
+		batch.count = count;
+		m_Batches.push_back(batch);
+	}
+	m_Vertices.insert(m_Vertices.end(), vertices, vertices + count);
+}
+
+void RenderCommandList::AddQuad(const sf::Vertex* quad, const sf::Texture* texture)
+{
+	const sf::Vertex triangles[6] =
+	{
+		quad[0], quad[1], quad[2],
+		quad[2], quad[1], quad[3]
+	};
+	AddVertices(triangles, 6, sf::Triangles, texture);
+}
+
+void RenderCommandList::AddSpriteInstances(const SpriteInstance* instances, size_t count, const sf::Texture* texture)
+{
+	if (instances == nullptr || count == 0)
+		return;
+	if (!m_Batches.empty() && m_Batches.back().instanced && m_Batches.back().texture == texture)
+	{
+		m_Batches.back().count += count;
+	}
+	else
+	{
+		RenderBatch batch;
+		batch.instanced = true;
+		batch.texture = texture;
+		batch.start = m_SpriteInstances.size();
+		batch.count = count;
+		m_Batches.push_back(batch);
+	}
+	m_SpriteInstances.insert(m_SpriteInstances.end(), instances, instances + count);
+}
+
+void RenderCommandList::SetImGuiDrawData(ImDrawData* drawData)
+{
+	ClearImGuiDrawLists();
+	if (drawData == nullptr || !drawData->Valid)
+		return;
+	m_ImGuiDrawLists.reserve(static_cast<size_t>(drawData->CmdListsCount));
+	for (int i = 0; i < drawData->CmdListsCount; i++)
+	{
+		m_ImGuiDrawLists.push_back(drawData->CmdLists[i]->CloneOutput());
+	}
+	const ImGuiIO& io = ImGui::GetIO();
+	m_ImGuiDisplaySize[0] = io.DisplaySize.x;
+	m_ImGuiDisplaySize[1] = io.DisplaySize.y;
+	m_ImGuiFramebufferScale[0] = io.DisplayFramebufferScale.x;
+	m_ImGuiFramebufferScale[1] = io.DisplayFramebufferScale.y;
+}
+
+void RenderCommandList::Execute(sf::RenderTarget& target, InstancedSpriteRenderer* spriteRenderer) const
+{
+	rmt_ScopedCPUSample(RenderCommandListExecute, 0);
+	target.clear(m_ClearColor);
+	ExecuteBatches(target, spriteRenderer);
+	if (!m_ImGuiDrawLists.empty())
+	{
+		target.resetGLStates();
+		ExecuteImGui(target);
+	}
+}
+
+void RenderCommandList::ExecuteBatches(sf::RenderTarget& target, InstancedSpriteRenderer* spriteRenderer) const
+{
+	for (auto& batch : m_Batches)
+	{
+		if (batch.instanced)
+		{
+			const SpriteInstance* instances = &m_SpriteInstances[batch.start];
+			if (spriteRenderer == nullptr || !spriteRenderer->Draw(target, instances, batch.count, batch.texture))
+			{
+				InstancedSpriteRenderer::DrawFallback(target, instances, batch.count, batch.texture);
+			}
+		}
+		else
+		{
+			sf::RenderStates states;
+			states.texture = batch.texture;
+			target.draw(&m_Vertices[batch.start], batch.count, batch.primitive, states);
+		}
+	}
+}
+
+size_t RenderCommandList::GetBatchCount() const
+{
+	return m_Batches.size();
+}
+
+size_t RenderCommandList::GetVertexCount() const
+{
+	return m_Vertices.size();
+}
+
+const std::vector<RenderBatch>& RenderCommandList::GetBatches() const
+{
+	return m_Batches;
+}
+
+void RenderCommandList::ClearImGuiDrawLists()
+{
+	for (auto* drawList : m_ImGuiDrawLists)
+	{
+		IM_DELETE(drawList);
+	}
+	m_ImGuiDrawLists.clear();
+}
+
+/**
+ * \brief Same fixed pipeline routine as imgui-SFML RenderDrawLists, but reading the cloned draw lists
+ */
+void RenderCommandList::ExecuteImGui(sf::RenderTarget& target) const
+{
+	(void) target;
+	const int fbWidth = static_cast<int>(m_ImGuiDisplaySize[0] * m_ImGuiFramebufferScale[0]);
+	const int fbHeight = static_cast<int>(m_ImGuiDisplaySize[1] * m_ImGuiFramebufferScale[1]);
+	if (fbWidth == 0 || fbHeight == 0)
+		return;
+
+	glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_TRANSFORM_BIT);
+
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glDisable(GL_CULL_FACE);
+	glDisable(GL_DEPTH_TEST);
+	glEnable(GL_SCISSOR_TEST);
+	glEnable(GL_TEXTURE_2D);
+	glDisable(GL_LIGHTING);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_COLOR_ARRAY);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+
+	glViewport(0, 0, static_cast<GLsizei>(fbWidth), static_cast<GLsizei>(fbHeight));
+
+	glMatrixMode(GL_TEXTURE);
+	glLoadIdentity();
+
+	glMatrixMode(GL_PROJECTION);
+	glLoadIdentity();
+	glOrtho(0.0f, m_ImGuiDisplaySize[0], m_ImGuiDisplaySize[1], 0.0f, -1.0f, +1.0f);
+
+	glMatrixMode(GL_MODELVIEW);
+	glLoadIdentity();
+
+	for (const auto* cmdList : m_ImGuiDrawLists)
+	{
+		if (cmdList->VtxBuffer.empty() || cmdList->IdxBuffer.empty())
+			continue;
+		const auto* vtxBuffer = reinterpret_cast<const unsigned char*>(&cmdList->VtxBuffer.front());
+		const ImDrawIdx* idxBuffer = &cmdList->IdxBuffer.front();
+
+		glVertexPointer(2, GL_FLOAT, sizeof(ImDrawVert), vtxBuffer + offsetof(ImDrawVert, pos));
+		glTexCoordPointer(2, GL_FLOAT, sizeof(ImDrawVert), vtxBuffer + offsetof(ImDrawVert, uv));
+		glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(ImDrawVert), vtxBuffer + offsetof(ImDrawVert, col));
+
+		for (int cmdIndex = 0; cmdIndex < cmdList->CmdBuffer.size(); ++cmdIndex)
+		{
+			const ImDrawCmd* cmd = &cmdList->CmdBuffer[cmdIndex];
+			//User callbacks point into the simulation thread state and are not replayed
+			if (cmd->UserCallback == nullptr)
+			{
+				const auto textureId = static_cast<GLuint>(reinterpret_cast<std::size_t>(cmd->TextureId));
+				glBindTexture(GL_TEXTURE_2D, textureId);
+				const float clipX = cmd->ClipRect.x * m_ImGuiFramebufferScale[0];
+				const float clipY = cmd->ClipRect.y * m_ImGuiFramebufferScale[1];
+				const float clipZ = cmd->ClipRect.z * m_ImGuiFramebufferScale[0];
+				const float clipW = cmd->ClipRect.w * m_ImGuiFramebufferScale[1];
+				glScissor(static_cast<int>(clipX), static_cast<int>(fbHeight - clipW),
+					static_cast<int>(clipZ - clipX), static_cast<int>(clipW - clipY));
+				glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(cmd->ElemCount), GL_UNSIGNED_SHORT, idxBuffer);
+			}
+			idxBuffer += cmd->ElemCount;
+		}
+	}
+	glPopAttrib();
+}
+
+RenderThread::RenderThread(sf::RenderWindow& window) : m_Window(window)
+{
+}
+
+RenderThread::~RenderThread()
+{
+	Stop();
+}
+
+void RenderThread::Start()
+{
+	if (m_Running)
+		return;
+	m_Running = true;
+	m_FrameSubmitted = false;
+	//The GL context can only be active in one thread at a time
+	m_Window.setActive(false);
+	m_Thread = std::thread(&RenderThread::Loop, this);
+}
+
+void RenderThread::Stop()
+{
+	if (!m_Thread.joinable())
+		return;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Running = false;
+	}
+	m_Condition.notify_all();
+	m_Thread.join();
+	m_Window.setActive(true);
+}
+
+RenderCommandList& RenderThread::GetRecordingList()
+{
+	return m_CommandLists[m_RecordingIndex];
+}
+
+void RenderThread::Submit()
+{
+	rmt_ScopedCPUSample(RenderThreadSubmit, 0);
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		//The other list is only free once the render thread displayed it
+		m_Condition.wait(lock, [this] { return !m_FrameSubmitted || !m_Running; });
+		if (!m_Running)
+			return;
+		m_SubmittedIndex = m_RecordingIndex;
+		m_RecordingIndex = 1 - m_RecordingIndex;
+		m_FrameSubmitted = true;
+	}
+	m_Condition.notify_all();
+	m_CommandLists[m_RecordingIndex].Reset();
+}
+
+void RenderThread::WaitForFrame()
+{
+	rmt_ScopedCPUSample(RenderThreadWaitForFrame, 0);
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_Condition.wait(lock, [this] { return !m_FrameSubmitted || !m_Running; });
+}
+
+bool RenderThread::IsRunning() const
+{
+	return m_Running;
+}
+
+void RenderThread::SetSpriteRenderer(InstancedSpriteRenderer* spriteRenderer)
+{
+	m_SpriteRenderer = spriteRenderer;
+}
+
+void RenderThread::Loop()
+{
+	m_Window.setActive(true);
+	while (true)
+	{
+		size_t submittedIndex;
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Condition.wait(lock, [this] { return m_FrameSubmitted || !m_Running; });
+			if (!m_Running)
+				break;
+			submittedIndex = m_SubmittedIndex;
+		}
+		{
+			rmt_ScopedCPUSample(RenderThreadFrame, 0);
+			m_CommandLists[submittedIndex].Execute(m_Window, m_SpriteRenderer);
+			m_Window.display();
+		}
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_FrameSubmitted = false;
+		}
+		m_Condition.notify_all();
+	}
+	//Vertex array objects are not shared between contexts, they must be deleted here
+	if (m_SpriteRenderer != nullptr)
+	{
+		m_SpriteRenderer->Release();
+	}
+	m_Window.setActive(false);
+}
+
+}
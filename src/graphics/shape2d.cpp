@@ -22,8 +22,11 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#include <cmath>
+
 #include <graphics/graphics2d.h>
 #include <graphics/shape2d.h>
+#include <graphics/render_thread.h>
 #include <utility/json_utility.h>
 #include <utility/log.h>
 #include <engine/transform2d.h>
@@ -57,6 +60,89 @@ void Shape::Draw(sf::RenderWindow& window) const
 	}
 }
 
+void Shape::Draw(RenderCommandList& commandList) const
+{
+	if (m_Shape == nullptr)
+		return;
+	const size_t pointCount = m_Shape->getPointCount();
+	if (pointCount < 3)
+		return;
+	const sf::Transform& shapeTransform = m_Shape->getTransform();
+	const sf::Color color = m_Shape->getFillColor();
+	const sf::Vector2f firstPoint = shapeTransform.transformPoint(m_Shape->getPoint(0));
+	sf::Vector2f previousPoint = shapeTransform.transformPoint(m_Shape->getPoint(1));
+	//Circles and rectangles are convex, so the fill is a fan around the first point
+	for (size_t i = 2; i < pointCount; i++)
+	{
+		const sf::Vector2f point = shapeTransform.transformPoint(m_Shape->getPoint(i));
+		const sf::Vertex triangle[3] =
+		{
+			sf::Vertex(firstPoint, color),
+			sf::Vertex(previousPoint, color),
+			sf::Vertex(point, color)
+		};
+		commandList.AddVertices(triangle, 3, sf::Triangles);
+		previousPoint = point;
+	}
+	DrawOutline(commandList);
+}
+
+void Shape::DrawOutline(RenderCommandList& commandList) const
+{
+	const float thickness = m_Shape->getOutlineThickness();
+	if (thickness == 0.0f)
+		return;
+	const size_t pointCount = m_Shape->getPointCount();
+	sf::Vector2f center;
+	for (size_t i = 0; i < pointCount; i++)
+	{
+		center += m_Shape->getPoint(i);
+	}
+	center /= static_cast<float>(pointCount);
+	const auto computeNormal = [&center](sf::Vector2f p1, sf::Vector2f p2)
+	{
+		sf::Vector2f normal(p1.y - p2.y, p2.x - p1.x);
+		const float length = std::sqrt(normal.x * normal.x + normal.y * normal.y);
+		if (length != 0.0f)
+			normal /= length;
+		//Toward the outside of the shape
+		if (normal.x * (center.x - p1.x) + normal.y * (center.y - p1.y) > 0.0f)
+			normal = -normal;
+		return normal;
+	};
+	//Same extrusion as sf::Shape::updateOutline, an inner and an outer point per shape point
+	std::vector<sf::Vector2f> innerPoints(pointCount);
+	std::vector<sf::Vector2f> outerPoints(pointCount);
+	const sf::Transform& shapeTransform = m_Shape->getTransform();
+	for (size_t i = 0; i < pointCount; i++)
+	{
+		const sf::Vector2f p0 = m_Shape->getPoint(i == 0 ? pointCount - 1 : i - 1);
+		const sf::Vector2f p1 = m_Shape->getPoint(i);
+		const sf::Vector2f p2 = m_Shape->getPoint((i + 1) % pointCount);
+		const sf::Vector2f n1 = computeNormal(p0, p1);
+		const sf::Vector2f n2 = computeNormal(p1, p2);
+		const float factor = 1.0f + (n1.x * n2.x + n1.y * n2.y);
+		const sf::Vector2f normal = factor != 0.0f ? (n1 + n2) / factor : n1;
+		innerPoints[i] = shapeTransform.transformPoint(p1);
+		outerPoints[i] = shapeTransform.transformPoint(p1 + normal * thickness);
+	}
+	const sf::Color color = m_Shape->getOutlineColor();
+	for (size_t i = 0; i < pointCount; i++)
+	{
+		const size_t next = (i + 1) % pointCount;
+		const sf::Vertex quad[6] =
+		{
+			sf::Vertex(innerPoints[i], color),
+			sf::Vertex(outerPoints[i], color),
+			sf::Vertex(innerPoints[next], color),
+			sf::Vertex(innerPoints[next], color),
+			sf::Vertex(outerPoints[i], color),
+			sf::Vertex(outerPoints[next], color)
+		};
+		commandList.AddVertices(quad, 6, sf::Triangles);
+	}
+}
+
 void Shape::SetFillColor(sf::Color color) const
 {
 	if (m_Shape)
@@ -136,6 +222,18 @@ void ShapeManager::DrawShapes(sf::RenderWindow &window)
 	}
 }
 
+void ShapeManager::DrawShapes(RenderCommandList& commandList)
+{
+	rmt_ScopedCPUSample(ShapeRecord,0)
+	for(auto i = 0u; i < m_Components.size(); i++)
+	{
+		if(m_EntityManager->HasComponent(i + 1, ComponentType::SHAPE2D))
+		{
+			m_Components[i].Draw(commandList);
+		}
+	}
+}
+
 void ShapeManager::OnUpdate(const float dt)
 {
 
@@ -178,74 +276,96 @@ Shape *ShapeManager::AddComponent (Entity entity)
 
 void ShapeManager::CreateComponent(json& componentJson, Entity entity)
 {
-	//Log::GetInstance()->Msg("Create component Shape");
-	sf::Vector2f offset;
+	if (!CheckJsonNumber(componentJson, "shape_type"))
+	{
+		std::ostringstream oss;
+		oss << "[Error] No shape_type defined in json:  "<<componentJson;
+		Log::GetInstance()->Error(oss.str());
+	}
+	CreateComponent(GetDefFromJson(componentJson), entity);
+}
+
+ShapeDef ShapeManager::GetDefFromJson(const json& componentJson)
+{
+	ShapeDef def;
 	if (CheckJsonExists(componentJson, "offset"))
 	{
-		offset = GetVectorFromJson(componentJson, "offset");
+		def.offset = GetVectorFromJson(componentJson, "offset");
+	}
+	if (CheckJsonNumber(componentJson, "shape_type"))
+	{
+		def.shapeType = componentJson["shape_type"];
 	}
+	if (CheckJsonNumber(componentJson, "radius"))
+	{
+		def.radius = componentJson["radius"];
+	}
+	if (CheckJsonExists(componentJson, "size"))
+	{
+		def.size = GetVectorFromJson(componentJson, "size");
+	}
+	return def;
+}
+
+void ShapeManager::SerializeComponents(Entity entity, json& componentsJson)
+{
+	auto& shape = m_Components[entity - 1];
+	json componentJson;
+	componentJson["type"] = static_cast<int>(ComponentType::SHAPE2D);
+	componentJson["offset"] = GetJsonFromVector(shape.GetOffset());
+	if (auto* circleShape = dynamic_cast<sf::CircleShape*>(shape.GetShape()))
+	{
+		componentJson["shape_type"] = static_cast<int>(ShapeType::CIRCLE);
+		componentJson["radius"] = circleShape->getRadius();
+	}
+	else if (auto* rectangleShape = dynamic_cast<sf::RectangleShape*>(shape.GetShape()))
+	{
+		componentJson["shape_type"] = static_cast<int>(ShapeType::RECTANGLE);
+		componentJson["size"] = GetJsonFromVector(rectangleShape->getSize());
+	}
+	else
+	{
+		componentJson["shape_type"] = static_cast<int>(ShapeType::NONE);
+	}
+	componentsJson.push_back(componentJson);
+}
 
+void ShapeManager::CreateComponent(const ShapeDef& def, Entity entity)
+{
+	//Log::GetInstance()->Msg("Create component Shape");
 	auto& shape = m_Components[entity-1];
-	shape.SetOffset(offset);
+	shape.SetOffset(def.offset);
 
 	auto& shapeInfo = m_ComponentsInfo[entity - 1];
 	shapeInfo.shapeManager = this;
 	shapeInfo.SetEntity(entity);
 
-	if (CheckJsonNumber(componentJson, "shape_type"))
+	switch (def.shapeType)
 	{
-		const ShapeType shapeType = componentJson["shape_type"];
-		switch (shapeType)
-		{
-		case ShapeType::CIRCLE:
-		{
-
-			float radius = 10.0f;
-			if (CheckJsonNumber(componentJson, "radius"))
-			{
-				radius = componentJson["radius"];
-			}
-
-			auto circleShape = std::make_unique <sf::CircleShape>();
-			circleShape->setRadius (radius);
-			circleShape->setOrigin (radius, radius);
-			shape.SetShape (std::move(circleShape));
-			shape.Update ();
-		}
-			break;
-		case ShapeType::RECTANGLE:
-		{
-			sf::Vector2f offset;
-			if (CheckJsonExists(componentJson, "offset"))
-			{
-				offset = GetVectorFromJson(componentJson, "offset");
-			}
-			sf::Vector2f size = sf::Vector2f();
-			if (CheckJsonExists(componentJson, "size"))
-			{
-				size = GetVectorFromJson(componentJson, "size");
-			}
-			auto rect = std::make_unique<sf::RectangleShape>();
-			rect->setSize (size);
-			rect->setOrigin (size.x/2.0f, size.y/2.0f);
-            shape.SetShape (std::move (rect));
-            shape.Update ();
-			
-		}
-			break;
-		default:
-			Log::GetInstance()->Error("Invalid shape type in ShapeManager Component Creation");
-			break;
-		}
+	case ShapeType::NONE:
+		break;
+	case ShapeType::CIRCLE:
+	{
+		auto circleShape = std::make_unique <sf::CircleShape>();
+		circleShape->setRadius (def.radius);
+		circleShape->setOrigin (def.radius, def.radius);
+		shape.SetShape (std::move(circleShape));
+		shape.Update ();
 	}
-	else
+		break;
+	case ShapeType::RECTANGLE:
 	{
-		std::ostringstream oss;
-		oss << "[Error] No shape_type defined in json:  "<<componentJson;
-		Log::GetInstance()->Error(oss.str());
+		auto rect = std::make_unique<sf::RectangleShape>();
+		rect->setSize (def.size);
+		rect->setOrigin (def.size.x/2.0f, def.size.y/2.0f);
+		shape.SetShape (std::move (rect));
+		shape.Update ();
+	}
+		break;
+	default:
+		Log::GetInstance()->Error("Invalid shape type in ShapeManager Component Creation");
+		break;
 	}
-	
-	
 }
 
 void ShapeManager::DestroyComponent(Entity entity)
@@ -25,6 +25,8 @@ SOFTWARE.
 #include <graphics/graphics2d.h>
 #include <graphics/sprite2d.h>
 #include <graphics/texture.h>
+#include <graphics/render_thread.h>
+#include <graphics/sprite_instancing.h>
 #include <utility/file_utility.h>
 
 #include <utility/log.h>
@@ -49,13 +51,62 @@ void Sprite::Draw(sf::RenderWindow& window)
 {
 	window.draw(sprite);
 }
-void Sprite::SetTexture(sf::Texture* newTexture)
+
+void Sprite::Draw(RenderCommandList& commandList) const
 {
-	sprite.setTexture(*newTexture);
+	const sf::Texture* texture = sprite.getTexture();
+	if (texture == nullptr)
+		return;
+	const sf::FloatRect bounds = sprite.getLocalBounds();
+	const sf::IntRect textureRect = sprite.getTextureRect();
+	const sf::Transform& spriteTransform = sprite.getTransform();
+	const sf::Color color = sprite.getColor();
+
+	const auto left = static_cast<float>(textureRect.left);
+	const auto right = left + textureRect.width;
+	const auto top = static_cast<float>(textureRect.top);
+	const auto bottom = top + textureRect.height;
+	//Same vertex layout as sf::Sprite
+	const sf::Vertex quad[4] =
+	{
+		sf::Vertex(spriteTransform.transformPoint(0.0f, 0.0f), color, sf::Vector2f(left, top)),
+		sf::Vertex(spriteTransform.transformPoint(0.0f, bounds.height), color, sf::Vector2f(left, bottom)),
+		sf::Vertex(spriteTransform.transformPoint(bounds.width, 0.0f), color, sf::Vector2f(right, top)),
+		sf::Vertex(spriteTransform.transformPoint(bounds.width, bounds.height), color, sf::Vector2f(right, bottom))
+	};
+	commandList.AddQuad(quad, texture);
+}
+void Sprite::SetTexture(sf::Texture* newTexture, bool resetRect)
+{
+	sprite.setTexture(*newTexture, resetRect);
 
 	sprite.setOrigin(sf::Vector2f(sprite.getLocalBounds().width, sprite.getLocalBounds().height) / 2.0f);
 }
 
+bool Sprite::FillInstance(const Transform2d& spriteTransform, SpriteInstance& instance) const
+{
+	const sf::Texture* texture = sprite.getTexture();
+	if (texture == nullptr)
+		return false;
+	instance.position = spriteTransform.Position + m_Offset;
+	instance.scale = spriteTransform.Scale;
+	instance.rotation = spriteTransform.EulerAngle;
+	instance.SetColor(sprite.getColor());
+	instance.SetTextureRect(sprite.getTextureRect(), texture->getSize());
+	return true;
+}
+
+const sf::Texture* Sprite::GetTexture() const
+{
+	return sprite.getTexture();
+}
+
+void Sprite::SetTextureRect(const sf::IntRect& textureRect)
+{
+	sprite.setTextureRect(textureRect);
+	sprite.setOrigin(sf::Vector2f(static_cast<float>(textureRect.width), static_cast<float>(textureRect.height)) / 2.0f);
+}
+
 
 void Sprite::Init()
 {
@@ -141,6 +192,35 @@ void SpriteManager::DrawSprites(sf::RenderWindow &window)
 	
 }
 
+void SpriteManager::DrawSprites(RenderCommandList& commandList)
+{
+	rmt_ScopedCPUSample(SpriteRecord,0)
+	for (auto i = 0u; i < m_Components.size();i++)
+	{
+		if(m_EntityManager->HasComponent(i + 1, ComponentType::SPRITE2D))
+			m_Components[i].Draw(commandList);
+	}
+}
+
+void SpriteManager::DrawSpriteInstances(RenderCommandList& commandList)
+{
+	rmt_ScopedCPUSample(SpriteInstanceRecord,0)
+	SpriteInstance instance;
+	const Transform2d defaultTransform;
+	for (auto i = 0u; i < m_Components.size();i++)
+	{
+		const Entity entity = i + 1;
+		if(!m_EntityManager->HasComponent(entity, ComponentType::SPRITE2D))
+			continue;
+		const auto& spriteTransform = m_EntityManager->HasComponent(entity, ComponentType::TRANSFORM2D) ?
+			m_Transform2dManager->GetComponentRef(entity) : defaultTransform;
+		if(m_Components[i].FillInstance(spriteTransform, instance))
+		{
+			commandList.AddSpriteInstances(&instance, 1, m_Components[i].GetTexture());
+		}
+	}
+}
+
 void SpriteManager::OnBeforeSceneLoad()
 {
 }
@@ -151,18 +231,51 @@ void SpriteManager::OnAfterSceneLoad()
 }
 
 void SpriteManager::CreateComponent(json& componentJson, Entity entity)
+{
+	CreateComponent(GetDefFromJson(componentJson), entity);
+}
+
+SpriteDef SpriteManager::GetDefFromJson(const json& componentJson)
+{
+	SpriteDef def;
+	if (CheckJsonParameter(componentJson, "path", json::value_t::string))
+	{
+		def.path = componentJson["path"].get<std::string>();
+	}
+	if (CheckJsonParameter(componentJson, "layer", json::value_t::number_integer))
+	{
+		def.hasLayer = true;
+		def.layer = componentJson["layer"];
+	}
+	return def;
+}
+
+void SpriteManager::SerializeComponents(Entity entity, json& componentsJson)
+{
+	const auto& spriteInfo = m_ComponentsInfo[entity - 1];
+	json componentJson;
+	componentJson["type"] = static_cast<int>(ComponentType::SPRITE2D);
+	if (!spriteInfo.texturePath.empty())
+	{
+		componentJson["path"] = spriteInfo.texturePath;
+	}
+	componentJson["layer"] = m_Components[entity - 1].GetLayer();
+	componentsJson.push_back(componentJson);
+}
+
+void SpriteManager::CreateComponent(const SpriteDef& def, Entity entity)
 {
 	auto & newSprite = m_Components[entity - 1];
 	auto & newSpriteInfo = m_ComponentsInfo[entity - 1];
-	if (CheckJsonParameter(componentJson, "path", json::value_t::string))
+	if (!def.path.empty())
 	{
-		std::string path = componentJson["path"].get<std::string>();
+		const std::string& path = def.path;
 		newSpriteInfo.texturePath = path;
 		sf::Texture* texture = nullptr;
 		if (FileExists(path))
 		{
 			auto* textureManager = m_GraphicsManager->GetTextureManager();
-			const TextureId textureId = textureManager->LoadTexture(path);
+			const TextureId textureId = textureManager->LoadTexture(path, true);
 			if (textureId != INVALID_TEXTURE)
 			{
 				/*{
@@ -193,18 +306,61 @@ void SpriteManager::CreateComponent(json& componentJson, Entity entity)
 	{
 		Log::GetInstance()->Error("[Error] No Path for Sprite");
 	}
-	if (CheckJsonParameter(componentJson, "layer", json::value_t::number_integer))
+	if (def.hasLayer)
 	{
-		newSprite.SetLayer(componentJson["layer"]);
+		newSprite.SetLayer(def.layer);
 	}
 
 }
 
+void SpriteManager::CreateComponents(const SpriteDef& def, const std::vector<Entity>& entities)
+{
+	auto* textureManager = m_GraphicsManager->GetTextureManager();
+	const TextureId textureId = def.path.empty() ? INVALID_TEXTURE : textureManager->LoadTexture(def.path, true);
+	if (textureId == INVALID_TEXTURE)
+	{
+		std::ostringstream oss;
+		oss << "Texture file " << def.path << " cannot be loaded";
+		Log::GetInstance()->Error(oss.str());
+	}
+	sf::Texture* texture = textureId == INVALID_TEXTURE ? nullptr : textureManager->GetTexture(textureId);
+	for (auto entity : entities)
+	{
+		auto& newSprite = m_Components[entity - 1];
+		auto& newSpriteInfo = m_ComponentsInfo[entity - 1];
+		newSpriteInfo.texturePath = def.path;
+		if (texture != nullptr)
+		{
+			newSprite.SetTexture(texture);
+			newSpriteInfo.textureId = textureId;
+		}
+		if (def.hasLayer)
+		{
+			newSprite.SetLayer(def.layer);
+		}
+	}
+}
+
 void SpriteManager::DestroyComponent(Entity entity)
 {
 	(void) entity;
 }
 
+void SpriteManager::OnTextureReady(TextureId textureId)
+{
+	auto* texture = m_GraphicsManager->GetTextureManager()->GetTexture(textureId);
+	for (auto i = 0u; i < m_Components.size(); i++)
+	{
+		const Entity entity = i + 1;
+		if (m_ComponentsInfo[i].textureId == textureId && m_EntityManager->HasComponent(entity, ComponentType::SPRITE2D))
+		{
+			//Animated sprites already use the rect of their current frame
+			const bool resetRect = !m_EntityManager->HasComponent(entity, ComponentType::ANIMATION2D);
+			m_Components[i].SetTexture(texture, resetRect);
+		}
+	}
+}
+
 void SpriteManager::OnResize(size_t new_size)
 {
 	m_Components.resize(new_size);
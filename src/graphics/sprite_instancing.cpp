@@ -0,0 +1,296 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <GL/glew.h>
+
+#include <sstream>
+#include <algorithm>
+
+#include <graphics/sprite_instancing.h>
+#include <graphics/graphics2d.h>
+#include <utility/file_utility.h>
+#include <utility/log.h>
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <Remotery.h>
+
+namespace sfge
+{
+
+void SpriteInstance::SetColor(const sf::Color& newColor)
+{
+	color[0] = newColor.r;
+	color[1] = newColor.g;
+	color[2] = newColor.b;
+	color[3] = newColor.a;
+}
+
+void SpriteInstance::SetTextureRect(const sf::IntRect& textureRect, sf::Vector2u textureSize)
+{
+	if (textureSize.x == 0 || textureSize.y == 0)
+		return;
+	//SFML flips the sprite with a negative rect size, the uv rect is unsigned so the flip goes in the scale
+	sf::IntRect rect = textureRect;
+	if (rect.width < 0)
+	{
+		rect.left += rect.width;
+		rect.width = -rect.width;
+		scale.x = -scale.x;
+	}
+	if (rect.height < 0)
+	{
+		rect.top += rect.height;
+		rect.height = -rect.height;
+		scale.y = -scale.y;
+	}
+	const auto normalize = [](int value, unsigned size)
+	{
+		const float normalized = static_cast<float>(value) / size * 65535.0f + 0.5f;
+		return static_cast<sf::Uint16>(std::max(0.0f, std::min(normalized, 65535.0f)));
+	};
+	uvRect[0] = normalize(rect.left, textureSize.x);
+	uvRect[1] = normalize(rect.top, textureSize.y);
+	uvRect[2] = normalize(rect.width, textureSize.x);
+	uvRect[3] = normalize(rect.height, textureSize.y);
+}
+
+void InstancedSpriteRenderer::SetShaderPaths(const std::string& vertexShaderPath, const std::string& fragmentShaderPath)
+{
+	m_VertexShaderPath = vertexShaderPath;
+	m_FragmentShaderPath = fragmentShaderPath;
+}
+
+static GLuint CompileShader(GLenum shaderType, const std::string& shaderPath)
+{
+	const std::string source = LoadFile(shaderPath);
+	if (source.empty())
+	{
+		std::ostringstream oss;
+		oss << "[Error] Shader file: " << shaderPath << " could not be loaded";
+		Log::GetInstance()->Error(oss.str());
+		return 0;
+	}
+	const GLuint shader = glCreateShader(shaderType);
+	const char* sourcePtr = source.c_str();
+	glShaderSource(shader, 1, &sourcePtr, nullptr);
+	glCompileShader(shader);
+	GLint success = GL_FALSE;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+	if (success != GL_TRUE)
+	{
+		char infoLog[512];
+		glGetShaderInfoLog(shader, sizeof(infoLog), nullptr, infoLog);
+		std::ostringstream oss;
+		oss << "[Error] Shader compilation failed for: " << shaderPath << "\n" << infoLog;
+		Log::GetInstance()->Error(oss.str());
+		glDeleteShader(shader);
+		return 0;
+	}
+	return shader;
+}
+
+bool InstancedSpriteRenderer::Init()
+{
+	if (m_Initialized)
+		return m_Supported;
+	m_Initialized = true;
+
+	if (!InitGlew() || !GLEW_VERSION_3_3)
+	{
+		Log::GetInstance()->Error("[Error] OpenGL 3.3 is not available, instanced sprites fall back to SFML");
+		return false;
+	}
+	const GLuint vertexShader = CompileShader(GL_VERTEX_SHADER, m_VertexShaderPath);
+	const GLuint fragmentShader = CompileShader(GL_FRAGMENT_SHADER, m_FragmentShaderPath);
+	if (vertexShader == 0 || fragmentShader == 0)
+	{
+		glDeleteShader(vertexShader);
+		glDeleteShader(fragmentShader);
+		return false;
+	}
+	m_Program = glCreateProgram();
+	glAttachShader(m_Program, vertexShader);
+	glAttachShader(m_Program, fragmentShader);
+	glLinkProgram(m_Program);
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+	GLint success = GL_FALSE;
+	glGetProgramiv(m_Program, GL_LINK_STATUS, &success);
+	if (success != GL_TRUE)
+	{
+		char infoLog[512];
+		glGetProgramInfoLog(m_Program, sizeof(infoLog), nullptr, infoLog);
+		std::ostringstream oss;
+		oss << "[Error] Sprite instancing program link failed\n" << infoLog;
+		Log::GetInstance()->Error(oss.str());
+		Release();
+		return false;
+	}
+	m_OrthoViewLocation = glGetUniformLocation(m_Program, "orthoView");
+	m_TextureSizeLocation = glGetUniformLocation(m_Program, "textureSize");
+	m_TextureLocation = glGetUniformLocation(m_Program, "spriteTexture");
+
+	const float quadCorners[8] =
+	{
+		-0.5f, -0.5f,
+		0.5f, -0.5f,
+		-0.5f, 0.5f,
+		0.5f, 0.5f
+	};
+	glGenVertexArrays(1, &m_VertexArray);
+	glBindVertexArray(m_VertexArray);
+
+	glGenBuffers(1, &m_QuadBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, m_QuadBuffer);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(quadCorners), quadCorners, GL_STATIC_DRAW);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
+
+	glGenBuffers(1, &m_InstanceBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, m_InstanceBuffer);
+	const auto stride = static_cast<GLsizei>(sizeof(SpriteInstance));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride,
+		reinterpret_cast<void*>(offsetof(SpriteInstance, position)));
+	glEnableVertexAttribArray(2);
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride,
+		reinterpret_cast<void*>(offsetof(SpriteInstance, scale)));
+	glEnableVertexAttribArray(3);
+	glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, stride,
+		reinterpret_cast<void*>(offsetof(SpriteInstance, rotation)));
+	glEnableVertexAttribArray(4);
+	glVertexAttribPointer(4, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+		reinterpret_cast<void*>(offsetof(SpriteInstance, color)));
+	glEnableVertexAttribArray(5);
+	glVertexAttribPointer(5, 4, GL_UNSIGNED_SHORT, GL_TRUE, stride,
+		reinterpret_cast<void*>(offsetof(SpriteInstance, uvRect)));
+	for (GLuint attribute = 1; attribute <= 5; attribute++)
+	{
+		glVertexAttribDivisor(attribute, 1);
+	}
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	m_Supported = true;
+	Log::GetInstance()->Msg("Instanced sprite renderer initialized");
+	return true;
+}
+
+bool InstancedSpriteRenderer::Draw(sf::RenderTarget& target, const SpriteInstance* instances, size_t count,
+                                   const sf::Texture* texture)
+{
+	if (count == 0 || texture == nullptr)
+		return true;
+	if (!Init())
+		return false;
+	rmt_ScopedCPUSample(InstancedSpriteDraw, 0);
+
+	const sf::View& view = target.getView();
+	const sf::IntRect viewport = target.getViewport(view);
+	const int viewportTop = static_cast<int>(target.getSize().y) - (viewport.top + viewport.height);
+	glViewport(viewport.left, viewportTop, viewport.width, viewport.height);
+
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	glUseProgram(m_Program);
+	glUniformMatrix4fv(m_OrthoViewLocation, 1, GL_FALSE, view.getTransform().getMatrix());
+	const sf::Vector2u textureSize = texture->getSize();
+	glUniform2f(m_TextureSizeLocation, static_cast<float>(textureSize.x), static_cast<float>(textureSize.y));
+	glUniform1i(m_TextureLocation, 0);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, texture->getNativeHandle());
+
+	glBindVertexArray(m_VertexArray);
+	glBindBuffer(GL_ARRAY_BUFFER, m_InstanceBuffer);
+	//Orphan the previous storage so the driver does not wait for the last frame to finish with it
+	glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(count * sizeof(SpriteInstance)), instances, GL_STREAM_DRAW);
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(count));
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glUseProgram(0);
+	//SFML caches its own GL states
+	target.resetGLStates();
+	return true;
+}
+
+void InstancedSpriteRenderer::DrawFallback(sf::RenderTarget& target, const SpriteInstance* instances, size_t count,
+                                           const sf::Texture* texture)
+{
+	if (count == 0)
+		return;
+	rmt_ScopedCPUSample(InstancedSpriteFallbackDraw, 0);
+	const sf::Vector2f textureSize = texture != nullptr ? sf::Vector2f(texture->getSize()) : sf::Vector2f(1.0f, 1.0f);
+	const sf::Vector2f corners[6] =
+	{
+		sf::Vector2f(-0.5f, -0.5f), sf::Vector2f(0.5f, -0.5f), sf::Vector2f(-0.5f, 0.5f),
+		sf::Vector2f(-0.5f, 0.5f), sf::Vector2f(0.5f, -0.5f), sf::Vector2f(0.5f, 0.5f)
+	};
+	std::vector<sf::Vertex> vertices(6 * count);
+	for (size_t i = 0; i < count; i++)
+	{
+		const auto& instance = instances[i];
+		const sf::Vector2f uvPosition(instance.uvRect[0] / 65535.0f * textureSize.x, instance.uvRect[1] / 65535.0f * textureSize.y);
+		const sf::Vector2f uvSize(instance.uvRect[2] / 65535.0f * textureSize.x, instance.uvRect[3] / 65535.0f * textureSize.y);
+		sf::Transform transform;
+		transform.translate(instance.position).rotate(instance.rotation).scale(uvSize.x * instance.scale.x, uvSize.y * instance.scale.y);
+		const sf::Color color(instance.color[0], instance.color[1], instance.color[2], instance.color[3]);
+		for (size_t corner = 0; corner < 6; corner++)
+		{
+			const sf::Vector2f texCoords(uvPosition.x + (corners[corner].x + 0.5f) * uvSize.x,
+				uvPosition.y + (corners[corner].y + 0.5f) * uvSize.y);
+			vertices[6 * i + corner] = sf::Vertex(transform.transformPoint(corners[corner]), color, texCoords);
+		}
+	}
+	sf::RenderStates renderStates;
+	renderStates.texture = texture;
+	target.draw(&vertices[0], vertices.size(), sf::Triangles, renderStates);
+}
+
+void InstancedSpriteRenderer::Release()
+{
+	if (m_Program != 0)
+		glDeleteProgram(m_Program);
+	if (m_VertexArray != 0)
+		glDeleteVertexArrays(1, &m_VertexArray);
+	if (m_QuadBuffer != 0)
+		glDeleteBuffers(1, &m_QuadBuffer);
+	if (m_InstanceBuffer != 0)
+		glDeleteBuffers(1, &m_InstanceBuffer);
+	m_Program = 0;
+	m_VertexArray = 0;
+	m_QuadBuffer = 0;
+	m_InstanceBuffer = 0;
+	m_Supported = false;
+	m_Initialized = false;
+}
+}
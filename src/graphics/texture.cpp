@@ -25,15 +25,27 @@ SOFTWARE.
 
 //STL
 #include <sstream>
+#include <algorithm>
+#include <iomanip>
+#include <cstdio>
+#include <cstring>
 #include <list>
 #include <set>
 #include <memory>
+#include <atomic>
+#include <thread>
+
+#include <GL/glew.h>
+#include <Remotery.h>
 
 #include <graphics/texture.h>
 #include <utility/log.h>
 #include <engine/config.h>
 #include <engine/engine.h>
+#include <engine/asset.h>
+#include <graphics/graphics2d.h>
 #include <utility/file_utility.h>
+#include <utility/pack_file.h>
 
 
 
@@ -50,15 +62,101 @@ static std::set<std::string> imgExtensionSet
 	".gif",
 	".psd",
 	".hdr",
-	".pic"
+	".pic",
+	".dds"
 };
 
+static const size_t ddsHeaderSize = 128U;
+
+/**
+* \brief Bytes of the first mip level of a DXT texture, one block per 4x4 pixels
+*/
+static size_t GetCompressedSize(TextureFormat format, unsigned width, unsigned height)
+{
+	const size_t blockSize = format == TextureFormat::DXT1 ? 8U : 16U;
+	return std::max(1U, (width + 3U) / 4U) * std::max(1U, (height + 3U) / 4U) * blockSize;
+}
+
+/**
+* \brief Keep the first mip level of a DXT1, DXT3 or DXT5 .dds, the other formats and the DX10 header are not supported
+*/
+static bool ParseDds(const std::string& filename, const char* data, size_t size, TextureDecodeResult& result)
+{
+	auto readUint = [data](size_t offset)
+	{
+		std::uint32_t value = 0;
+		std::memcpy(&value, data + offset, sizeof(value));
+		return value;
+	};
+	if (size < ddsHeaderSize || std::memcmp(data, "DDS ", 4) != 0)
+	{
+		std::ostringstream oss;
+		oss << "[ERROR] Texture file: " << filename << " is not a dds";
+		Log::GetInstance()->Error(oss.str());
+		return false;
+	}
+	const std::uint32_t height = readUint(12);
+	const std::uint32_t width = readUint(16);
+	const std::uint32_t fourCC = readUint(84);
+	if (std::memcmp(&fourCC, "DXT1", 4) == 0)
+		result.format = TextureFormat::DXT1;
+	else if (std::memcmp(&fourCC, "DXT3", 4) == 0)
+		result.format = TextureFormat::DXT3;
+	else if (std::memcmp(&fourCC, "DXT5", 4) == 0)
+		result.format = TextureFormat::DXT5;
+	else
+	{
+		std::ostringstream oss;
+		oss << "[ERROR] Texture file: " << filename << " is not a DXT1, DXT3 or DXT5 dds";
+		Log::GetInstance()->Error(oss.str());
+		return false;
+	}
+	const size_t dataSize = GetCompressedSize(result.format, width, height);
+	if (width == 0 || height == 0 || size - ddsHeaderSize < dataSize)
+	{
+		std::ostringstream oss;
+		oss << "[ERROR] Texture file: " << filename << " is a truncated dds";
+		Log::GetInstance()->Error(oss.str());
+		return false;
+	}
+	result.size = sf::Vector2u(width, height);
+	result.compressedData.assign(data + ddsHeaderSize, data + ddsHeaderSize + dataSize);
+	return true;
+}
+
+size_t TextureDecodeResult::GetByteSize() const
+{
+	if (!success)
+		return 0U;
+	return format == TextureFormat::RGBA8 ? 4U * size.x * size.y : compressedData.size();
+}
+
 
 void TextureManager::OnEngineInit()
 {
 	System::OnEngineInit();
+	InitPlaceholder();
 	if(const auto config = m_Engine.GetConfig())
 	{
+		m_UploadBudget = config->textureUploadBudget;
+		m_CacheDirname = config->textureCacheDirname;
+		if (!m_CacheDirname.empty() && !FileExists(m_CacheDirname) && !CreateDirectory(m_CacheDirname))
+		{
+			std::ostringstream oss;
+			oss << "[Warning] Texture cache folder: " << m_CacheDirname << " cannot be created, the textures are always decoded";
+			Log::GetInstance()->Msg(oss.str());
+			m_CacheDirname.clear();
+		}
+		else if (!m_CacheDirname.empty())
+		{
+			const size_t prunedEntries = PruneDirectory(m_CacheDirname, config->textureCacheMaxSize);
+			if (prunedEntries > 0)
+			{
+				std::ostringstream oss;
+				oss << "Texture cache: removed " << prunedEntries << " old entries";
+				Log::GetInstance()->Msg(oss.str());
+			}
+		}
 		if(config->devMode)
 		{
 			LoadTextures(config->dataDirname);
@@ -73,7 +171,7 @@ void TextureManager::LoadTextures(std::string dataDirname)
 	{
 		if (IsRegularFile(entry) && HasValidExtension(entry))
 		{
-			const TextureId newTextureId = LoadTexture(entry);
+			const TextureId newTextureId = LoadTexture(entry, true);
 			if (newTextureId != INVALID_TEXTURE)
 			{
 				std::ostringstream oss;
@@ -90,7 +188,7 @@ void TextureManager::LoadTextures(std::string dataDirname)
 	IterateDirectory(dataDirname, LoadAllTextures);
 }
 
-TextureId TextureManager::LoadTexture(std::string filename)
+TextureId TextureManager::LoadTexture(std::string filename, bool async)
 {
 	if (!HasValidExtension (filename))
 	{
@@ -100,64 +198,429 @@ TextureId TextureManager::LoadTexture(std::string filename)
 		return INVALID_TEXTURE;
 	}
 
+	//Even the asynchronous path hashes a new file before the lookup, so two files with the same content share one texture.
+	//A known path is not read again, and a packed file takes the hash of its pack entry
+	const AssetId assetId = m_Engine.GetAssetManager()->LoadAsset(filename, AssetType::TEXTURE);
+	if (assetId == INVALID_ASSET)
+	{
+		std::ostringstream oss;
+		oss << "[ERROR] Could not load texture file: " << filename;
+		Log::GetInstance()->Error(oss.str());
+		return INVALID_TEXTURE;
+	}
 	auto textureId = INVALID_TEXTURE;
-	for (TextureId checkedId = 1U; checkedId <= m_IncrementId; checkedId++)
+	const auto textureIt = m_AssetTextureIds.find(assetId);
+	if (textureIt != m_AssetTextureIds.end())
 	{
-		if (filename == m_TexturePaths[checkedId-1])
-		{
-			textureId = checkedId;
-		}
+		textureId = textureIt->second;
 	}
 	//Was or still is loaded
 	if (textureId != INVALID_TEXTURE)
 	{
-		
+		//A synchronous caller cannot wait for the decoding task
+		if (m_TexturePending[textureId - 1] && !async)
+		{
+			if (!LoadTextureSync(textureId, filename))
+			{
+				return INVALID_TEXTURE;
+			}
+			m_TextureIdsRefCounts[textureId-1]++;
+			return textureId;
+		}
 		//Check if the texture was destroyed
-		if (m_Textures[textureId - 1].getNativeHandle () != 0U)
+		if (m_TexturePending[textureId - 1] || m_Textures[textureId - 1].getNativeHandle () != 0U)
 		{
 			m_TextureIdsRefCounts[textureId-1]++;
 			return textureId;
 		}
 		else
 		{
-			auto& texture = m_Textures[textureId-1];
-			if (!texture.loadFromFile(filename))
+			if (async)
+			{
+				StartDecode(textureId, filename);
+			}
+			else if (!LoadTextureSync(textureId, filename))
 			{
-				std::ostringstream oss;
-				oss << "[ERROR] Could not load texture file: " << filename;
-				Log::GetInstance()->Error(oss.str());
 				return INVALID_TEXTURE;
 			}
 			m_TextureIdsRefCounts[textureId-1] = 1U;
-			return m_IncrementId;
+			return textureId;
 		}
 	}
 	//Texture was never loaded
-	if (FileExists(filename))
+	textureId = m_IncrementId+1;
+	if (textureId > m_Textures.size())
+	{
+		std::ostringstream oss;
+		oss << "[ERROR] Texture cache is full, cannot load: " << filename;
+		Log::GetInstance()->Error(oss.str());
+		return INVALID_TEXTURE;
+	}
+	if (async)
+	{
+		StartDecode(textureId, filename);
+	}
+	else if (!LoadTextureSync(textureId, filename))
+	{
+		return INVALID_TEXTURE;
+	}
+
+	m_TexturePaths[textureId-1] = filename;
+	m_TextureIdsRefCounts[textureId-1] = 1U;
+	m_AssetTextureIds[assetId] = textureId;
+
+	m_IncrementId++;
+	return textureId;
+}
+
+TextureId TextureManager::PreloadTexture(const std::string& filename)
+{
+	const TextureId textureId = LoadTexture(filename, true);
+	if (textureId != INVALID_TEXTURE)
+	{
+		m_TextureIdsRefCounts[textureId - 1]--;
+	}
+	return textureId;
+}
+
+bool TextureManager::ReloadTexture(const std::string& filename)
+{
+	auto* assetManager = m_Engine.GetAssetManager();
+	const AssetId previousAssetId = assetManager->FindAsset(filename);
+	const auto textureIt = m_AssetTextureIds.find(previousAssetId);
+	if (previousAssetId == INVALID_ASSET || textureIt == m_AssetTextureIds.end())
+		return false;
+	const TextureId textureId = textureIt->second;
+	const AssetId assetId = assetManager->ReloadAsset(filename, AssetType::TEXTURE);
+	if (assetId != previousAssetId || m_TexturePaths[textureId - 1] != filename)
+		return true;
+	if (m_TexturePending[textureId - 1] || m_Textures[textureId - 1].getNativeHandle() != 0U)
 	{
-		textureId = m_IncrementId+1;
-		auto& texture = m_Textures[textureId-1] ;
-		if (!texture.loadFromFile(filename))
 		{
 			std::ostringstream oss;
-			oss << "[ERROR] Could not load texture file: " << filename;
-			Log::GetInstance()->Error(oss.str());
-			return INVALID_TEXTURE;
+			oss << "Reloading texture: " << filename;
+			Log::GetInstance()->Msg(oss.str());
 		}
+		StartDecode(textureId, filename);
+	}
+	return true;
+}
 
-		m_TexturePaths[textureId-1] = filename;
-		m_TextureIdsRefCounts[textureId-1] = 1U;
-
-		m_IncrementId++;
-		return textureId;
+bool TextureManager::LoadTextureSync(TextureId textureId, const std::string& filename)
+{
+	//Any decoding task still running for this slot is now outdated
+	m_TextureGenerations[textureId - 1]++;
+	if (m_TexturePending[textureId - 1])
+	{
+		m_TexturePending[textureId - 1] = false;
+		m_PendingTexturesCount--;
 	}
-	else
+	auto sourceHash = GetSourceHash(filename);
+	if (sourceHash == 0 && !m_CacheDirname.empty())
+	{
+		AssetManager::HashFile(filename, sourceHash);
+	}
+	TextureDecodeResult result;
+	result.success = DecodeTexture(filename, sourceHash, m_CacheDirname, result);
+	if (result.success)
+	{
+		WaitForRenderThread();
+	}
+	if (!result.success || !UploadTexture(m_Textures[textureId - 1], result))
 	{
+		m_TextureFailed[textureId - 1] = true;
 		std::ostringstream oss;
 		oss << "[ERROR] Could not load texture file: " << filename;
 		Log::GetInstance()->Error(oss.str());
+		return false;
+	}
+	m_TextureFailed[textureId - 1] = false;
+	if (result.fromCache)
+	{
+		m_CacheReadCount++;
+	}
+	return true;
+}
+
+void TextureManager::StartDecode(TextureId textureId, const std::string& filename)
+{
+	auto& threadPool = m_Engine.GetThreadPool();
+	if (threadPool.size() == 0)
+	{
+		LoadTextureSync(textureId, filename);
+		return;
+	}
+	//The sprites keep the same sf::Texture, only its content changes when the image is ready
+	WaitForRenderThread();
+	m_Textures[textureId - 1].loadFromImage(m_PlaceholderImage);
+	m_TextureFailed[textureId - 1] = false;
+	if (!m_TexturePending[textureId - 1])
+	{
+		m_TexturePending[textureId - 1] = true;
+		m_PendingTexturesCount++;
+	}
+	const unsigned generation = ++m_TextureGenerations[textureId - 1];
+	auto decodeQueue = m_DecodeQueue;
+	const auto sourceHash = GetSourceHash(filename);
+	const auto cacheDirname = m_CacheDirname;
+	threadPool.push([decodeQueue, textureId, generation, filename, sourceHash, cacheDirname](int)
+	{
+		auto taskSourceHash = sourceHash;
+		if (taskSourceHash == 0 && !cacheDirname.empty())
+		{
+			AssetManager::HashFile(filename, taskSourceHash);
+		}
+		TextureDecodeResult result;
+		result.textureId = textureId;
+		result.generation = generation;
+		result.success = DecodeTexture(filename, taskSourceHash, cacheDirname, result);
+		std::lock_guard<std::mutex> lock(decodeQueue->mutex);
+		decodeQueue->results.push_back(std::move(result));
+	});
+}
+
+void TextureManager::OnUpdate(float dt)
+{
+	(void) dt;
+	m_ReadyTextures.clear();
+	{
+		std::lock_guard<std::mutex> lock(m_DecodeQueue->mutex);
+		for (auto& result : m_DecodeQueue->results)
+		{
+			m_UploadQueue.push_back(std::move(result));
+		}
+		m_DecodeQueue->results.clear();
+	}
+	if (m_UploadQueue.empty())
+		return;
+	rmt_ScopedCPUSample(TextureUpload, 0);
+	WaitForRenderThread();
+	size_t uploadedBytes = 0;
+	size_t resultIndex = 0;
+	for (; resultIndex < m_UploadQueue.size(); resultIndex++)
+	{
+		auto& result = m_UploadQueue[resultIndex];
+		const TextureId textureId = result.textureId;
+		if (result.generation != m_TextureGenerations[textureId - 1])
+		{
+			continue;
+		}
+		const size_t imageBytes = result.GetByteSize();
+		//At least one texture per frame, whatever its size
+		if (uploadedBytes > 0 && uploadedBytes + imageBytes > m_UploadBudget)
+		{
+			break;
+		}
+		m_TexturePending[textureId - 1] = false;
+		m_PendingTexturesCount--;
+		if (!result.success || !UploadTexture(m_Textures[textureId - 1], result))
+		{
+			m_TextureFailed[textureId - 1] = true;
+			std::ostringstream oss;
+			oss << "[ERROR] Could not load texture file: " << m_TexturePaths[textureId - 1];
+			Log::GetInstance()->Error(oss.str());
+			continue;
+		}
+		m_TextureFailed[textureId - 1] = false;
+		if (result.fromCache)
+		{
+			m_CacheReadCount++;
+		}
+		uploadedBytes += imageBytes;
+		m_ReadyTextures.push_back(textureId);
+	}
+	m_UploadQueue.erase(m_UploadQueue.begin(), m_UploadQueue.begin() + resultIndex);
+}
+
+bool TextureManager::DecodeTexture(const std::string& filename, xxh::hash64_t sourceHash, const std::string& cacheDirname, TextureDecodeResult& result)
+{
+	rmt_ScopedCPUSample(TextureDecode, 0);
+	const char* packedData = nullptr;
+	size_t packedSize = 0;
+	std::vector<char> packedBuffer;
+	const bool packed = ReadPackedFile(filename, packedData, packedSize, packedBuffer);
+	if (GetFilenameExtension(filename) == ".dds")
+	{
+		if (packed)
+		{
+			return ParseDds(filename, packedData, packedSize, result);
+		}
+		MappedFile ddsFile;
+		return ddsFile.Open(filename) && ParseDds(filename, ddsFile.GetData(), ddsFile.GetSize(), result);
+	}
+
+	std::string cachePath;
+	if (!cacheDirname.empty() && sourceHash != 0)
+	{
+		std::ostringstream oss;
+		oss << cacheDirname << (cacheDirname.back() == '/' ? "" : "/") << std::hex << std::setw(16) << std::setfill('0') << sourceHash << ".tex";
+		cachePath = oss.str();
+		if (ReadCachedTexture(cachePath, result))
+		{
+			result.fromCache = true;
+			return true;
+		}
+	}
+	result.format = TextureFormat::RGBA8;
+	result.image = std::make_unique<sf::Image>();
+	const bool decoded = packed ?
+		result.image->loadFromMemory(packedData, packedSize) : result.image->loadFromFile(filename);
+	if (!decoded)
+	{
+		return false;
+	}
+	result.size = result.image->getSize();
+	if (!cachePath.empty())
+	{
+		WriteCachedTexture(cachePath, *result.image);
+	}
+	return true;
+}
+
+bool TextureManager::ReadCachedTexture(const std::string& cachePath, TextureDecodeResult& result)
+{
+	MappedFile cacheFile;
+	if (!cacheFile.Open(cachePath) || cacheFile.GetSize() < sizeof(TextureCacheHeader))
+	{
+		return false;
+	}
+	TextureCacheHeader header;
+	std::memcpy(&header, cacheFile.GetData(), sizeof(header));
+	if (header.magic != TEXTURE_CACHE_MAGIC || header.version != TEXTURE_CACHE_VERSION ||
+		header.format != static_cast<std::uint32_t>(TextureFormat::RGBA8) ||
+		header.dataSize != 4ULL * header.width * header.height ||
+		cacheFile.GetSize() - sizeof(header) < header.dataSize)
+	{
+		return false;
+	}
+	result.format = TextureFormat::RGBA8;
+	result.size = sf::Vector2u(header.width, header.height);
+	result.image = std::make_unique<sf::Image>();
+	result.image->create(header.width, header.height,
+		reinterpret_cast<const sf::Uint8*>(cacheFile.GetData() + sizeof(header)));
+	return true;
+}
+
+void TextureManager::WriteCachedTexture(const std::string& cachePath, const sf::Image& image)
+{
+	TextureCacheHeader header;
+	header.width = image.getSize().x;
+	header.height = image.getSize().y;
+	header.dataSize = 4U * header.width * header.height;
+	//Written aside then renamed, so a concurrent reader never sees half a file,
+	//the temporary name is unique so two tasks writing the same entry do not share it
+	static std::atomic<unsigned> tmpCounter{0U};
+	std::ostringstream tmpOss;
+	tmpOss << cachePath << "." << std::hash<std::thread::id>()(std::this_thread::get_id()) << "." << tmpCounter++ << ".tmp";
+	const std::string tmpPath = tmpOss.str();
+	{
+		std::ofstream cacheFile(tmpPath, std::ios::binary | std::ios::trunc);
+		cacheFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		cacheFile.write(reinterpret_cast<const char*>(image.getPixelsPtr()), header.dataSize);
+		if (!cacheFile)
+		{
+			std::ostringstream oss;
+			oss << "[Warning] Texture cache file: " << cachePath << " cannot be written";
+			Log::GetInstance()->Msg(oss.str());
+			cacheFile.close();
+			std::remove(tmpPath.c_str());
+			return;
+		}
+	}
+	if (std::rename(tmpPath.c_str(), cachePath.c_str()) != 0)
+	{
+		std::remove(tmpPath.c_str());
+	}
+}
+
+bool TextureManager::UploadTexture(sf::Texture& texture, const TextureDecodeResult& result)
+{
+	if (result.format == TextureFormat::RGBA8)
+	{
+		return texture.loadFromImage(*result.image);
+	}
+	rmt_ScopedCPUSample(CompressedTextureUpload, 0);
+	//The default SFML context is only kept active by the SFML calls
+	std::unique_ptr<sf::Context> context = sf::Context::getActiveContextId() == 0 ? std::make_unique<sf::Context>() : nullptr;
+	if (!m_CompressedFormatsChecked)
+	{
+		m_CompressedFormatsChecked = true;
+		m_CompressedFormatsSupported = InitGlew() && GLEW_EXT_texture_compression_s3tc;
+		if (!m_CompressedFormatsSupported)
+		{
+			Log::GetInstance()->Error("[Error] S3TC compressed textures are not supported by the OpenGL driver");
+		}
+	}
+	if (!m_CompressedFormatsSupported || !texture.create(result.size.x, result.size.y))
+	{
+		return false;
+	}
+	GLenum internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+	if (result.format == TextureFormat::DXT3)
+		internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+	else if (result.format == TextureFormat::DXT5)
+		internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	//The storage allocated by create is replaced by the compressed blocks, the size stays the same
+	sf::Texture::bind(&texture);
+	while (glGetError() != GL_NO_ERROR) {}
+	glCompressedTexImage2D(GL_TEXTURE_2D, 0, internalFormat, result.size.x, result.size.y, 0,
+		static_cast<GLsizei>(result.compressedData.size()), result.compressedData.data());
+	const bool uploaded = glGetError() == GL_NO_ERROR;
+	sf::Texture::bind(nullptr);
+	return uploaded;
+}
+
+xxh::hash64_t TextureManager::GetSourceHash(const std::string& filename) const
+{
+	const auto* asset = m_Engine.GetAssetManager()->GetAsset(m_Engine.GetAssetManager()->FindAsset(filename));
+	return asset == nullptr ? 0 : asset->hash;
+}
+
+bool TextureManager::IsTextureReady(TextureId textureId) const
+{
+	if (textureId == INVALID_TEXTURE || textureId > m_IncrementId)
+		return false;
+	return !m_TexturePending[textureId - 1] && !m_TextureFailed[textureId - 1] &&
+		m_Textures[textureId - 1].getNativeHandle() != 0U;
+}
+
+const std::vector<TextureId>& TextureManager::GetReadyTextures() const
+{
+	return m_ReadyTextures;
+}
+
+size_t TextureManager::GetPendingTexturesCount() const
+{
+	return m_PendingTexturesCount;
+}
+
+size_t TextureManager::GetCacheReadCount() const
+{
+	return m_CacheReadCount;
+}
+
+void TextureManager::InitPlaceholder()
+{
+	const unsigned placeholderSize = 16U;
+	m_PlaceholderImage.create(placeholderSize, placeholderSize, sf::Color::Magenta);
+	for (unsigned x = 0U; x < placeholderSize; x++)
+	{
+		for (unsigned y = 0U; y < placeholderSize; y++)
+		{
+			if ((x / 4U + y / 4U) % 2U == 0U)
+			{
+				m_PlaceholderImage.setPixel(x, y, sf::Color::Black);
+			}
+		}
+	}
+}
+
+void TextureManager::WaitForRenderThread()
+{
+	if (auto* graphicsManager = m_Engine.GetGraphics2dManager())
+	{
+		graphicsManager->WaitForRenderThread();
 	}
-	return INVALID_TEXTURE;
 }
 
 sf::Texture* TextureManager::GetTexture(TextureId textureId)
@@ -200,9 +663,20 @@ void TextureManager::OnAfterSceneLoad()
 			unusedTextureIds.push_back(i+1);
 		}
 	}
+	if (!unusedTextureIds.empty())
+	{
+		WaitForRenderThread();
+	}
 	for (auto unusedTextureId : unusedTextureIds)
 	{
 		m_Textures[unusedTextureId-1] = sf::Texture();
+		m_TextureFailed[unusedTextureId-1] = false;
+		m_TextureGenerations[unusedTextureId-1]++;
+		if (m_TexturePending[unusedTextureId-1])
+		{
+			m_TexturePending[unusedTextureId-1] = false;
+			m_PendingTexturesCount--;
+		}
 	}
 }
 
@@ -33,6 +33,8 @@ int main()
     std::unique_ptr<sfge::Configuration> config = std::make_unique<sfge::Configuration>();
     config->devMode = false;
     config->editor = false;
+    config->packFilename = "data.pack";
+    config->lazyScripts = true;
 	engine.Init(std::move(config));
 	config = nullptr;
 	engine.Start();
@@ -0,0 +1,56 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <cstring>
+#include <sstream>
+
+#include <utility/pack_file.h>
+#include <utility/log.h>
+
+/**
+* \brief Build the pack read by the engine at startup: SFGE_PACK <data folder> <pack file> [--no-compress]
+*/
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		sfge::Log::GetInstance()->Error("Usage: SFGE_PACK <data folder> <pack file> [--no-compress]");
+		return EXIT_FAILURE;
+	}
+	const std::string dataDirname = argv[1];
+	const std::string packFilename = argv[2];
+	const bool compress = !(argc > 3 && std::strcmp(argv[3], "--no-compress") == 0);
+
+	sfge::PackBuilder packBuilder;
+	//Files written by the engine at runtime would be read back outdated from the pack
+	packBuilder.AddDirectory(dataDirname, { "scene_index.json" });
+	if (!packBuilder.Write(packFilename, compress))
+	{
+		return EXIT_FAILURE;
+	}
+	std::ostringstream oss;
+	oss << "Packed " << packBuilder.GetFileCount() << " files from " << dataDirname << " into " << packFilename;
+	sfge::Log::GetInstance()->Msg(oss.str());
+	return EXIT_SUCCESS;
+}
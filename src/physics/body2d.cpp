@@ -153,6 +153,11 @@ void Body2dManager::OnEngineInit()
 	SingleComponentManager::OnEngineInit();
 	m_Transform2dManager = m_Engine.GetTransform2dManager();
 	m_WorldPtr = m_Engine.GetPhysicsManager()->GetWorld();
+	//A new world is created at each scene load
+	m_BodyCount = 0;
+	m_LinearVelocities.resize(m_Components.size(), p2Vec2(0.0f, 0.0f));
+	m_SyncedLinearVelocities.resize(m_Components.size(), p2Vec2(0.0f, 0.0f));
+	m_Forces.resize(m_Components.size(), p2Vec2(0.0f, 0.0f));
 }
 
 void Body2dManager::OnFixedUpdate()
@@ -165,7 +170,10 @@ void Body2dManager::OnFixedUpdate()
 		{
 			auto & transform = m_Transform2dManager->GetComponentRef(entity);
 			auto & body2d = GetComponentRef(entity);
-			m_ComponentsInfo[i].AddVelocity(body2d.GetLinearVelocity());
+			const auto velocity = body2d.GetLinearVelocity();
+			m_LinearVelocities[i] = velocity;
+			m_SyncedLinearVelocities[i] = velocity;
+			m_ComponentsInfo[i].AddVelocity(velocity);
 			transform.Position = meter2pixel(body2d.GetBody()->GetPosition()) - static_cast<sf::Vector2f>(body2d.GetOffset());
 		}
 	}
@@ -173,6 +181,13 @@ void Body2dManager::OnFixedUpdate()
 
 Body2d* Body2dManager::AddComponent(Entity entity)
 {
+	if (m_BodyCount >= MAX_BODY_LEN)
+	{
+		std::ostringstream oss;
+		oss << "[Error] Body2d of entity: " << entity << " cannot be created, the world is limited to " << MAX_BODY_LEN << " bodies";
+		Log::GetInstance()->Error(oss.str());
+		return nullptr;
+	}
 	if (auto world = m_WorldPtr.lock())
 	{
 		p2BodyDef bodyDef;
@@ -183,6 +198,7 @@ Body2d* Body2dManager::AddComponent(Entity entity)
 		bodyDef.position = pixel2meter(pos);
 
 		auto* body = world->CreateBody(&bodyDef);
+		m_BodyCount++;
 		m_Components[entity - 1] = Body2d(transform, sf::Vector2f());
 		m_Components[entity - 1].SetBody(body);
 
@@ -198,47 +214,125 @@ Body2d* Body2dManager::AddComponent(Entity entity)
 }
 
 void Body2dManager::CreateComponent(json& componentJson, Entity entity)
+{
+	CreateComponent(GetDefFromJson(componentJson), entity);
+}
+
+Body2dDef Body2dManager::GetDefFromJson(const json& componentJson)
+{
+	Body2dDef def;
+	if (CheckJsonExists(componentJson, "body_type"))
+	{
+		def.bodyType = componentJson["body_type"];
+	}
+	if (CheckJsonNumber(componentJson, "gravity_scale"))
+	{
+		def.gravityScale = componentJson["gravity_scale"];
+	}
+	def.offset = GetVectorFromJson(componentJson, "offset");
+	def.velocity = GetVectorFromJson(componentJson, "velocity");
+	return def;
+}
+
+void Body2dManager::CreateComponent(const Body2dDef& def, Entity entity)
 {
 	//Log::GetInstance()->Msg("Create component Transform");
+	if (m_BodyCount >= MAX_BODY_LEN)
+	{
+		std::ostringstream oss;
+		oss << "[Error] Body2d of entity: " << entity << " cannot be created, the world is limited to " << MAX_BODY_LEN << " bodies";
+		Log::GetInstance()->Error(oss.str());
+		return;
+	}
 	if (auto world = m_WorldPtr.lock())
 	{
 		p2BodyDef bodyDef;
-		if (CheckJsonExists(componentJson, "body_type"))
-		{
-			bodyDef.type = componentJson["body_type"];
-		}
-		if (CheckJsonNumber(componentJson, "gravity_scale"))
-		{
-			bodyDef.gravityScale = componentJson["gravity_scale"];
-		}
-
-		const auto offset = GetVectorFromJson(componentJson, "offset");
-		const auto velocity = GetVectorFromJson(componentJson, "velocity");
+		bodyDef.type = def.bodyType;
+		bodyDef.gravityScale = def.gravityScale;
 
 		auto* transform = m_Transform2dManager->GetComponentPtr(entity);
-		const auto pos = transform->Position + offset;
+		const auto pos = transform->Position + def.offset;
 		bodyDef.position = pixel2meter(pos);
 		
 		auto* body = world->CreateBody(&bodyDef);
-		body->SetLinearVelocity(pixel2meter(velocity));
-		m_Components[entity - 1] = Body2d(transform, offset);
+		m_BodyCount++;
+		body->SetLinearVelocity(pixel2meter(def.velocity));
+		m_Components[entity - 1] = Body2d(transform, def.offset);
 		m_Components[entity - 1].SetBody(body);
 
 
 		m_ComponentsInfo[entity - 1].bodyManager = this;
 		m_ComponentsInfo[entity - 1].SetEntity(entity);
+		m_ComponentsInfo[entity - 1].gravityScale = def.gravityScale;
 	}
 }
 
+void Body2dManager::SerializeComponents(Entity entity, json& componentsJson)
+{
+	const auto& body = m_Components[entity - 1];
+	if (body.GetBody() == nullptr)
+		return;
+	json componentJson;
+	componentJson["type"] = static_cast<int>(ComponentType::BODY2D);
+	componentJson["body_type"] = static_cast<int>(body.GetBody()->GetType());
+	componentJson["gravity_scale"] = m_ComponentsInfo[entity - 1].gravityScale;
+	componentJson["offset"] = GetJsonFromVector(body.GetOffset());
+	componentJson["velocity"] = GetJsonFromVector(meter2pixel(body.GetLinearVelocity()));
+	componentsJson.push_back(componentJson);
+}
+
 void Body2dManager::DestroyComponent(Entity entity)
 {
 	(void) entity;
 }
 
+size_t Body2dManager::GetBodyCount() const
+{
+	return m_BodyCount;
+}
+
 void Body2dManager::OnResize(size_t new_size)
 {
 	m_Components.resize(new_size);
 	m_ComponentsInfo.resize(new_size);
+	m_LinearVelocities.resize(new_size, p2Vec2(0.0f, 0.0f));
+	m_SyncedLinearVelocities.resize(new_size, p2Vec2(0.0f, 0.0f));
+	m_Forces.resize(new_size, p2Vec2(0.0f, 0.0f));
+}
+
+void Body2dManager::ApplyArrayChanges()
+{
+	//The default p2Vec2 is not zero
+	const p2Vec2 zero(0.0f, 0.0f);
+	for (auto i = 0u; i < m_Components.size(); i++)
+	{
+		const Entity entity = i + 1;
+		if (!m_EntityManager->HasComponent(entity, ComponentType::BODY2D))
+		{
+			continue;
+		}
+		auto& body2d = m_Components[i];
+		if (!(m_LinearVelocities[i] == m_SyncedLinearVelocities[i]))
+		{
+			body2d.SetLinearVelocity(m_LinearVelocities[i]);
+			m_SyncedLinearVelocities[i] = m_LinearVelocities[i];
+		}
+		if (!(m_Forces[i] == zero))
+		{
+			body2d.ApplyForce(m_Forces[i]);
+			m_Forces[i] = zero;
+		}
+	}
+}
+
+std::vector<p2Vec2>& Body2dManager::GetLinearVelocities()
+{
+	return m_LinearVelocities;
+}
+
+std::vector<p2Vec2>& Body2dManager::GetForces()
+{
+	return m_Forces;
 }
 }
 
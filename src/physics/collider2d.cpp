@@ -27,6 +27,7 @@ SOFTWARE.
 #include <engine/component.h>
 #include <physics/physics2d.h>
 #include <engine/engine.h>
+#include <graphics/debug_draw.h>
 namespace sfge
 {
 void editor::ColliderInfo::DrawOnInspector()
@@ -69,65 +70,103 @@ void ColliderManager::OnEngineInit()
 
 void ColliderManager::CreateComponent(json& componentJson, Entity entity)
 {
-	Log::GetInstance()->Msg("Create component Collider");
+	CreateComponent(GetDefFromJson(componentJson), entity);
+}
+
+ColliderDef ColliderManager::GetDefFromJson(const json& componentJson)
+{
+	ColliderDef def;
+	if (CheckJsonExists(componentJson, "sensor"))
+	{
+		def.isSensor = componentJson["sensor"];
+	}
+	if (CheckJsonExists(componentJson, "collider_type"))
+	{
+		def.colliderType = static_cast<ColliderType>(componentJson["collider_type"]);
+	}
+	if (CheckJsonNumber(componentJson, "radius"))
+	{
+		def.hasRadius = true;
+		def.radius = componentJson["radius"];
+	}
+	if (CheckJsonExists(componentJson, "size"))
+	{
+		def.size = GetVectorFromJson(componentJson, "size");
+	}
+	if(CheckJsonNumber(componentJson, "bouncing"))
+	{
+		def.restitution = componentJson["bouncing"];
+	}
+	return def;
+}
+
+void ColliderManager::SerializeComponents(Entity entity, json& componentsJson)
+{
+	ForEachComponentOf(entity, [this, &componentsJson](size_t i)
+	{
+		const auto& def = m_ComponentsInfo[i].def;
+		json componentJson;
+		componentJson["type"] = static_cast<int>(ComponentType::COLLIDER2D);
+		componentJson["collider_type"] = static_cast<int>(def.colliderType);
+		componentJson["sensor"] = def.isSensor;
+		if (def.hasRadius)
+		{
+			componentJson["radius"] = def.radius;
+		}
+		componentJson["size"] = GetJsonFromVector(def.size);
+		componentJson["bouncing"] = def.restitution;
+		componentsJson.push_back(componentJson);
+	});
+}
+
+Entity ColliderManager::GetComponentEntity(size_t index)
+{
+	return m_Components[index].entity;
+}
+
+void ColliderManager::CreateComponent(const ColliderDef& def, Entity entity)
+{
 	if (m_EntityManager->HasComponent(entity, ComponentType::BODY2D))
 	{
 		auto & body = m_BodyManager->GetComponentRef(entity);
 
 		p2ColliderDef fixtureDef;
-
-		if (CheckJsonExists(componentJson, "sensor"))
-		{
-			fixtureDef.isSensor = componentJson["sensor"];
-		}
+		fixtureDef.isSensor = def.isSensor;
+		fixtureDef.restitution = def.restitution;
 
 		std::unique_ptr<p2Shape> shape = nullptr;
 
-		if (CheckJsonExists(componentJson, "collider_type"))
+		switch (def.colliderType)
 		{
-			ColliderType colliderType = static_cast<ColliderType>(componentJson["collider_type"]);
-			switch (colliderType)
-			{
-			case ColliderType::CIRCLE:
-			{
-				auto circleShape = std::make_unique<p2CircleShape>();
-				if (CheckJsonNumber(componentJson, "radius"))
-				{
-					circleShape->SetRadius(pixel2meter(static_cast<float>(componentJson["radius"])));
-				}
-				shape = std::move(circleShape);
-				// fixtureDef.colliderType = p2ColliderType::CIRCLE;
-			}
-				break;
-			case ColliderType::BOX:
-			{
-				auto boxShape = std::make_unique<p2RectShape>();
-				if (CheckJsonExists(componentJson, "size"))
-				{
-					auto size = pixel2meter(GetVectorFromJson(componentJson, "size"));
-					{
-						std::ostringstream oss;
-						oss << "Box physics size: " << size.x << ", " << size.y;
-						Log::GetInstance()->Msg(oss.str());
-					}
-					boxShape->SetSize(p2Vec2(size.x / 2.0f, size.y / 2.0f));
-				}
-				shape = std::move(boxShape);
-				// fixtureDef.colliderType = p2ColliderType::BOX;
-			}	
+		case ColliderType::NONE:
 			break;
-			default:
+		case ColliderType::CIRCLE:
+		{
+			auto circleShape = std::make_unique<p2CircleShape>();
+			if (def.hasRadius)
 			{
-				std::ostringstream oss;
-				oss << "[Error] Collider of type: " << static_cast<int>(colliderType) << " could not be loaded from json: " << componentJson;
-				Log::GetInstance()->Error(oss.str());
-			}
-				break;
+				circleShape->SetRadius(pixel2meter(def.radius));
 			}
+			shape = std::move(circleShape);
+			// fixtureDef.colliderType = p2ColliderType::CIRCLE;
 		}
-		if(CheckJsonNumber(componentJson, "bouncing"))
+			break;
+		case ColliderType::BOX:
+		{
+			auto boxShape = std::make_unique<p2RectShape>();
+			const auto size = pixel2meter(def.size);
+			boxShape->SetSize(p2Vec2(size.x / 2.0f, size.y / 2.0f));
+			shape = std::move(boxShape);
+			// fixtureDef.colliderType = p2ColliderType::BOX;
+		}	
+		break;
+		default:
 		{
-			fixtureDef.restitution = componentJson["bouncing"];
+			std::ostringstream oss;
+			oss << "[Error] Collider of type: " << static_cast<int>(def.colliderType) << " could not be loaded";
+			Log::GetInstance()->Error(oss.str());
+		}
+			break;
 		}
 		if (shape != nullptr)
 		{
@@ -144,6 +183,7 @@ void ColliderManager::CreateComponent(json& componentJson, Entity entity)
 				colliderData.fixture = fixture;
 				colliderData.body = body.GetBody();
 				m_ComponentsInfo[index].data = &colliderData;
+				m_ComponentsInfo[index].def = def;
 				m_ComponentsInfo[index].SetEntity(entity);
 				fixture->SetUserData(&colliderData);
 			}
@@ -173,4 +213,29 @@ ColliderData *ColliderManager::GetComponentPtr(Entity entity)
 	(void)entity;
 	return nullptr;
 }
+
+void ColliderManager::DrawDebug(DebugDraw& debugDraw)
+{
+	rmt_ScopedCPUSample(ColliderDebugDraw,0);
+	for (size_t i = 0; i < m_Components.size(); i++)
+	{
+		const auto& colliderData = m_Components[i];
+		if (colliderData.fixture == nullptr || colliderData.body == nullptr)
+			continue;
+		const auto& def = m_ComponentsInfo[i].def;
+		const Vec2f position = meter2pixel(colliderData.body->GetPosition());
+		const sf::Color color = def.isSensor ? sf::Color::Yellow : sf::Color::Green;
+		switch (def.colliderType)
+		{
+		case ColliderType::CIRCLE:
+			debugDraw.DrawCircle(position, def.radius, color, DebugDrawCategory::PHYSICS);
+			break;
+		case ColliderType::BOX:
+			debugDraw.DrawBox(position, def.size, 0.0f, color, DebugDrawCategory::PHYSICS);
+			break;
+		default:
+			break;
+		}
+	}
+}
 }
@@ -26,6 +26,9 @@ SOFTWARE.
 #include <python/python_engine.h>
 #include <engine/config.h>
 #include <engine/engine.h>
+#include <engine/scene.h>
+#include <graphics/graphics2d.h>
+#include <graphics/debug_draw.h>
 namespace sfge
 {
 
@@ -56,11 +59,21 @@ void Physics2dManager::OnFixedUpdate()
 	const auto config = m_Engine.GetConfig();
 	if (config != nullptr and m_World != nullptr)
 	{
+		m_BodyManager.ApplyArrayChanges();
 		m_World->Step(config->fixedDeltaTime);
 		m_BodyManager.OnFixedUpdate();
 	}
 }
 
+void Physics2dManager::OnDraw()
+{
+	auto* debugDraw = m_Engine.GetGraphics2dManager()->GetDebugDraw();
+	if (debugDraw != nullptr && debugDraw->IsCategoryEnabled(DebugDrawCategory::PHYSICS))
+	{
+		m_ColliderManager.DrawDebug(*debugDraw);
+	}
+}
+
 std::weak_ptr<p2World> Physics2dManager::GetWorld() const
 {
 	return m_World;
@@ -121,14 +134,8 @@ void ContactListener::BeginContact(p2Contact* contact)
 		Log::GetInstance()->Msg(oss.str());
 	}*/
 
-	auto& pySystems = pythonEngine->GetPySystemManager().GetPySystems();
-	for(size_t i = 0;i < pySystems.size();i++)
-	{
-		if(pySystems[i] != nullptr)
-		{
-			pySystems[i]->OnContact(colliderA, colliderB, true);
-		}
-	}
+	m_Engine.GetSceneManager()->ContactNativeSystems(colliderA, colliderB, true);
+	pythonEngine->GetPySystemManager().ContactSystems(colliderA, colliderB, true);
 		
 }
 
@@ -144,14 +151,8 @@ void ContactListener::EndContact(p2Contact* contact)
 		Log::GetInstance()->Msg(oss.str());
 	}*/
 
-	auto& pySystems = pythonEngine->GetPySystemManager().GetPySystems();
-	for (size_t i = 0; i < pySystems.size(); i++)
-	{
-		if (pySystems[i] != nullptr)
-		{
-			pySystems[i]->OnContact(colliderA, colliderB, false);
-		}
-	}
+	m_Engine.GetSceneManager()->ContactNativeSystems(colliderA, colliderB, false);
+	pythonEngine->GetPySystemManager().ContactSystems(colliderA, colliderB, false);
 }
 
 
@@ -3,6 +3,11 @@
 //
 
 #include <sstream>
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+
+#include <SFML/System/Clock.hpp>
 
 
 #include <physics/collider2d.h>
@@ -155,42 +160,13 @@ void PySystemManager::OnEngineInit()
 
 InstanceId PySystemManager::LoadPySystem(ModuleId moduleId)
 {
+	py::gil_scoped_acquire gil;
 	std::string className = m_PythonEngine->GetClassNameFrom(moduleId);
 	try
 	{
-		auto globals = py::globals();
-		auto moduleName = m_PythonEngine->GetModuleNameFrom(moduleId);
 		auto moduleObj = py::module(m_PythonEngine->GetModuleObjFrom(moduleId));
-
-		const auto pyInstanceId = m_IncrementalInstanceId;
 		//Load PySystem
-		m_PythonInstances[pyInstanceId] =
-			moduleObj.attr(className.c_str())(m_Engine);
-		m_PySystemNames[pyInstanceId] = className;
-		const auto pySystem = GetPySystemFromInstanceId(pyInstanceId);
-		if (pySystem != nullptr)
-		{
-			m_PySystems.push_back(pySystem);
-
-			/* TODO editor info on system
-			 *
-			 *auto pyInfo = editor::PyComponentInfo();
-			pyInfo.name = className;
-			pyInfo.path = m_PythonModulePaths[moduleId];
-			pyInfo.pyComponent = pySystem;
-			m_PyComponentsInfo.push_back(pyInfo);
-			*/
-		}
-		else
-		{
-			std::ostringstream oss;
-			oss << "[Python Error] Could not load the PyComponent* out of the instance";
-			Log::GetInstance()->Error(oss.str());
-			return INVALID_INSTANCE;
-		}
-
-		m_IncrementalInstanceId++;
-		return pyInstanceId;
+		return AddInstance(moduleObj.attr(className.c_str())(m_Engine), className, moduleId, true);
 	}
 	catch (std::runtime_error& e)
 	{
@@ -205,19 +181,11 @@ InstanceId PySystemManager::LoadPySystem(ModuleId moduleId)
 
 InstanceId PySystemManager::LoadCppExtensionSystem(std::string systemClassName)
 {
-	const auto pyInstanceId = m_IncrementalInstanceId;
+	py::gil_scoped_acquire gil;
 	try
 	{
 		py::module sfge = py::module::import("SFGE");
-		m_PythonInstances[pyInstanceId] = sfge.attr(systemClassName.c_str())(m_Engine);
-		m_PySystemNames[pyInstanceId] = systemClassName;
-		const auto pySystem = GetPySystemFromInstanceId(pyInstanceId);
-		if (pySystem != nullptr)
-		{
-			m_PySystems.push_back(pySystem);
-		}
-		m_IncrementalInstanceId++;
-		return pyInstanceId;
+		return AddInstance(sfge.attr(systemClassName.c_str())(m_Engine), systemClassName, 0U, false);
 	}
 	catch(std::runtime_error& e)
 	{
@@ -228,10 +196,90 @@ InstanceId PySystemManager::LoadCppExtensionSystem(std::string systemClassName)
 	return INVALID_INSTANCE;
 }
 
+InstanceId PySystemManager::AddInstance(py::object instance, const std::string& className, ModuleId moduleId, bool pythonClass)
+{
+	auto* pySystem = instance.cast<PySystem*>();
+	if (pySystem == nullptr)
+	{
+		Log::GetInstance()->Error("[Python Error] Could not load the PySystem* out of the instance");
+		return INVALID_INSTANCE;
+	}
+	const auto pyInstanceId = static_cast<InstanceId>(m_PythonInstances.size());
+	m_PythonInstances.push_back(std::move(instance));
+	m_PySystemNames.push_back(className);
+	m_InstanceModuleIds.push_back(moduleId);
+	m_InstanceHooks.emplace_back();
+	m_PySystems.push_back(pySystem);
+	m_PySystemsByName.emplace(className, pySystem);
+	m_InstanceIds[pySystem] = pyInstanceId;
+	CacheHooks(pyInstanceId, pythonClass);
+	AddHookSystem(pySystem, m_InstanceHooks[pyInstanceId]);
+	return pyInstanceId;
+}
+
+void PySystemManager::AddHookSystem(PySystem* pySystem, const PySystemHooks& hooks)
+{
+	for (size_t i = 0; i < m_HookSystems.size(); i++)
+	{
+		if (!hooks.pythonClass || hooks.functions[i])
+		{
+			m_HookSystems[i].push_back(pySystem);
+		}
+	}
+}
+
+void PySystemManager::RemoveHookSystem(PySystem* pySystem)
+{
+	for (auto& hookSystems : m_HookSystems)
+	{
+		hookSystems.erase(std::remove(hookSystems.begin(), hookSystems.end(), pySystem), hookSystems.end());
+	}
+}
+
+std::vector<std::pair<PySystem*, PySystem*>> PySystemManager::ReloadPySystems(ModuleId moduleId)
+{
+	std::vector<std::pair<PySystem*, PySystem*>> swappedPySystems;
+	const std::string className = m_PythonEngine->GetClassNameFrom(moduleId);
+	for (InstanceId instanceId = 1U; instanceId < m_PythonInstances.size(); instanceId++)
+	{
+		if (m_InstanceModuleIds[instanceId] != moduleId)
+			continue;
+		try
+		{
+			auto moduleObj = py::module(m_PythonEngine->GetModuleObjFrom(moduleId));
+			py::object newInstance = moduleObj.attr(className.c_str())(m_Engine);
+			auto* newPySystem = newInstance.cast<PySystem*>();
+			auto* previousPySystem = GetPySystemFromInstanceId(instanceId);
+			std::replace(m_PySystems.begin(), m_PySystems.end(), previousPySystem, newPySystem);
+			const auto nameIt = m_PySystemsByName.find(className);
+			if (nameIt != m_PySystemsByName.end() && nameIt->second == previousPySystem)
+			{
+				nameIt->second = newPySystem;
+			}
+			m_PythonInstances[instanceId] = std::move(newInstance);
+			m_InstanceIds.erase(previousPySystem);
+			m_InstanceIds[newPySystem] = instanceId;
+			//The reloaded class may override other hooks
+			RemoveHookSystem(previousPySystem);
+			CacheHooks(instanceId, true);
+			AddHookSystem(newPySystem, m_InstanceHooks[instanceId]);
+			newPySystem->OnEngineInit();
+			swappedPySystems.emplace_back(previousPySystem, newPySystem);
+		}
+		catch (std::runtime_error& e)
+		{
+			std::stringstream oss;
+			oss << "[PYTHON ERROR] trying to instantiate reloaded class: " << className << "\n" << e.what();
+			Log::GetInstance()->Error(oss.str());
+		}
+	}
+	return swappedPySystems;
+}
 
 PySystem* PySystemManager::GetPySystemFromInstanceId(InstanceId instanceId)
 {
-	if (instanceId > m_IncrementalInstanceId)
+	py::gil_scoped_acquire gil;
+	if (instanceId == INVALID_INSTANCE || instanceId >= m_PythonInstances.size())
 	{
 		std::ostringstream oss;
 		oss << "[Python Error] Could not find instance Id: " << instanceId << " in the pythonInstanceMap";
@@ -245,23 +293,282 @@ void PySystemManager::Destroy()
 {
 	System::Destroy();
 	m_PySystems.clear();
-	m_PythonInstances.clear();
+	for (auto& hookSystems : m_HookSystems)
+	{
+		hookSystems.clear();
+	}
+	m_PySystemsByName.clear();
+	m_InstanceIds.clear();
+	m_InstanceHooks.resize(1);
+	m_InstanceHooks[0] = PySystemHooks();
+	m_PySystemNames.resize(1);
+	m_InstanceModuleIds.resize(1);
+	m_PythonInstances.resize(1);
+	m_PythonInstances[0] = py::object();
+	m_PythonProfiler = py::object();
+	m_PythonProfiling = false;
+}
+
+PySystem *PySystemManager::GetPySystemFromClassName(const std::string& className)
+{
+	const auto systemIt = m_PySystemsByName.find(className);
+	return systemIt == m_PySystemsByName.end() ? nullptr : systemIt->second;
+}
+
+std::vector<PySystem*>& PySystemManager::GetPySystems()
+{
+	return m_PySystems;
+}
+
+bool PySystemManager::HasHook(const PySystem* pySystem, PySystemHook hook) const
+{
+	const auto instanceIt = m_InstanceIds.find(pySystem);
+	if (instanceIt == m_InstanceIds.end())
+		return false;
+	const auto& hooks = m_InstanceHooks[instanceIt->second];
+	return !hooks.pythonClass || hooks.functions[static_cast<size_t>(hook)];
 }
 
-PySystem *PySystemManager::GetPySystemFromClassName(std::string className)
+const std::vector<PySystem*>& PySystemManager::GetHookSystems(PySystemHook hook) const
 {
-	for(auto i = 0u; i< m_PySystemNames.size();i++)
+	return m_HookSystems[static_cast<size_t>(hook)];
+}
+
+/**
+* \brief Python names of the System hooks, in PySystemHook order
+*/
+static const char* pySystemHookNames[static_cast<size_t>(PySystemHook::LENGTH)] =
+{
+	"init",
+	"update",
+	"fixed_update",
+	"on_draw",
+	"on_contact"
+};
+
+void PySystemManager::CacheHooks(InstanceId instanceId, bool pythonClass)
+{
+	auto& hooks = m_InstanceHooks[instanceId];
+	hooks = PySystemHooks();
+	hooks.instance = m_PythonInstances[instanceId];
+	hooks.pythonClass = pythonClass;
+	hooks.name = m_PySystemNames[instanceId];
+	if (!pythonClass)
+		return;
+	const py::object systemClass = py::module::import("SFGE").attr("System");
+	const py::handle instanceClass = hooks.instance.get_type();
+	for (size_t i = 0; i < hooks.functions.size(); i++)
 	{
-		if(m_PySystemNames[i] == className)
+		//The unbound function, a bound method would keep the instance alive from its own C++ object
+		py::object function = instanceClass.attr(pySystemHookNames[i]);
+		if (!function.is(systemClass.attr(pySystemHookNames[i])))
 		{
-			return m_PySystems[i];
+			hooks.functions[i] = std::move(function);
 		}
 	}
-	return nullptr;
 }
 
-std::vector<PySystem*>& PySystemManager::GetPySystems()
+PySystemHooks* PySystemManager::GetHooks(PySystem* pySystem)
 {
-	return m_PySystems;
+	const auto instanceIt = m_InstanceIds.find(pySystem);
+	return instanceIt == m_InstanceIds.end() ? nullptr : &m_InstanceHooks[instanceIt->second];
+}
+
+template<typename TCall, typename ...TArgs>
+void PySystemManager::CallHook(const std::vector<PySystem*>& pySystems, PySystemHook hook, const char* phaseName, TCall cppCall, TArgs... args)
+{
+	//A scene with only native systems never takes the GIL
+	if (pySystems.empty())
+		return;
+	py::gil_scoped_acquire gil;
+	py::object setProfile;
+	if (m_PythonProfiling)
+	{
+		setProfile = py::module::import("sys").attr("setprofile");
+		setProfile(m_PythonProfiler);
+	}
+	//By index, a hook loading a scene may add systems to the list
+	for (size_t systemIndex = 0; systemIndex < pySystems.size(); systemIndex++)
+	{
+		auto* pySystem = pySystems[systemIndex];
+		if (pySystem == nullptr)
+			continue;
+		auto* hooks = GetHooks(pySystem);
+		const py::object* function = nullptr;
+		if (hooks != nullptr && hooks->pythonClass)
+		{
+			function = &hooks->functions[static_cast<size_t>(hook)];
+			if (!*function)
+				continue;
+		}
+		if (hooks != nullptr)
+		{
+			RMT_OPTIONAL(RMT_ENABLED, _rmt_BeginCPUSample(hooks->name.c_str(), 0, &hooks->sampleHash));
+		}
+		const sf::Clock hookClock;
+		try
+		{
+			if (function == nullptr)
+			{
+				cppCall(pySystem);
+			}
+			else
+			{
+				(*function)(hooks->instance, args...);
+			}
+		}
+		catch (std::runtime_error& e)
+		{
+			std::ostringstream oss;
+			oss << "Python error on PySystem " << phaseName << "\n" << e.what();
+			Log::GetInstance()->Error(oss.str());
+		}
+		if (hooks != nullptr)
+		{
+			hooks->profile.AddTime(hook, hookClock.getElapsedTime().asMicroseconds() / 1000.0f);
+			rmt_EndCPUSample();
+		}
+	}
+	if (setProfile)
+	{
+		setProfile(py::none());
+	}
+}
+
+void PySystemManager::InitSystems(const std::vector<PySystem*>& pySystems)
+{
+	CallHook(pySystems, PySystemHook::INIT, "Init", [](PySystem* pySystem) { pySystem->OnEngineInit(); });
+}
+
+void PySystemManager::UpdateSystems(const std::vector<PySystem*>& pySystems, float dt)
+{
+	CallHook(pySystems, PySystemHook::UPDATE, "Update", [dt](PySystem* pySystem) { pySystem->OnUpdate(dt); }, dt);
+}
+
+void PySystemManager::FixedUpdateSystems(const std::vector<PySystem*>& pySystems)
+{
+	CallHook(pySystems, PySystemHook::FIXED_UPDATE, "FixedUpdate", [](PySystem* pySystem) { pySystem->OnFixedUpdate(); });
+}
+
+void PySystemManager::DrawSystems(const std::vector<PySystem*>& pySystems)
+{
+	CallHook(pySystems, PySystemHook::DRAW, "Draw", [](PySystem* pySystem) { pySystem->OnDraw(); });
+}
+
+void PySystemManager::ContactSystems(ColliderData* c1, ColliderData* c2, bool enter)
+{
+	CallHook(m_HookSystems[static_cast<size_t>(PySystemHook::CONTACT)], PySystemHook::CONTACT, "Contact",
+		[c1, c2, enter](PySystem* pySystem) { pySystem->OnContact(c1, c2, enter); }, c1, c2, enter);
+}
+
+std::vector<const PySystemHooks*> PySystemManager::GetProfiledSystems() const
+{
+	std::vector<const PySystemHooks*> profiledSystems;
+	for (InstanceId instanceId = 1U; instanceId < m_InstanceHooks.size(); instanceId++)
+	{
+		if (m_InstanceHooks[instanceId].instance)
+		{
+			profiledSystems.push_back(&m_InstanceHooks[instanceId]);
+		}
+	}
+	return profiledSystems;
+}
+
+/**
+* \brief Profile function of sys.setprofile, the durations are keyed by code object and formatted only when asked
+*/
+static const char* pythonProfilerSource =
+	"import time\n"
+	"class HookProfiler:\n"
+	"    def __init__(self):\n"
+	"        self.times = {}\n"
+	"        self.starts = []\n"
+	"    def __call__(self, frame, event, arg):\n"
+	"        if event == 'call':\n"
+	"            self.starts.append(time.perf_counter())\n"
+	"        elif event == 'return' and self.starts:\n"
+	"            duration = time.perf_counter() - self.starts.pop()\n"
+	"            entry = self.times.setdefault(frame.f_code, [0.0, 0])\n"
+	"            entry[0] += duration\n"
+	"            entry[1] += 1\n"
+	"    def hotspots(self, count):\n"
+	"        items = sorted(self.times.items(), key=lambda item: item[1][0], reverse=True)[:count]\n"
+	"        return [('%s:%d %s' % (code.co_filename, code.co_firstlineno, code.co_name), entry[0] * 1000.0, entry[1])\n"
+	"                for code, entry in items]\n"
+	"    def reset(self):\n"
+	"        self.times.clear()\n"
+	"        self.starts.clear()\n"
+	"profiler = HookProfiler()\n";
+
+void PySystemManager::SetPythonProfiling(bool pythonProfiling)
+{
+	py::gil_scoped_acquire gil;
+	if (pythonProfiling && !m_PythonProfiler)
+	{
+		try
+		{
+			const py::dict locals;
+			py::eval<py::eval_statements>(pythonProfilerSource, py::globals(), locals);
+			m_PythonProfiler = locals["profiler"];
+		}
+		catch (std::runtime_error& e)
+		{
+			std::ostringstream oss;
+			oss << "[PYTHON ERROR] Could not create the hook profiler\n" << e.what();
+			Log::GetInstance()->Error(oss.str());
+			return;
+		}
+	}
+	m_PythonProfiling = pythonProfiling;
+}
+
+bool PySystemManager::IsPythonProfiling() const
+{
+	return m_PythonProfiling;
+}
+
+std::vector<PyHotspot> PySystemManager::GetPythonHotspots(size_t count)
+{
+	std::vector<PyHotspot> hotspots;
+	if (!m_PythonProfiler)
+		return hotspots;
+	py::gil_scoped_acquire gil;
+	const auto entries = m_PythonProfiler.attr("hotspots")(count).cast<std::vector<std::tuple<std::string, float, size_t>>>();
+	for (auto& entry : entries)
+	{
+		hotspots.push_back({ std::get<0>(entry), std::get<1>(entry), std::get<2>(entry) });
+	}
+	return hotspots;
+}
+
+void PySystemManager::ResetPythonHotspots()
+{
+	if (!m_PythonProfiler)
+		return;
+	py::gil_scoped_acquire gil;
+	m_PythonProfiler.attr("reset")();
+}
+
+void PySystemProfile::AddTime(PySystemHook hook, float time)
+{
+	const auto hookIndex = static_cast<size_t>(hook);
+	history[hookIndex][sampleCounts[hookIndex] % HISTORY_LENGTH] = time;
+	sampleCounts[hookIndex]++;
+	maxTime = std::max(maxTime, time);
+}
+
+float PySystemProfile::GetAverageTime(PySystemHook hook) const
+{
+	const auto hookIndex = static_cast<size_t>(hook);
+	const size_t sampleNmb = std::min(sampleCounts[hookIndex], HISTORY_LENGTH);
+	if (sampleNmb == 0)
+		return 0.0f;
+	return std::accumulate(history[hookIndex].begin(), history[hookIndex].begin() + sampleNmb, 0.0f) / sampleNmb;
+}
+
+size_t PySystemProfile::GetHistoryOffset(PySystemHook hook) const
+{
+	const auto hookIndex = static_cast<size_t>(hook);
+	return sampleCounts[hookIndex] < HISTORY_LENGTH ? 0 : sampleCounts[hookIndex] % HISTORY_LENGTH;
 }
 }
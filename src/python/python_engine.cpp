@@ -35,6 +35,7 @@
 #include <imgui.h>
 #include <pybind11/operators.h>
 #include <pybind11/stl.h>
+#include <pybind11/numpy.h>
 
 #include <python/python_engine.h>
 #include <utility/log.h>
@@ -61,6 +62,28 @@
 namespace sfge
 {
 
+/**
+* \brief Numpy view without copy over a component array, one row per entity starting at entity 1.
+* The view keeps the manager alive but becomes invalid when the entities are resized, so it is taken again each frame
+*/
+template<typename TValue>
+static py::array GetComponentArrayView(const TValue* first, size_t count, size_t stride, size_t columns, py::handle owner, bool writeable = true)
+{
+	std::vector<py::ssize_t> shape{ static_cast<py::ssize_t>(count) };
+	std::vector<py::ssize_t> strides{ static_cast<py::ssize_t>(stride) };
+	if (columns > 1)
+	{
+		shape.push_back(static_cast<py::ssize_t>(columns));
+		strides.push_back(static_cast<py::ssize_t>(sizeof(TValue)));
+	}
+	py::array view(py::dtype::of<TValue>(), shape, strides, first, owner);
+	if (!writeable)
+	{
+		view.attr("flags").attr("writeable") = false;
+	}
+	return view;
+}
+
 PYBIND11_EMBEDDED_MODULE(SFGE, m)
 {
 	py::class_<Engine> engine(m, "Engine");
@@ -72,7 +95,8 @@ PYBIND11_EMBEDDED_MODULE(SFGE, m)
 
 	py::class_<Configuration, std::unique_ptr<Configuration, py::nodelete>> config(m, "Configuration");
 	config
-		.def_property_readonly("screen_size", [](Configuration* config) {return Vec2f(config->screenResolution.x, config->screenResolution.y); });
+		.def_property_readonly("screen_size", [](Configuration* config) {return Vec2f(config->screenResolution.x, config->screenResolution.y); })
+		.def_readonly("fixed_delta_time", &Configuration::fixedDeltaTime);
 	py::class_<System, PySystem> system(m, "System");
 	system
 		.def(py::init<Engine&>(), py::return_value_policy::reference)
@@ -80,13 +104,76 @@ PYBIND11_EMBEDDED_MODULE(SFGE, m)
 		.def("update", &System::OnUpdate)
 		.def("fixed_update", &System::OnFixedUpdate)
 		.def("on_draw", &System::OnDraw)
-		.def("on_contact", &System::OnContact);
+		.def("on_contact", &System::OnContact)
+		.def("set_component_access", [](System* system, std::vector<ComponentType> readComponents, std::vector<ComponentType> writeComponents)
+		{
+			int readMask = 0;
+			int writeMask = 0;
+			for (auto componentType : readComponents)
+				readMask |= static_cast<int>(componentType);
+			for (auto componentType : writeComponents)
+				writeMask |= static_cast<int>(componentType);
+			system->SetComponentAccess(readMask, writeMask);
+		});
 
 	py::class_<SceneManager> sceneManager(m, "SceneManager");
 	sceneManager
 		.def(py::init<Engine&>(), py::return_value_policy::reference)
-		.def("load_scene", &SceneManager::LoadSceneFromName)
-		.def("get_scenes", &SceneManager::GetAllScenes);
+		//The long calls release the GIL for the Python threads, the engine takes it back to load the scene PySystems
+		.def("load_scene", &SceneManager::LoadSceneFromName, py::call_guard<py::gil_scoped_release>())
+		.def("get_scenes", &SceneManager::GetAllScenes, py::call_guard<py::gil_scoped_release>())
+		.def("cook_scene", &SceneManager::CookScene, py::call_guard<py::gil_scoped_release>())
+		.def("preload_scene", &SceneManager::PreloadScene, py::call_guard<py::gil_scoped_release>())
+		.def("is_scene_preloaded", &SceneManager::IsScenePreloaded)
+		.def("activate_scene", &SceneManager::ActivateScene, py::call_guard<py::gil_scoped_release>())
+		.def("spawn", [](SceneManager* sceneManager, size_t count, const std::vector<ComponentType>& archetype,
+			py::object positions, py::object velocities, const std::string& texturePath, py::object bodyType)
+		{
+			using FloatArray = py::array_t<float, py::array::c_style | py::array::forcecast>;
+			EntitySpawnDef spawnDef;
+			for (auto componentType : archetype)
+				spawnDef.archetype |= static_cast<int>(componentType);
+			spawnDef.texturePath = texturePath;
+			//The BodyType enum is bound after the SceneManager, it cannot be a default argument
+			if (!bodyType.is_none())
+				spawnDef.bodyType = bodyType.cast<p2BodyType>();
+			//The numpy arrays are read in place, the other sequences are copied, both kept alive until the end of the spawn
+			FloatArray positionArray;
+			FloatArray velocityArray;
+			std::vector<float> positionValues;
+			std::vector<float> velocityValues;
+			const auto getValues = [count](py::object& values, FloatArray& array, std::vector<float>& copiedValues, const char* error) -> const float*
+			{
+				if (values.is_none())
+					return nullptr;
+				const float* data = nullptr;
+				size_t size = 0;
+				if (py::isinstance<py::buffer>(values))
+				{
+					array = values.cast<FloatArray>();
+					data = array.data();
+					size = static_cast<size_t>(array.size());
+				}
+				else
+				{
+					for (auto value : values)
+					{
+						const auto pair = value.cast<std::vector<float>>();
+						copiedValues.insert(copiedValues.end(), pair.begin(), pair.end());
+					}
+					data = copiedValues.data();
+					size = copiedValues.size();
+				}
+				if (size != count * 2)
+					throw py::value_error(error);
+				return data;
+			};
+			spawnDef.positions = getValues(positions, positionArray, positionValues, "spawn positions needs one (x, y) per entity");
+			spawnDef.velocities = getValues(velocities, velocityArray, velocityValues, "spawn velocities needs one (x, y) per entity");
+			py::gil_scoped_release release;
+			return sceneManager->SpawnEntities(count, spawnDef);
+		}, py::arg("count"), py::arg("archetype"), py::arg("positions") = py::none(), py::arg("velocities") = py::none(),
+			py::arg("texture_path") = "", py::arg("body_type") = py::none());
 
 	py::class_<InputManager> inputManager(m, "InputManager");
 	inputManager
@@ -119,7 +206,22 @@ PYBIND11_EMBEDDED_MODULE(SFGE, m)
 	transform2dManager
 	    .def(py::init<Engine&>(), py::return_value_policy::reference)
 		.def("add_component", &Transform2dManager::AddComponent, py::return_value_policy::reference)
-	    .def("get_component", &Transform2dManager::GetComponentRef, py::return_value_policy::reference);
+	    .def("get_component", &Transform2dManager::GetComponentRef, py::return_value_policy::reference)
+		.def_property_readonly("positions", [](py::object self)
+		{
+			auto& transforms = self.cast<Transform2dManager&>().GetComponents();
+			return GetComponentArrayView(&transforms.data()->Position.x, transforms.size(), sizeof(Transform2d), 2, self);
+		})
+		.def_property_readonly("scales", [](py::object self)
+		{
+			auto& transforms = self.cast<Transform2dManager&>().GetComponents();
+			return GetComponentArrayView(&transforms.data()->Scale.x, transforms.size(), sizeof(Transform2d), 2, self);
+		})
+		.def_property_readonly("angles", [](py::object self)
+		{
+			auto& transforms = self.cast<Transform2dManager&>().GetComponents();
+			return GetComponentArrayView(&transforms.data()->EulerAngle, transforms.size(), sizeof(Transform2d), 1, self);
+		});
 
 	py::class_<EntityManager> entityManager(m, "EntityManager");
 	entityManager
@@ -128,8 +230,14 @@ PYBIND11_EMBEDDED_MODULE(SFGE, m)
 	    .def("destroy_entity", &EntityManager::DestroyEntity)
 		.def("get_entity", &EntityManager::GetEntityByName)
 	    .def("has_component", &EntityManager::HasComponent)
-		.def("resize", &EntityManager::ResizeEntityNmb)
-		.def("get_entities_with_type", &EntityManager::GetEntitiesWithType);
+		.def("resize", &EntityManager::ResizeEntityNmb, py::call_guard<py::gil_scoped_release>())
+		.def("get_entities_with_type", &EntityManager::GetEntitiesWithType, py::call_guard<py::gil_scoped_release>())
+		.def_property_readonly("masks", [](py::object self)
+		{
+			//Read only, the components are added and removed through the managers
+			auto& masks = self.cast<EntityManager&>().GetMasks();
+			return GetComponentArrayView(masks.data(), masks.size(), sizeof(EntityMask), 1, self, false);
+		});
 
 	py::class_<Physics2dManager> physics2dManager(m, "Physics2dManager");
 	physics2dManager
@@ -146,16 +254,73 @@ PYBIND11_EMBEDDED_MODULE(SFGE, m)
 	py::class_<Body2dManager> body2dManager(m, "Body2dManager");
 	body2dManager
 	    .def("add_component", &Body2dManager::AddComponent, py::return_value_policy::reference)
-	    .def("get_component", &Body2dManager::GetComponentRef, py::return_value_policy::reference);
+	    .def("get_component", &Body2dManager::GetComponentRef, py::return_value_policy::reference)
+		.def_property_readonly("velocities", [](py::object self)
+		{
+			auto& velocities = self.cast<Body2dManager&>().GetLinearVelocities();
+			return GetComponentArrayView(&velocities.data()->x, velocities.size(), sizeof(p2Vec2), 2, self);
+		})
+		.def_property_readonly("forces", [](py::object self)
+		{
+			auto& forces = self.cast<Body2dManager&>().GetForces();
+			return GetComponentArrayView(&forces.data()->x, forces.size(), sizeof(p2Vec2), 2, self);
+		});
 
 	py::class_<Graphics2dManager> graphics2dManager(m, "Graphics2dManager");
 	graphics2dManager
 	    .def(py::init<Engine&>(), py::return_value_policy::reference)
 	    .def("draw_line", &Graphics2dManager::DrawLine)
 	    .def("draw_vector", &Graphics2dManager::DrawVector)
+		.def_property_readonly("debug_draw", &Graphics2dManager::GetDebugDraw, py::return_value_policy::reference)
 		.def_property_readonly("sprite_manager", &Graphics2dManager::GetSpriteManager, py::return_value_policy::reference)
 		.def_property_readonly("texture_manager", &Graphics2dManager::GetTextureManager, py::return_value_policy::reference)
-		.def_property_readonly("shape_manager", &Graphics2dManager::GetShapeManager, py::return_value_policy::reference);
+		.def_property_readonly("shape_manager", &Graphics2dManager::GetShapeManager, py::return_value_policy::reference)
+		.def_property_readonly("animation2d_manager", &Graphics2dManager::GetAnimation2dManager, py::return_value_policy::reference);
+
+	py::class_<Animation2dManager> animation2dManager(m, "Animation2dManager");
+	animation2dManager
+		.def("add_component", &Animation2dManager::AddComponent, py::return_value_policy::reference)
+		.def("get_component", &Animation2dManager::GetComponentPtr, py::return_value_policy::reference)
+		.def("load_clip", &Animation2dManager::LoadClip, py::call_guard<py::gil_scoped_release>())
+		.def("set_clip", &Animation2dManager::SetClip);
+
+	py::class_<Animation2d> animation2d(m, "Animation2d");
+	animation2d
+		.def_readwrite("speed", &Animation2d::speed)
+		.def_readwrite("time", &Animation2d::time)
+		.def_readonly("clip_id", &Animation2d::clipId)
+		.def_readonly("current_frame", &Animation2d::currentFrame);
+
+	py::class_<DebugDraw> debugDraw(m, "DebugDraw");
+	debugDraw
+		.def("set_category_enabled", &DebugDraw::SetCategoryEnabled)
+		.def("is_category_enabled", &DebugDraw::IsCategoryEnabled)
+		.def("draw_line", &DebugDraw::DrawLine,
+			py::arg("from_vec"), py::arg("to_vec"), py::arg("color"), py::arg("category") = DebugDrawCategory::GENERAL)
+		.def("draw_lines", [](DebugDraw* debugDraw, const std::vector<Vec2f>& points, sf::Color color, DebugDrawCategory category)
+		{
+			if (!points.empty())
+				debugDraw->DrawLines(&points[0].x, points.size(), color, category);
+		}, py::arg("points"), py::arg("color"), py::arg("category") = DebugDrawCategory::GENERAL)
+		.def("draw_lines", [](DebugDraw* debugDraw, py::array_t<float, py::array::c_style | py::array::forcecast> points,
+			sf::Color color, DebugDrawCategory category)
+		{
+			//Accepts (n, 2) points or (n, 4) segments, the memory layout is the same
+			debugDraw->DrawLines(points.data(), static_cast<size_t>(points.size() / 2), color, category);
+		}, py::arg("points"), py::arg("color"), py::arg("category") = DebugDrawCategory::GENERAL)
+		.def("draw_circle", &DebugDraw::DrawCircle,
+			py::arg("center"), py::arg("radius"), py::arg("color"), py::arg("category") = DebugDrawCategory::GENERAL)
+		.def("draw_box", &DebugDraw::DrawBox,
+			py::arg("center"), py::arg("size"), py::arg("angle"), py::arg("color"), py::arg("category") = DebugDrawCategory::GENERAL)
+		.def("draw_text", &DebugDraw::DrawText,
+			py::arg("position"), py::arg("text"), py::arg("color"), py::arg("category") = DebugDrawCategory::GENERAL);
+
+	py::enum_<DebugDrawCategory>(debugDraw, "Category")
+		.value("General", DebugDrawCategory::GENERAL)
+		.value("Physics", DebugDrawCategory::PHYSICS)
+		.value("Vector", DebugDrawCategory::VECTOR)
+		.value("Raycast", DebugDrawCategory::RAYCAST)
+		.export_values();
 
 	py::class_<TextureManager> textureManager(m, "texture_manager");
 	textureManager
@@ -206,6 +371,7 @@ PYBIND11_EMBEDDED_MODULE(SFGE, m)
 		.value("Sprite", ComponentType::SPRITE2D)
 		.value("Sound", ComponentType::SOUND)
 		.value("Transform2d", ComponentType::TRANSFORM2D)
+		.value("Animation2d", ComponentType::ANIMATION2D)
 		.export_values();
 
 	py::class_<Transform2d> transform(m, "Transform2d");
@@ -446,7 +612,16 @@ void PythonEngine::OnEngineInit()
 		oss << "[ERROR] Python already set error: " << e.what();
 		Log::GetInstance()->Error(oss.str());
 	}
-	LoadScripts();
+	const auto* config = m_Engine.GetConfig();
+	//Lazily, the scene systems import their script at the scene loading
+	if (config == nullptr)
+	{
+		LoadScripts();
+	}
+	else if (!config->lazyScripts)
+	{
+		LoadScripts(config->scriptsDirname);
+	}
 }
 
 void PythonEngine::InitScriptsInstances()
@@ -490,6 +665,8 @@ void PythonEngine::OnBeforeSceneLoad()
 
 ModuleId PythonEngine::LoadPyModule(std::string moduleFilename)
 {
+	//Also called by the scene loading, which runs without the GIL when started from Python
+	py::gil_scoped_acquire gil;
 	const auto folderLastIndex = moduleFilename.find_last_of('/');
 	std::string filename = moduleFilename.substr(folderLastIndex + 1, moduleFilename.size());
 	const auto filenameExtensionIndex = filename.find_last_of('.');
@@ -523,7 +700,7 @@ ModuleId PythonEngine::LoadPyModule(std::string moduleFilename)
 			{
 				moduleId = m_IncrementalModuleId;
                 py::dict globals = py::globals ();
-				m_PyModuleObjs[moduleId-1] = import(moduleName, moduleFilename, globals);
+				m_PyModuleObjs[moduleId-1] = import(moduleName, moduleFilename, globals, GetScriptCacheDirname());
 				m_PyModuleNames[moduleId-1] = moduleName;
 				m_PythonModulePaths[moduleId-1] = moduleFilename;
 				m_PyClassNames[moduleId-1] = className;
@@ -560,6 +737,46 @@ ModuleId PythonEngine::LoadPyModule(std::string moduleFilename)
 
 
 
+bool PythonEngine::ReloadPyModule(const std::string& moduleFilename)
+{
+	ModuleId moduleId = INVALID_MODULE;
+	for (ModuleId testedModuleId = 1U; testedModuleId < m_IncrementalModuleId; testedModuleId++)
+	{
+		if (m_PythonModulePaths[testedModuleId - 1] == moduleFilename)
+		{
+			moduleId = testedModuleId;
+			break;
+		}
+	}
+	if (moduleId == INVALID_MODULE)
+		return false;
+	try
+	{
+		py::dict globals = py::globals();
+		//The previous module is kept if the new script does not import
+		m_PyModuleObjs[moduleId - 1] = import(m_PyModuleNames[moduleId - 1], moduleFilename, globals, GetScriptCacheDirname());
+	}
+	catch (const std::runtime_error& e)
+	{
+		std::stringstream oss;
+		oss << "[PYTHON ERROR] on reloaded script file: " << moduleFilename << "\n" << e.what();
+		Log::GetInstance()->Error(oss.str());
+		return true;
+	}
+	{
+		std::ostringstream oss;
+		oss << "Reloading module: " << m_PyModuleNames[moduleId - 1];
+		Log::GetInstance()->Msg(oss.str());
+	}
+	SpreadClasses();
+	auto* sceneManager = m_Engine.GetSceneManager();
+	for (auto& swappedPySystem : m_PySystemManager.ReloadPySystems(moduleId))
+	{
+		sceneManager->ReplacePySystem(swappedPySystem.first, swappedPySystem.second);
+	}
+	return true;
+}
+
 void PythonEngine::OnAfterSceneLoad()
 {
 }
@@ -612,6 +829,11 @@ void PythonEngine::SpreadClasses()
 
     }
 }
+std::string PythonEngine::GetScriptCacheDirname() const
+{
+	const auto* config = m_Engine.GetConfig();
+	return config == nullptr ? "" : config->scriptCacheDirname;
+}
 const std::string &PythonEngine::GetClassNameFrom(ModuleId moduleId)
 {
 	return m_PyClassNames[moduleId-1];
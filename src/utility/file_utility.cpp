@@ -24,6 +24,23 @@
 #include <utility/file_utility.h>
 #include "utility/log.h"
 #include <sstream>
+#include <algorithm>
+#include <tuple>
+
+#ifdef WIN32
+#define NOMINMAX
+#include <windows.h>
+#undef CreateDirectory
+#undef RemoveDirectory
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #ifdef __APPLE__
 
@@ -69,6 +86,16 @@ std::ifstream::pos_type CalculateFileSize(const std::string& filename)
 	std::ifstream in(filename, std::ifstream::binary | std::ifstream::ate);
 	return in.tellg();
 }
+
+long long GetFileModificationTime(const std::string& filename)
+{
+	fs::path p = filename;
+#ifdef __APPLE__
+	return static_cast<long long>(fs::last_write_time(p));
+#else
+	return static_cast<long long>(fs::last_write_time(p).time_since_epoch().count());
+#endif
+}
 bool CreateDirectory(const std::string& dirname)
 {
 	return fs::create_directory(dirname);
@@ -84,6 +111,37 @@ bool RemoveDirectory(const std::string &dirname, bool removeAll)
 	}
 }
 
+size_t PruneDirectory(const std::string& dirname, size_t maxSize)
+{
+	std::string folder = dirname;
+	if (!IsDirectory(folder))
+		return 0;
+	std::vector<std::tuple<long long, size_t, std::string>> files;
+	size_t totalSize = 0;
+	for (auto& p : fs::directory_iterator(folder))
+	{
+		if (!fs::is_regular_file(p.path()))
+			continue;
+		const std::string path = p.path().generic_string();
+		const auto fileSize = static_cast<size_t>(fs::file_size(p.path()));
+		files.emplace_back(GetFileModificationTime(path), fileSize, path);
+		totalSize += fileSize;
+	}
+	std::sort(files.begin(), files.end());
+	size_t removedFiles = 0;
+	for (auto& file : files)
+	{
+		if (totalSize <= maxSize)
+			break;
+		if (fs::remove(std::get<2>(file)))
+		{
+			totalSize -= std::get<1>(file);
+			removedFiles++;
+		}
+	}
+	return removedFiles;
+}
+
 const std::string LoadFile(std::string path)
 {
 	std::ifstream t(path);
@@ -108,4 +166,249 @@ std::string GetFilenameExtension(std::string path)
 	extension = filename.substr(filenameExtensionIndex);
 	return extension;
 }
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::Open(const std::string& path)
+{
+	Close();
+#ifdef WIN32
+	HANDLE fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseHandle(fileHandle);
+		return false;
+	}
+	HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mappingHandle == nullptr)
+	{
+		CloseHandle(fileHandle);
+		return false;
+	}
+	const void* data = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if (data == nullptr)
+	{
+		CloseHandle(mappingHandle);
+		CloseHandle(fileHandle);
+		return false;
+	}
+	m_FileHandle = fileHandle;
+	m_MappingHandle = mappingHandle;
+	m_Size = static_cast<size_t>(fileSize.QuadPart);
+	m_Data = static_cast<const char*>(data);
+#else
+	const int fileDescriptor = open(path.c_str(), O_RDONLY);
+	if (fileDescriptor == -1)
+	{
+		return false;
+	}
+	struct stat fileStat{};
+	if (fstat(fileDescriptor, &fileStat) == -1 || fileStat.st_size == 0)
+	{
+		close(fileDescriptor);
+		return false;
+	}
+	void* data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+	if (data == MAP_FAILED)
+	{
+		close(fileDescriptor);
+		return false;
+	}
+	m_FileDescriptor = fileDescriptor;
+	m_Size = static_cast<size_t>(fileStat.st_size);
+	m_Data = static_cast<const char*>(data);
+#endif
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_Data == nullptr)
+	{
+		return;
+	}
+#ifdef WIN32
+	UnmapViewOfFile(m_Data);
+	CloseHandle(m_MappingHandle);
+	CloseHandle(m_FileHandle);
+	m_MappingHandle = nullptr;
+	m_FileHandle = nullptr;
+#else
+	munmap(const_cast<char*>(m_Data), m_Size);
+	close(m_FileDescriptor);
+	m_FileDescriptor = -1;
+#endif
+	m_Data = nullptr;
+	m_Size = 0;
+}
+
+const char* MappedFile::GetData() const
+{
+	return m_Data;
+}
+
+size_t MappedFile::GetSize() const
+{
+	return m_Size;
+}
+
+FileWatcher::~FileWatcher()
+{
+	Stop();
+}
+
+bool FileWatcher::Watch(const std::string& dirname)
+{
+	std::string watchedDirname = dirname;
+	while (watchedDirname.size() > 1 && watchedDirname.back() == '/')
+	{
+		watchedDirname.pop_back();
+	}
+	if (!IsDirectory(watchedDirname))
+	{
+		std::ostringstream oss;
+		oss << "[Error] Cannot watch: " << dirname << " is not a folder";
+		Log::GetInstance()->Error(oss.str());
+		return false;
+	}
+#ifdef __linux__
+	if (m_InotifyDescriptor == -1)
+	{
+		m_InotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (m_InotifyDescriptor == -1)
+		{
+			Log::GetInstance()->Error("[Error] Could not initialize inotify");
+			return false;
+		}
+	}
+	AddWatch(watchedDirname);
+#else
+	m_WatchedDirnames.push_back(watchedDirname);
+	//The files already there are not reported
+	std::set<std::string> existingFiles;
+	ScanDirectory(watchedDirname, existingFiles);
+	m_LastScanTime = std::chrono::steady_clock::now();
+#endif
+	return true;
+}
+
+void FileWatcher::Stop()
+{
+#ifdef __linux__
+	if (m_InotifyDescriptor != -1)
+	{
+		close(m_InotifyDescriptor);
+		m_InotifyDescriptor = -1;
+	}
+	m_WatchedDirnames.clear();
+#else
+	m_WatchedDirnames.clear();
+	m_ModificationTimes.clear();
+#endif
+}
+
+std::vector<std::string> FileWatcher::Poll()
+{
+	std::set<std::string> changedFiles;
+#ifdef __linux__
+	if (m_InotifyDescriptor == -1)
+	{
+		return {};
+	}
+	alignas(inotify_event) char buffer[16 * 1024];
+	while (true)
+	{
+		const auto readSize = read(m_InotifyDescriptor, buffer, sizeof(buffer));
+		if (readSize <= 0)
+		{
+			break;
+		}
+		for (ssize_t offset = 0; offset < readSize;)
+		{
+			const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+			offset += sizeof(inotify_event) + event->len;
+			const auto dirnameIt = m_WatchedDirnames.find(event->wd);
+			if (dirnameIt == m_WatchedDirnames.end() || event->len == 0)
+				continue;
+			const std::string path = dirnameIt->second + "/" + event->name;
+			if (event->mask & IN_ISDIR)
+			{
+				AddWatch(path);
+			}
+			else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+			{
+				changedFiles.insert(path);
+			}
+		}
+	}
+#else
+	const auto scanTime = std::chrono::steady_clock::now();
+	if (scanTime - m_LastScanTime < std::chrono::seconds(1))
+	{
+		return {};
+	}
+	m_LastScanTime = scanTime;
+	for (auto& dirname : m_WatchedDirnames)
+	{
+		ScanDirectory(dirname, changedFiles);
+	}
+#endif
+	return std::vector<std::string>(changedFiles.begin(), changedFiles.end());
+}
+
+#ifdef __linux__
+void FileWatcher::AddWatch(const std::string& dirname)
+{
+	const int watchDescriptor = inotify_add_watch(m_InotifyDescriptor, dirname.c_str(),
+		IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+	if (watchDescriptor == -1)
+	{
+		std::ostringstream oss;
+		oss << "[Error] Could not watch folder: " << dirname;
+		Log::GetInstance()->Error(oss.str());
+		return;
+	}
+	m_WatchedDirnames[watchDescriptor] = dirname;
+	std::string subDirname = dirname;
+	IterateDirectory(subDirname, [this](std::string entry)
+	{
+		if (IsDirectory(entry))
+		{
+			AddWatch(entry);
+		}
+	});
+}
+#else
+void FileWatcher::ScanDirectory(std::string dirname, std::set<std::string>& changedFiles)
+{
+	IterateDirectory(dirname, [this, &changedFiles](std::string entry)
+	{
+		if (IsDirectory(entry))
+		{
+			ScanDirectory(entry, changedFiles);
+			return;
+		}
+		const auto modificationTime = GetFileModificationTime(entry);
+		const auto timeIt = m_ModificationTimes.find(entry);
+		if (timeIt == m_ModificationTimes.end())
+		{
+			m_ModificationTimes.emplace(entry, modificationTime);
+			changedFiles.insert(entry);
+		}
+		else if (timeIt->second != modificationTime)
+		{
+			timeIt->second = modificationTime;
+			changedFiles.insert(entry);
+		}
+	});
+}
+#endif
 }
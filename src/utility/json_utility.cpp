@@ -24,9 +24,11 @@ SOFTWARE.
 
 #include <utility/json_utility.h>
 #include <utility/log.h>
+#include <utility/pack_file.h>
 
 #include <fstream>
 #include <string>
+#include <vector>
 
 namespace sfge
 {
@@ -38,31 +40,36 @@ bool IsJsonValueNumeric(const json::value_type & jsonValue)
 		   jsonValue.type() == json::value_t::number_unsigned;
 }
 
-bool CheckJsonExists(const json & jsonObject, std::string parameterName)
+bool CheckJsonExists(const json & jsonObject, std::string_view parameterName)
 {
 	return jsonObject.find(parameterName) != jsonObject.end();
 }
 
-bool CheckJsonParameter(const json& jsonObject, std::string parameterName, json::value_t expectedType)
+bool CheckJsonParameter(const json& jsonObject, std::string_view parameterName, json::value_t expectedType)
 {
-	return CheckJsonExists(jsonObject, parameterName) && jsonObject[parameterName].type() == expectedType;
+	const auto parameterIt = jsonObject.find(parameterName);
+	return parameterIt != jsonObject.end() && parameterIt->type() == expectedType;
 }
 
-bool CheckJsonNumber(const json& jsonObject, std::string parameterName)
+bool CheckJsonNumber(const json& jsonObject, std::string_view parameterName)
 {
-	return CheckJsonParameter(jsonObject, parameterName, json::value_t::number_float) or
-		   CheckJsonParameter(jsonObject, parameterName, json::value_t::number_integer) or
-		   CheckJsonParameter(jsonObject, parameterName, json::value_t::number_unsigned);
+	const auto parameterIt = jsonObject.find(parameterName);
+	return parameterIt != jsonObject.end() && IsJsonValueNumeric(*parameterIt);
 }
 
-sf::Vector2f GetVectorFromJson(const json & jsonObject, std::string parameterName)
+sf::Vector2f GetVectorFromJson(const json & jsonObject, std::string_view parameterName)
 {
 	sf::Vector2f vector = sf::Vector2f();
-	if (CheckJsonParameter(jsonObject, parameterName, json::value_t::array))
+	const auto vectorIt = jsonObject.find(parameterName);
+	if (vectorIt == jsonObject.end())
 	{
-		if (jsonObject[parameterName].size() == 2)
+		return vector;
+	}
+	const auto& vectorJson = *vectorIt;
+	if (vectorJson.type() == json::value_t::array)
+	{
+		if (vectorJson.size() == 2)
 		{
-			auto vectorJson = jsonObject[parameterName];
 			if (IsJsonValueNumeric(vectorJson[0]))
 			{
 				vector.x = vectorJson[0];
@@ -73,14 +80,13 @@ sf::Vector2f GetVectorFromJson(const json & jsonObject, std::string parameterNam
 			}
 		}
 	}
-	else if (CheckJsonParameter(jsonObject, parameterName, json::value_t::object))
+	else if (vectorJson.type() == json::value_t::object)
 	{
-		auto vectorJson = jsonObject[parameterName];
-		if (IsJsonValueNumeric(vectorJson["x"]))
+		if (CheckJsonNumber(vectorJson, "x"))
 		{
 			vector.x = vectorJson["x"];
 		}
-		if (IsJsonValueNumeric(vectorJson["y"]))
+		if (CheckJsonNumber(vectorJson, "y"))
 		{
 			vector.y = vectorJson["y"];
 		}
@@ -88,10 +94,26 @@ sf::Vector2f GetVectorFromJson(const json & jsonObject, std::string parameterNam
 	return vector;
 }
 
-std::unique_ptr<json> LoadJson(std::string jsonPath)
+json GetJsonFromVector(sf::Vector2f vector)
+{
+	return json::array({ vector.x, vector.y });
+}
+
+/**
+* \brief Parse the json from the mounted pack if it contains the file, from the disk otherwise
+*/
+static std::unique_ptr<json> ParseJsonFile(const std::string& jsonPath, const json::parser_callback_t& callback)
 {
-	std::ifstream jsonFile(jsonPath.c_str());
-	if (jsonFile.peek() == std::ifstream::traits_type::eof())
+	const char* packedData = nullptr;
+	size_t packedSize = 0;
+	std::vector<char> packedBuffer;
+	const bool packed = ReadPackedFile(jsonPath, packedData, packedSize, packedBuffer);
+	std::ifstream jsonFile;
+	if (!packed)
+	{
+		jsonFile.open(jsonPath.c_str());
+	}
+	if (packed ? packedSize == 0 : jsonFile.peek() == std::ifstream::traits_type::eof())
 	{
 		{
 			std::ostringstream oss;
@@ -103,7 +125,14 @@ std::unique_ptr<json> LoadJson(std::string jsonPath)
 	std::unique_ptr<json> jsonContent = std::make_unique<json>();
 	try
 	{
-		jsonFile >> *jsonContent;
+		if (packed)
+		{
+			*jsonContent = json::parse(packedData, packedData + packedSize, callback);
+		}
+		else
+		{
+			*jsonContent = json::parse(jsonFile, callback);
+		}
 	}
 	catch (json::parse_error& e)
 	{
@@ -116,4 +145,14 @@ std::unique_ptr<json> LoadJson(std::string jsonPath)
 	}
 	return jsonContent;
 }
+
+std::unique_ptr<json> LoadJson(std::string jsonPath)
+{
+	return ParseJsonFile(jsonPath, nullptr);
+}
+
+std::unique_ptr<json> LoadJson(const std::string& jsonPath, const json::parser_callback_t& callback)
+{
+	return ParseJsonFile(jsonPath, callback);
+}
 }
@@ -29,6 +29,7 @@ namespace sfge
 
 void Log::Msg(const std::string & text)
 {
+	std::lock_guard<std::mutex> lock(m_Mutex);
 	std::cout << text << "\n" << std::flush;
 
 
@@ -36,6 +37,7 @@ void Log::Msg(const std::string & text)
 
 void Log::Error(const std::string & text)
 {
+	std::lock_guard<std::mutex> lock(m_Mutex);
 	std::cerr << text << "\n"<<std::flush;
 }
 
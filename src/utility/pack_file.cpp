@@ -0,0 +1,318 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+#ifdef SFGE_USE_LZ4
+#include <lz4.h>
+#endif
+#include <xxhash.hpp>
+
+#include <utility/pack_file.h>
+#include <utility/log.h>
+
+namespace sfge
+{
+
+/**
+* \brief The blobs are aligned so the mapped spans can be read as any type
+*/
+static const std::uint64_t packBlobAlignment = 16U;
+
+static std::unique_ptr<PackFile> mountedPack = nullptr;
+
+bool PackFile::Open(const std::string& packPath)
+{
+	Close();
+	if (!m_File.Open(packPath))
+	{
+		return false;
+	}
+	const auto fileSize = static_cast<std::uint64_t>(m_File.GetSize());
+	if (fileSize < sizeof(PackHeader))
+	{
+		Close();
+		return false;
+	}
+	const auto* header = reinterpret_cast<const PackHeader*>(m_File.GetData());
+	if (header->magic != PACK_MAGIC || header->version != PACK_VERSION ||
+		header->indexOffset > fileSize ||
+		static_cast<std::uint64_t>(header->entryCount) * sizeof(PackEntry) > fileSize - header->indexOffset)
+	{
+		std::ostringstream oss;
+		oss << "[ERROR] Pack file: " << packPath << " is corrupted or from another version";
+		Log::GetInstance()->Error(oss.str());
+		Close();
+		return false;
+	}
+	const auto* entries = reinterpret_cast<const PackEntry*>(m_File.GetData() + header->indexOffset);
+	for (std::uint32_t i = 0U; i < header->entryCount; i++)
+	{
+		if (entries[i].offset > header->indexOffset || entries[i].size > header->indexOffset - entries[i].offset)
+		{
+			std::ostringstream oss;
+			oss << "[ERROR] Pack file: " << packPath << " has an entry outside of the file";
+			Log::GetInstance()->Error(oss.str());
+			Close();
+			return false;
+		}
+	}
+	m_Header = header;
+	m_Entries = entries;
+	return true;
+}
+
+void PackFile::Close()
+{
+	m_File.Close();
+	m_Header = nullptr;
+	m_Entries = nullptr;
+}
+
+bool PackFile::IsOpen() const
+{
+	return m_Header != nullptr;
+}
+
+size_t PackFile::GetEntryCount() const
+{
+	return m_Header == nullptr ? 0U : m_Header->entryCount;
+}
+
+const PackEntry* PackFile::FindEntry(const std::string& path) const
+{
+	if (m_Header == nullptr)
+		return nullptr;
+	const auto pathHash = HashPath(path);
+	const auto* entriesEnd = m_Entries + m_Header->entryCount;
+	const auto* entry = std::lower_bound(m_Entries, entriesEnd, pathHash, [](const PackEntry& packEntry, std::uint64_t hash)
+	{
+		return packEntry.pathHash < hash;
+	});
+	if (entry == entriesEnd || entry->pathHash != pathHash)
+		return nullptr;
+	return entry;
+}
+
+bool PackFile::ReadEntry(const PackEntry& entry, const char*& data, size_t& size, std::vector<char>& buffer) const
+{
+	const char* blob = m_File.GetData() + entry.offset;
+#ifndef SFGE_USE_LZ4
+	(void) buffer;
+#endif
+	switch (static_cast<PackCompression>(entry.compression))
+	{
+	case PackCompression::NONE:
+		data = blob;
+		size = static_cast<size_t>(entry.size);
+		return true;
+#ifdef SFGE_USE_LZ4
+	case PackCompression::LZ4:
+	{
+		buffer.resize(static_cast<size_t>(entry.rawSize));
+		const int decompressedSize = LZ4_decompress_safe(blob, buffer.data(),
+			static_cast<int>(entry.size), static_cast<int>(entry.rawSize));
+		if (decompressedSize < 0 || static_cast<std::uint64_t>(decompressedSize) != entry.rawSize)
+		{
+			Log::GetInstance()->Error("[ERROR] Pack entry could not be decompressed");
+			return false;
+		}
+		data = buffer.data();
+		size = buffer.size();
+		return true;
+	}
+#endif
+	default:
+	{
+		std::ostringstream oss;
+		oss << "[ERROR] Pack entry compression " << entry.compression << " is not supported by this build";
+		Log::GetInstance()->Error(oss.str());
+		return false;
+	}
+	}
+}
+
+std::uint64_t PackFile::HashPath(const std::string& path)
+{
+	std::string packedPath = path;
+	std::replace(packedPath.begin(), packedPath.end(), '\\', '/');
+	while (packedPath.compare(0, 2, "./") == 0)
+	{
+		packedPath.erase(0, 2);
+	}
+	return xxh::xxhash<64>(packedPath);
+}
+
+void PackBuilder::AddFile(const std::string& path)
+{
+	m_Paths.push_back(path);
+}
+
+void PackBuilder::AddDirectory(std::string dirname, const std::set<std::string>& excludedFilenames)
+{
+	IterateDirectory(dirname, [this, &excludedFilenames](std::string entry)
+	{
+		if (IsDirectory(entry))
+		{
+			AddDirectory(entry, excludedFilenames);
+			return;
+		}
+		const auto nameIndex = entry.find_last_of('/');
+		const std::string filename = nameIndex == std::string::npos ? entry : entry.substr(nameIndex + 1);
+		if (IsRegularFile(entry) && excludedFilenames.find(filename) == excludedFilenames.end())
+		{
+			AddFile(entry);
+		}
+	});
+}
+
+bool PackBuilder::Write(const std::string& packPath, bool compress) const
+{
+#ifndef SFGE_USE_LZ4
+	(void) compress;
+#endif
+	std::ofstream packFile(packPath, std::ios::binary | std::ios::trunc);
+	if (!packFile)
+	{
+		std::ostringstream oss;
+		oss << "[ERROR] Pack file: " << packPath << " cannot be written";
+		Log::GetInstance()->Error(oss.str());
+		return false;
+	}
+	PackHeader header;
+	packFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	std::uint64_t offset = sizeof(header);
+
+	std::vector<PackEntry> entries;
+	entries.reserve(m_Paths.size());
+	std::vector<char> content;
+	std::vector<char> compressed;
+	const char alignmentPadding[packBlobAlignment] = {};
+	for (auto& path : m_Paths)
+	{
+		std::ifstream input(path, std::ios::binary);
+		if (!input)
+		{
+			std::ostringstream oss;
+			oss << "[ERROR] Packed file: " << path << " cannot be read";
+			Log::GetInstance()->Error(oss.str());
+			return false;
+		}
+		content.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+
+		PackEntry entry;
+		entry.pathHash = PackFile::HashPath(path);
+		entry.contentHash = xxh::xxhash<64>(content.data(), content.size());
+		entry.rawSize = content.size();
+		entry.size = content.size();
+		const char* blob = content.data();
+#ifdef SFGE_USE_LZ4
+		if (compress && !content.empty())
+		{
+			compressed.resize(static_cast<size_t>(LZ4_compressBound(static_cast<int>(content.size()))));
+			const int compressedSize = LZ4_compress_default(content.data(), compressed.data(),
+				static_cast<int>(content.size()), static_cast<int>(compressed.size()));
+			//Already compressed formats like png and ogg are kept as is, they would only cost a copy at load
+			if (compressedSize > 0 && static_cast<size_t>(compressedSize) < content.size() - content.size() / 8)
+			{
+				entry.compression = static_cast<std::uint32_t>(PackCompression::LZ4);
+				entry.size = static_cast<std::uint64_t>(compressedSize);
+				blob = compressed.data();
+			}
+		}
+#endif
+		const std::uint64_t padding = (packBlobAlignment - offset % packBlobAlignment) % packBlobAlignment;
+		packFile.write(alignmentPadding, static_cast<std::streamsize>(padding));
+		offset += padding;
+		entry.offset = offset;
+		packFile.write(blob, static_cast<std::streamsize>(entry.size));
+		offset += entry.size;
+		entries.push_back(entry);
+	}
+	std::sort(entries.begin(), entries.end(), [](const PackEntry& entry1, const PackEntry& entry2)
+	{
+		return entry1.pathHash < entry2.pathHash;
+	});
+	for (size_t i = 1; i < entries.size(); i++)
+	{
+		if (entries[i].pathHash == entries[i - 1].pathHash)
+		{
+			Log::GetInstance()->Error("[ERROR] Two packed paths have the same hash, a file was added twice");
+			return false;
+		}
+	}
+	const std::uint64_t padding = (packBlobAlignment - offset % packBlobAlignment) % packBlobAlignment;
+	packFile.write(alignmentPadding, static_cast<std::streamsize>(padding));
+	header.indexOffset = offset + padding;
+	header.entryCount = static_cast<std::uint32_t>(entries.size());
+	packFile.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(PackEntry)));
+	packFile.seekp(0);
+	packFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	return static_cast<bool>(packFile);
+}
+
+size_t PackBuilder::GetFileCount() const
+{
+	return m_Paths.size();
+}
+
+bool MountPack(const std::string& packPath)
+{
+	auto pack = std::make_unique<PackFile>();
+	if (!pack->Open(packPath))
+	{
+		return false;
+	}
+	{
+		std::ostringstream oss;
+		oss << "Mounted pack: " << packPath << " with " << pack->GetEntryCount() << " files";
+		Log::GetInstance()->Msg(oss.str());
+	}
+	mountedPack = std::move(pack);
+	return true;
+}
+
+void UnmountPack()
+{
+	mountedPack = nullptr;
+}
+
+const PackFile* GetMountedPack()
+{
+	return mountedPack.get();
+}
+
+bool ReadPackedFile(const std::string& path, const char*& data, size_t& size, std::vector<char>& buffer)
+{
+	if (mountedPack == nullptr)
+		return false;
+	const auto* entry = mountedPack->FindEntry(path);
+	return entry != nullptr && mountedPack->ReadEntry(*entry, data, size, buffer);
+}
+
+}
@@ -24,13 +24,18 @@
 
 #include <cctype>
 #include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+
+#include <xxhash.hpp>
 
 #include <utility/python_utility.h>
 #include <utility/log.h>
 
 namespace sfge
 {
-py::object import(const std::string& module, const std::string& path, py::object& globals)
+py::object import(const std::string& module, const std::string& path, py::object& globals, const std::string& cacheDirname)
 {
 	/*{
 		std::ostringstream oss;
@@ -38,20 +43,73 @@ py::object import(const std::string& module, const std::string& path, py::object
 		sfge::Log::GetInstance()->Msg(oss.str());
 	}*/
 
+	std::ifstream sourceFile(path, std::ios::binary);
+	const std::string source((std::istreambuf_iterator<char>(sourceFile)), std::istreambuf_iterator<char>());
+	std::string cachePath;
+	std::string cacheFolder;
+	std::string cachePrefix;
+	std::string cacheFilename;
+	if (!cacheDirname.empty())
+	{
+		//The path is part of the key as the compiled code keeps its filename for the tracebacks
+		xxh::hash_state_t<64> hashStream(0);
+		hashStream.update(path);
+		hashStream.update(source);
+		//The previous versions of the same script share the prefix and are removed when a new version is written
+		std::ostringstream prefixOss;
+		prefixOss << module << "_" << std::hex << std::setw(16) << std::setfill('0') << xxh::xxhash<64>(path) << "_";
+		cachePrefix = prefixOss.str();
+		std::ostringstream filenameOss;
+		filenameOss << cachePrefix << std::hex << std::setw(16) << std::setfill('0') << hashStream.digest() << ".pyc";
+		cacheFilename = filenameOss.str();
+		cacheFolder = cacheDirname.back() == '/' ? cacheDirname : cacheDirname + "/";
+		cachePath = cacheFolder + cacheFilename;
+	}
+
 	const py::dict locals;
 	locals["module_name"] = py::cast(module); // have to cast the std::string first
 	locals["file_path"] = py::cast(path);
+	locals["source"] = py::bytes(source);
+	locals["cache_path"] = py::cast(cachePath);
+	locals["cache_folder"] = py::cast(cacheFolder);
+	locals["cache_prefix"] = py::cast(cachePrefix);
+	locals["cache_filename"] = py::cast(cacheFilename);
 
 	/*
 	 *
 	 * "import imp\n"
 		"new_module = imp.load_module(module_name, open(path), path, ('py', 'U', imp.PY_SOURCE))\n",
 	 */
+	//The cached code starts with the magic number of the interpreter which wrote it
 	py::eval<py::eval_statements>(            // tell eval we're passing multiple statements
 		"import importlib.util\n"
+		"import marshal\n"
+		"import os\n"
 		"spec = importlib.util.spec_from_file_location(module_name, file_path)\n"
 		"module = importlib.util.module_from_spec(spec)\n"
-		"spec.loader.exec_module(module)\n",
+		"code = None\n"
+		"if cache_path and os.path.isfile(cache_path):\n"
+		"    try:\n"
+		"        with open(cache_path, 'rb') as cache_file:\n"
+		"            if cache_file.read(len(importlib.util.MAGIC_NUMBER)) == importlib.util.MAGIC_NUMBER:\n"
+		"                code = marshal.load(cache_file)\n"
+		"    except (OSError, EOFError, ValueError, TypeError):\n"
+		"        code = None\n"
+		"if code is None:\n"
+		"    code = compile(source, file_path, 'exec', dont_inherit=True)\n"
+		"    if cache_path:\n"
+		"        try:\n"
+		"            os.makedirs(os.path.dirname(cache_path), exist_ok=True)\n"
+		"            with open(cache_path + '.tmp', 'wb') as cache_file:\n"
+		"                cache_file.write(importlib.util.MAGIC_NUMBER)\n"
+		"                marshal.dump(code, cache_file)\n"
+		"            os.replace(cache_path + '.tmp', cache_path)\n"
+		"            for cache_entry in os.listdir(cache_folder):\n"
+		"                if cache_entry.startswith(cache_prefix) and cache_entry != cache_filename:\n"
+		"                    os.remove(os.path.join(cache_folder, cache_entry))\n"
+		"        except OSError:\n"
+		"            pass\n"
+		"exec(code, module.__dict__)\n",
 		globals,
 		locals);
 
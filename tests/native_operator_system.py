@@ -0,0 +1,24 @@
+from SFGE import *
+from typing import List
+
+
+class NativeOperatorSystem(System):
+    """Operators translated with the Python semantics, generated and run by tests/test_native_systems.cpp"""
+
+    values: List[int]
+
+    def init(self):
+        self.values = [3, 5, 7]
+
+    def update(self, dt):
+        # each result goes in the transform of one entity
+        transform2d_manager.get_component(1).euler_angle = float(-7 // 2)
+        transform2d_manager.get_component(2).euler_angle = float(-7 % 3)
+        transform2d_manager.get_component(3).euler_angle = -7.5 % 2.0
+        transform2d_manager.get_component(4).euler_angle = -7.5 // 2.0
+        transform2d_manager.get_component(5).position = 2.0 * Vec2f(1.0, 3.0)
+        transform2d_manager.get_component(6).position = Vec2f(4.0, 6.0) / 2.0 - Vec2f(1.0, 1.0)
+        transform2d_manager.get_component(7).euler_angle = float(self.values.index(7))
+        # a missing item raises in Python, the rest of the update is skipped
+        transform2d_manager.get_component(8).euler_angle = float(self.values.index(9))
+        transform2d_manager.get_component(9).euler_angle = 42.0
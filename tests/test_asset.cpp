@@ -25,6 +25,14 @@ SOFTWARE.
 #include <fstream>
 #include <xxhash.hpp>
 #include <gtest/gtest.h>
+#include <engine/engine.h>
+#include <engine/config.h>
+#include <engine/asset.h>
+#include <graphics/graphics2d.h>
+#include <utility/file_utility.h>
+#include <utility/json_utility.h>
+#include <utility/pack_file.h>
+#include <SFML/System/Sleep.hpp>
 
 TEST(Engine, TestAssetImport)
 {
@@ -65,4 +73,152 @@ TEST(Engine, TestAssetImport)
 #ifdef WIN32
 	system("pause");
 #endif
-}
\ No newline at end of file
+}
+
+TEST(Engine, TestAssetManager)
+{
+	sfge::Engine engine;
+	auto config = std::make_unique<sfge::Configuration>();
+	config->devMode = false;
+	config->windowLess = true;
+	engine.Init(std::move(config));
+
+	auto* assetManager = engine.GetAssetManager();
+	const auto playId = assetManager->LoadAsset("data/editor/play.png", sfge::AssetType::TEXTURE);
+	ASSERT_NE(playId, sfge::INVALID_ASSET);
+	ASSERT_EQ(assetManager->LoadAsset("data/editor/play.png", sfge::AssetType::TEXTURE), playId);
+	//Same content under another path
+	ASSERT_EQ(assetManager->LoadAsset("data/sprites/other_play.png", sfge::AssetType::TEXTURE), playId);
+	ASSERT_NE(assetManager->LoadAsset("data/editor/star.png", sfge::AssetType::TEXTURE), playId);
+	ASSERT_EQ(assetManager->LoadAsset("fake/path/file.png", sfge::AssetType::TEXTURE), sfge::INVALID_ASSET);
+	ASSERT_EQ(assetManager->FindAsset("data/sprites/other_play.png"), playId);
+	ASSERT_EQ(assetManager->GetAsset(playId)->name, "play.png");
+
+	auto* textureManager = engine.GetGraphics2dManager()->GetTextureManager();
+	const auto textureId = textureManager->LoadTexture("data/editor/play.png");
+	ASSERT_NE(textureId, sfge::INVALID_TEXTURE);
+	ASSERT_EQ(textureManager->LoadTexture("data/sprites/other_play.png"), textureId);
+	engine.Destroy();
+}
+
+TEST(Engine, TestAssetWithoutContentHash)
+{
+	sfge::Engine engine;
+	auto config = std::make_unique<sfge::Configuration>();
+	config->devMode = false;
+	config->windowLess = true;
+	engine.Init(std::move(config));
+
+	auto* assetManager = engine.GetAssetManager();
+	//Registered by path only, the file is not read
+	const auto lazyId = assetManager->LoadAsset("data/sprites/other_play.png", sfge::AssetType::TEXTURE, false);
+	ASSERT_NE(lazyId, sfge::INVALID_ASSET);
+	ASSERT_EQ(assetManager->GetAsset(lazyId)->hash, 0u);
+	ASSERT_EQ(assetManager->LoadAsset("data/sprites/other_play.png", sfge::AssetType::TEXTURE), lazyId);
+	ASSERT_EQ(assetManager->LoadAsset("fake/path/file.png", sfge::AssetType::TEXTURE, false), sfge::INVALID_ASSET);
+	//Without a content hash, another file with the same content is not shared
+	const auto playId = assetManager->LoadAsset("data/editor/play.png", sfge::AssetType::TEXTURE);
+	ASSERT_NE(playId, lazyId);
+	ASSERT_NE(assetManager->GetAsset(playId)->hash, 0u);
+	engine.Destroy();
+}
+
+TEST(Engine, TestHotReload)
+{
+	sfge::Engine engine;
+	auto config = std::make_unique<sfge::Configuration>();
+	config->devMode = false;
+	config->windowLess = true;
+	engine.Init(std::move(config));
+
+	const std::string dirname = "data/test_hot_reload";
+	const std::string filename = dirname + "/watched.txt";
+	sfge::CreateDirectory(dirname);
+	{
+		std::ofstream watchedFile(filename);
+		watchedFile << "first";
+	}
+	auto* assetManager = engine.GetAssetManager();
+	const auto assetId = assetManager->LoadAsset(filename, sfge::AssetType::NONE);
+	const auto firstHash = assetManager->GetAsset(assetId)->hash;
+
+	sfge::FileWatcher fileWatcher;
+	ASSERT_TRUE(fileWatcher.Watch(dirname));
+	ASSERT_TRUE(fileWatcher.Poll().empty());
+	for (int i = 0; i < 2; i++)
+	{
+		std::ofstream watchedFile(filename);
+		watchedFile << "second";
+	}
+	std::vector<std::string> changedFiles;
+	for (int i = 0; i < 30 && changedFiles.empty(); i++)
+	{
+		sf::sleep(sf::milliseconds(100));
+		changedFiles = fileWatcher.Poll();
+	}
+	//Both writes are batched
+	ASSERT_EQ(changedFiles.size(), 1u);
+	ASSERT_EQ(changedFiles[0], filename);
+	ASSERT_EQ(assetManager->ReloadAsset(filename, sfge::AssetType::NONE), assetId);
+	ASSERT_NE(assetManager->GetAsset(assetId)->hash, firstHash);
+
+	fileWatcher.Stop();
+	sfge::RemoveDirectory(dirname);
+	engine.Destroy();
+}
+
+TEST(Engine, TestPackFile)
+{
+	const std::string dirname = "data/test_pack";
+	const std::string jsonFilename = dirname + "/test.json";
+	const std::string textureFilename = dirname + "/play.png";
+	const std::string packFilename = "test.pack";
+	sfge::CreateDirectory(dirname);
+	{
+		std::ofstream jsonFile(jsonFilename);
+		jsonFile << "{\"name\" : \"packed\", \"values\" : [";
+		for (int i = 0; i < 1000; i++)
+		{
+			jsonFile << i << ",";
+		}
+		jsonFile << "0]}";
+	}
+	{
+		std::ifstream input("data/editor/play.png", std::ios::binary);
+		std::ofstream output(textureFilename, std::ios::binary);
+		output << input.rdbuf();
+	}
+	xxh::hash64_t textureHash = 0;
+	ASSERT_TRUE(sfge::AssetManager::HashFile(textureFilename, textureHash));
+
+	sfge::PackBuilder packBuilder;
+	packBuilder.AddDirectory(dirname);
+	ASSERT_EQ(packBuilder.GetFileCount(), 2u);
+	ASSERT_TRUE(packBuilder.Write(packFilename, true));
+	//Only the pack is left
+	sfge::RemoveDirectory(dirname);
+
+	sfge::Engine engine;
+	auto config = std::make_unique<sfge::Configuration>();
+	config->devMode = false;
+	config->windowLess = true;
+	config->packFilename = packFilename;
+	engine.Init(std::move(config));
+
+	ASSERT_NE(sfge::GetMountedPack(), nullptr);
+	ASSERT_EQ(sfge::GetMountedPack()->GetEntryCount(), 2u);
+	const auto jsonPtr = sfge::LoadJson("./" + jsonFilename);
+	ASSERT_NE(jsonPtr, nullptr);
+	ASSERT_EQ((*jsonPtr)["name"], "packed");
+	ASSERT_EQ((*jsonPtr)["values"].size(), 1001u);
+
+	auto* assetManager = engine.GetAssetManager();
+	const auto assetId = assetManager->LoadAsset(textureFilename, sfge::AssetType::TEXTURE);
+	ASSERT_NE(assetId, sfge::INVALID_ASSET);
+	ASSERT_EQ(assetManager->GetAsset(assetId)->hash, textureHash);
+	auto* textureManager = engine.GetGraphics2dManager()->GetTextureManager();
+	ASSERT_NE(textureManager->LoadTexture(textureFilename), sfge::INVALID_TEXTURE);
+	engine.Destroy();
+	ASSERT_EQ(sfge::GetMountedPack(), nullptr);
+	std::remove(packFilename.c_str());
+}
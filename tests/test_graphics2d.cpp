@@ -22,11 +22,18 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#include <cstdio>
+#include <fstream>
+
 #include <gtest/gtest.h>
 #include "engine/engine.h"
 #include "engine/component.h"
 #include "graphics/texture.h"
 #include <graphics/graphics2d.h>
+#include <graphics/render_thread.h>
+#include <graphics/sprite_instancing.h>
+#include <utility/file_utility.h>
+#include <SFML/System/Sleep.hpp>
 
 TEST(Graphics2d, TestSpriteAnimation)
 {
@@ -49,6 +56,83 @@ TEST(Graphics2d, TestSpriteAnimation)
 }
 
 
+TEST(Graphics2d, TestAnimationClipSharing)
+{
+	sfge::Engine engine;
+	auto config = std::make_unique<sfge::Configuration>();
+	config->devMode = false;
+	config->windowLess = true;
+	engine.Init(std::move(config));
+
+	json sceneJson;
+	json animationJson;
+	animationJson["path"] = "data/animSaves/cowboy_walk.json";
+	animationJson["type"] = static_cast<int>(sfge::ComponentType::ANIMATION2D);
+	json entityJson;
+	entityJson["components"] = json::array({ animationJson });
+	sceneJson["entities"] = json::array({ entityJson, entityJson });
+	sceneJson["name"] = "Test Animation Sharing";
+	engine.GetSceneManager()->LoadSceneFromJson(sceneJson);
+
+	auto* animationManager = engine.GetGraphics2dManager()->GetAnimation2dManager();
+	ASSERT_EQ(animationManager->GetClipCount(), 1u);
+	const auto clipId = animationManager->GetComponentRef(1).clipId;
+	ASSERT_NE(clipId, sfge::INVALID_ANIMATION_CLIP);
+	ASSERT_EQ(animationManager->GetComponentRef(2).clipId, clipId);
+	ASSERT_EQ(animationManager->GetClip(clipId)->frames.size(), 4u);
+	ASSERT_TRUE(engine.GetEntityManager()->HasComponent(2, sfge::ComponentType::SPRITE2D));
+	engine.Destroy();
+}
+
+TEST(Graphics2d, TestAnimationNegativeSpeed)
+{
+	sfge::Engine engine;
+	auto config = std::make_unique<sfge::Configuration>();
+	config->devMode = false;
+	config->windowLess = true;
+	engine.Init(std::move(config));
+
+	json sceneJson;
+	json animationJson;
+	animationJson["path"] = "data/animSaves/cowboy_walk.json";
+	animationJson["type"] = static_cast<int>(sfge::ComponentType::ANIMATION2D);
+	animationJson["speed"] = -1.0f;
+	json entityJson;
+	entityJson["components"] = json::array({ animationJson });
+	sceneJson["entities"] = json::array({ entityJson });
+	sceneJson["name"] = "Test Animation Negative Speed";
+	engine.GetSceneManager()->LoadSceneFromJson(sceneJson);
+
+	auto* animationManager = engine.GetGraphics2dManager()->GetAnimation2dManager();
+	const auto& animation = animationManager->GetComponentRef(1);
+	const auto* clip = animationManager->GetClip(animation.clipId);
+	ASSERT_NE(clip, nullptr);
+	const int frameCount = static_cast<int>(clip->frames.size());
+	for (int i = 0; i < 3 * frameCount; i++)
+	{
+		animationManager->OnUpdate(clip->frameDuration * 0.75f);
+		ASSERT_GE(animation.time, 0.0f);
+		ASSERT_GE(animation.currentFrame, 0);
+		ASSERT_LT(animation.currentFrame, frameCount);
+	}
+
+	animationManager->DestroyComponent(1);
+	ASSERT_FALSE(engine.GetEntityManager()->HasComponent(1, sfge::ComponentType::ANIMATION2D));
+	engine.Destroy();
+}
+
+TEST(Graphics2d, TestSpriteInstanceFlippedRect)
+{
+	sfge::SpriteInstance instance;
+	instance.scale = sf::Vector2f(1.0f, 1.0f);
+	instance.SetTextureRect(sf::IntRect(64, 0, -64, 32), sf::Vector2u(128, 64));
+	EXPECT_EQ(instance.uvRect[0], 0);
+	EXPECT_EQ(instance.uvRect[2], 32768);
+	EXPECT_EQ(instance.uvRect[3], 32768);
+	EXPECT_FLOAT_EQ(instance.scale.x, -1.0f);
+	EXPECT_FLOAT_EQ(instance.scale.y, 1.0f);
+}
+
 TEST(Graphics2d, TestSprite)
 {
 	sfge::Engine engine;
@@ -149,3 +233,190 @@ TEST(Graphics2d, TestTexture)
 	engine.Destroy();
 }
 
+
+TEST(Graphics2d, TestDebugDrawCategories)
+{
+	sfge::DebugDraw debugDraw;
+	//The collider outlines are opt-in
+	EXPECT_FALSE(debugDraw.IsCategoryEnabled(sfge::DebugDrawCategory::PHYSICS));
+	debugDraw.SetCategoryEnabled(sfge::DebugDrawCategory::PHYSICS, true);
+	EXPECT_TRUE(debugDraw.IsCategoryEnabled(sfge::DebugDrawCategory::PHYSICS));
+	debugDraw.SetCategoryEnabled(sfge::DebugDrawCategory::PHYSICS, false);
+
+	debugDraw.DrawLine(sfge::Vec2f(0.0f, 0.0f), sfge::Vec2f(100.0f, 100.0f), sf::Color::Red);
+	debugDraw.DrawBox(sfge::Vec2f(50.0f, 50.0f), sfge::Vec2f(20.0f, 10.0f), 45.0f, sf::Color::Green,
+		sfge::DebugDrawCategory::PHYSICS);
+	ASSERT_EQ(debugDraw.GetLineVertexCount(), 2u);
+
+	const float points[] = { 0.0f, 0.0f, 10.0f, 0.0f, 10.0f, 10.0f, 0.0f, 10.0f };
+	debugDraw.DrawLines(points, 4, sf::Color::White, sfge::DebugDrawCategory::RAYCAST);
+	debugDraw.DrawCircle(sfge::Vec2f(200.0f, 200.0f), 30.0f, sf::Color::Blue);
+	ASSERT_EQ(debugDraw.GetLineVertexCount(), 2u + 4u + 2u * sfge::DebugDraw::circleSegments);
+
+	debugDraw.Clear();
+	ASSERT_EQ(debugDraw.GetLineVertexCount(), 0u);
+}
+
+TEST(Graphics2d, TestRenderCommandListBatches)
+{
+	//Only the texture addresses are recorded, no GL texture is created
+	sf::Texture firstTexture;
+	sf::Texture secondTexture;
+	sfge::RenderCommandList commandList;
+
+	sf::Vertex lines[4];
+	commandList.AddVertices(lines, 2, sf::Lines);
+	commandList.AddVertices(lines + 2, 2, sf::Lines);
+	ASSERT_EQ(commandList.GetBatchCount(), 1u);
+	ASSERT_EQ(commandList.GetBatches()[0].count, 4u);
+
+	//Strips cannot be concatenated, even with the same primitive and texture
+	sf::Vertex strip[4];
+	commandList.AddVertices(strip, 4, sf::LineStrip);
+	commandList.AddVertices(strip, 4, sf::LineStrip);
+	ASSERT_EQ(commandList.GetBatchCount(), 3u);
+
+	//Quads are converted from the strip layout to two triangles each and merged while the texture matches
+	sf::Vertex quad[4];
+	quad[0].position = sf::Vector2f(0.0f, 0.0f);
+	quad[1].position = sf::Vector2f(0.0f, 10.0f);
+	quad[2].position = sf::Vector2f(10.0f, 0.0f);
+	quad[3].position = sf::Vector2f(10.0f, 10.0f);
+	commandList.AddQuad(quad, &firstTexture);
+	commandList.AddQuad(quad, &firstTexture);
+	ASSERT_EQ(commandList.GetBatchCount(), 4u);
+	const auto& quadBatch = commandList.GetBatches()[3];
+	EXPECT_EQ(quadBatch.primitive, sf::Triangles);
+	EXPECT_EQ(quadBatch.texture, &firstTexture);
+	EXPECT_EQ(quadBatch.start, 12u);
+	EXPECT_EQ(quadBatch.count, 12u);
+	commandList.AddQuad(quad, &secondTexture);
+	ASSERT_EQ(commandList.GetBatchCount(), 5u);
+	ASSERT_EQ(commandList.GetVertexCount(), 4u + 8u + 18u);
+
+	commandList.Reset();
+	ASSERT_EQ(commandList.GetBatchCount(), 0u);
+	ASSERT_EQ(commandList.GetVertexCount(), 0u);
+	//Nothing is merged with the batches of the previous frame
+	commandList.AddQuad(quad, &secondTexture);
+	ASSERT_EQ(commandList.GetBatchCount(), 1u);
+	ASSERT_EQ(commandList.GetBatches()[0].start, 0u);
+}
+
+TEST(Graphics2d, TestAsyncTexture)
+{
+	sfge::Engine engine;
+	auto config = std::make_unique<sfge::Configuration>();
+	config->devMode = false;
+	config->windowLess = true;
+	engine.Init(std::move(config));
+
+	auto* graphicsManager = engine.GetGraphics2dManager();
+	auto* textureManager = graphicsManager->GetTextureManager();
+	const sfge::TextureId textureId = textureManager->LoadTexture("data/sprites/other_play.png", true);
+	ASSERT_NE(textureId, sfge::INVALID_TEXTURE);
+	//The placeholder is usable right away
+	ASSERT_NE(textureManager->GetTexture(textureId)->getNativeHandle(), 0U);
+
+	for (int frame = 0; frame < 500 && !textureManager->IsTextureReady(textureId); frame++)
+	{
+		sf::sleep(sf::milliseconds(10));
+		graphicsManager->OnUpdate(0.01f);
+	}
+	ASSERT_TRUE(textureManager->IsTextureReady(textureId));
+	ASSERT_EQ(textureManager->GetPendingTexturesCount(), 0u);
+	ASSERT_EQ(textureManager->LoadTexture("data/sprites/other_play.png"), textureId);
+	engine.Destroy();
+}
+
+TEST(Graphics2d, TestAsyncTextureSameContent)
+{
+	sfge::Engine engine;
+	auto config = std::make_unique<sfge::Configuration>();
+	config->devMode = false;
+	config->windowLess = true;
+	engine.Init(std::move(config));
+
+	auto* graphicsManager = engine.GetGraphics2dManager();
+	auto* textureManager = graphicsManager->GetTextureManager();
+	//Both files have the same content
+	const sfge::TextureId textureId = textureManager->LoadTexture("data/editor/play.png", true);
+	ASSERT_NE(textureId, sfge::INVALID_TEXTURE);
+	ASSERT_EQ(textureManager->LoadTexture("data/sprites/other_play.png", true), textureId);
+
+	for (int frame = 0; frame < 500 && !textureManager->IsTextureReady(textureId); frame++)
+	{
+		sf::sleep(sf::milliseconds(10));
+		graphicsManager->OnUpdate(0.01f);
+	}
+	ASSERT_TRUE(textureManager->IsTextureReady(textureId));
+	ASSERT_EQ(textureManager->GetPendingTexturesCount(), 0u);
+	ASSERT_EQ(textureManager->LoadTexture("data/sprites/other_play.png", true), textureId);
+	engine.Destroy();
+}
+
+TEST(Graphics2d, TestAsyncTextureDecodeFailure)
+{
+	const std::string badTexturePath = "data/test_bad_texture.png";
+	{
+		std::ofstream badTextureFile(badTexturePath, std::ios::binary | std::ios::trunc);
+		badTextureFile << "not a png";
+	}
+	sfge::Engine engine;
+	auto config = std::make_unique<sfge::Configuration>();
+	config->devMode = false;
+	config->windowLess = true;
+	engine.Init(std::move(config));
+
+	auto* graphicsManager = engine.GetGraphics2dManager();
+	auto* textureManager = graphicsManager->GetTextureManager();
+	const sfge::TextureId textureId = textureManager->LoadTexture(badTexturePath, true);
+	ASSERT_NE(textureId, sfge::INVALID_TEXTURE);
+	for (int frame = 0; frame < 500 && textureManager->GetPendingTexturesCount() > 0; frame++)
+	{
+		sf::sleep(sf::milliseconds(10));
+		graphicsManager->OnUpdate(0.01f);
+	}
+	ASSERT_EQ(textureManager->GetPendingTexturesCount(), 0u);
+	//The placeholder is still shown, but the texture is not reported as ready
+	ASSERT_FALSE(textureManager->IsTextureReady(textureId));
+	engine.Destroy();
+	std::remove(badTexturePath.c_str());
+}
+
+TEST(Graphics2d, TestTextureCache)
+{
+	const std::string cacheDirname = "data/test_texture_cache/";
+	sfge::RemoveDirectory(cacheDirname);
+	for (int run = 0; run < 2; run++)
+	{
+		sfge::Engine engine;
+		auto config = std::make_unique<sfge::Configuration>();
+		config->devMode = false;
+		config->windowLess = true;
+		config->textureCacheDirname = cacheDirname;
+		engine.Init(std::move(config));
+
+		auto* textureManager = engine.GetGraphics2dManager()->GetTextureManager();
+		const sfge::TextureId textureId = textureManager->LoadTexture("data/sprites/round.png");
+		ASSERT_NE(textureId, sfge::INVALID_TEXTURE);
+		const auto size = textureManager->GetTexture(textureId)->getSize();
+		sf::Image image;
+		ASSERT_TRUE(image.loadFromFile("data/sprites/round.png"));
+		ASSERT_EQ(size, image.getSize());
+		//The first run decodes the png and writes the cache entry read by the second run
+		size_t cacheFileCount = 0;
+		std::string dirname = cacheDirname;
+		sfge::IterateDirectory(dirname, [&cacheFileCount](std::string) { cacheFileCount++; });
+		ASSERT_EQ(cacheFileCount, 1u);
+		ASSERT_EQ(textureManager->GetCacheReadCount(), static_cast<size_t>(run));
+
+		const sfge::TextureId ddsTextureId = textureManager->LoadTexture("data/sprites/terrain_texture.dds");
+		ASSERT_NE(ddsTextureId, sfge::INVALID_TEXTURE);
+		ASSERT_EQ(textureManager->GetTexture(ddsTextureId)->getSize(), sf::Vector2u(513, 513));
+		engine.Destroy();
+	}
+	//Only the cache entry is left, pruning to 0 bytes removes it
+	ASSERT_EQ(sfge::PruneDirectory(cacheDirname, 0), 1u);
+	sfge::RemoveDirectory(cacheDirname);
+}
@@ -0,0 +1,207 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <engine/engine.h>
+#include <engine/scene.h>
+#include <engine/config.h>
+#include <engine/component.h>
+#include <engine/system_registry.h>
+#include <engine/transform2d.h>
+#include <graphics/graphics2d.h>
+#include <graphics/shape2d.h>
+#include <physics/collider2d.h>
+#include <python/python_engine.h>
+#include <native_systems/test_generated_systems.h>
+#include <utility/json_utility.h>
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+
+/**
+ * \brief Engine without window nor editor, with the systems generated for the tests registered after the engine ones
+ */
+static void InitTestEngine(sfge::Engine& engine)
+{
+	auto config = std::make_unique<sfge::Configuration>();
+	config->devMode = false;
+	config->windowLess = true;
+	engine.Init(std::move(config));
+	sfge::ext::RegisterTestGeneratedSystems(*engine.GetSystemRegistry());
+}
+
+static json CreateSystemScene(const std::string& systemClassName, size_t entityNmb, const json& otherComponents = json::array())
+{
+	json sceneJson;
+	sceneJson["name"] = "Test " + systemClassName;
+	sceneJson["entities"] = json::array();
+	for (size_t i = 0; i < entityNmb; i++)
+	{
+		json transformJson;
+		transformJson["type"] = static_cast<int>(sfge::ComponentType::TRANSFORM2D);
+		transformJson["position"] = json::array({ 100.0f * i, 100.0f });
+		json entityJson;
+		entityJson["components"] = otherComponents;
+		entityJson["components"].push_back(transformJson);
+		sceneJson["entities"].push_back(entityJson);
+	}
+	sceneJson["systems"] = json::array({ { { "systemClassName", systemClassName } } });
+	return sceneJson;
+}
+
+TEST(NativeSystems, TestGeneratedSystemsRegistered)
+{
+	sfge::Engine engine;
+	InitTestEngine(engine);
+	auto* systemRegistry = engine.GetSystemRegistry();
+	EXPECT_TRUE(systemRegistry->HasSystem("ContactDebugSystem"));
+	EXPECT_TRUE(systemRegistry->HasSystem("VectorSystem"));
+	EXPECT_TRUE(systemRegistry->HasSystem("NativeOperatorSystem"));
+	engine.Destroy();
+}
+
+TEST(NativeSystems, TestGeneratedOperators)
+{
+	sfge::Engine engine;
+	InitTestEngine(engine);
+	auto sceneJson = CreateSystemScene("NativeOperatorSystem", 9);
+	auto* sceneManager = engine.GetSceneManager();
+	sceneManager->LoadSceneFromJson(sceneJson);
+	ASSERT_EQ(sceneManager->GetSceneNativeSystems().size(), 1u);
+	sceneManager->OnUpdate(0.016f);
+
+	//The results of tests/native_operator_system.py, computed with the Python semantics
+	auto* transformManager = engine.GetTransform2dManager();
+	const auto angle = [transformManager](Entity entity) { return transformManager->GetComponentRef(entity).EulerAngle; };
+	EXPECT_FLOAT_EQ(angle(1), -4.0f);
+	EXPECT_FLOAT_EQ(angle(2), 2.0f);
+	EXPECT_FLOAT_EQ(angle(3), 0.5f);
+	EXPECT_FLOAT_EQ(angle(4), -4.0f);
+	EXPECT_FLOAT_EQ(transformManager->GetComponentRef(5).Position.x, 2.0f);
+	EXPECT_FLOAT_EQ(transformManager->GetComponentRef(5).Position.y, 6.0f);
+	EXPECT_FLOAT_EQ(transformManager->GetComponentRef(6).Position.x, 1.0f);
+	EXPECT_FLOAT_EQ(transformManager->GetComponentRef(6).Position.y, 2.0f);
+	EXPECT_FLOAT_EQ(angle(7), 2.0f);
+	//The missing item skipped the end of the update
+	EXPECT_FLOAT_EQ(angle(8), 0.0f);
+	EXPECT_FLOAT_EQ(angle(9), 0.0f);
+	engine.Destroy();
+}
+
+TEST(NativeSystems, TestGeneratedContactDebugSystem)
+{
+	sfge::Engine engine;
+	InitTestEngine(engine);
+	json shapeJson;
+	shapeJson["type"] = static_cast<int>(sfge::ComponentType::SHAPE2D);
+	shapeJson["shape_type"] = static_cast<int>(sfge::ShapeType::CIRCLE);
+	shapeJson["radius"] = 10.0f;
+	auto sceneJson = CreateSystemScene("ContactDebugSystem", 3, json::array({ shapeJson }));
+	auto* sceneManager = engine.GetSceneManager();
+	sceneManager->LoadSceneFromJson(sceneJson);
+	ASSERT_EQ(sceneManager->GetSceneNativeSystems().size(), 1u);
+	auto* shapeManager = engine.GetGraphics2dManager()->GetShapeManager();
+	const auto fillColor = [shapeManager](Entity entity) { return shapeManager->GetComponentRef(entity).GetShape()->getFillColor(); };
+	EXPECT_EQ(fillColor(1), sf::Color::Red);
+
+	sfge::ColliderData c1;
+	c1.entity = 1;
+	sfge::ColliderData c2;
+	c2.entity = 2;
+	sfge::ColliderData unknown;
+	unknown.entity = 100;
+	sceneManager->ContactNativeSystems(&c1, &c2, true);
+	//The entity without shape is not found, the contact is logged and skipped
+	sceneManager->ContactNativeSystems(&unknown, &c1, false);
+	sceneManager->OnFixedUpdate();
+	EXPECT_EQ(fillColor(1), sf::Color::Green);
+	EXPECT_EQ(fillColor(2), sf::Color::Green);
+	EXPECT_EQ(fillColor(3), sf::Color::Magenta);
+	engine.Destroy();
+}
+
+TEST(NativeSystems, TestGeneratedVectorSystem)
+{
+	sfge::Engine engine;
+	InitTestEngine(engine);
+	auto sceneJson = CreateSystemScene("VectorSystem", 0);
+	auto* sceneManager = engine.GetSceneManager();
+	sceneManager->LoadSceneFromJson(sceneJson);
+	ASSERT_EQ(sceneManager->GetSceneNativeSystems().size(), 1u);
+	//The compiled system runs instead of the script, no PySystem is loaded
+	EXPECT_TRUE(sceneManager->GetSceneSystems().empty());
+	sceneManager->OnUpdate(0.016f);
+	sceneManager->OnFixedUpdate();
+	engine.Destroy();
+}
+
+TEST(NativeSystems, TestGeneratorOperators)
+{
+	sfge::Engine engine;
+	InitTestEngine(engine);
+	{
+		py::gil_scoped_acquire gil;
+		const py::dict locals;
+		//The generator is run on one update method per case, an unsupported case gives its error instead of the source
+		py::exec(
+			"import ast\n"
+			"import sys\n"
+			"sys.path.insert(0, 'scripts/tools')\n"
+			"import generate_native_system as generator\n"
+			"def translate_update(lines):\n"
+			"    source = 'class TestSystem(System):\\n    def update(self, dt):\\n' + ''.join('        ' + line + '\\n' for line in lines)\n"
+			"    module = ast.parse(source)\n"
+			"    translator = generator.SystemTranslator(module, module.body[0])\n"
+			"    try:\n"
+			"        translator.translate()\n"
+			"    except generator.GenerationError as e:\n"
+			"        return 'GenerationError ' + str(e)\n"
+			"    return translator.source()\n"
+			"results = {\n"
+			"    'scalar_mul': translate_update(['v = 2.0 * Vec2f(1.0, 2.0)']),\n"
+			"    'vector_add': translate_update(['v = p2Vec2(1.0, 2.0) + p2Vec2(3.0, 4.0)']),\n"
+			"    'scalar_add': translate_update(['v = 2.0 + p2Vec2(1.0, 2.0)']),\n"
+			"    'scalar_sub': translate_update(['v = 1.0 - Vec2f(1.0, 2.0)']),\n"
+			"    'scalar_div': translate_update(['v = 2.0 / Vec2f(1.0, 2.0)']),\n"
+			"    'vector_mod': translate_update(['v = Vec2f(1.0, 2.0) % 2.0']),\n"
+			"    'int_floor_div': translate_update(['a = 7', 'b = -a // 2']),\n"
+			"    'int_mod': translate_update(['a = 7', 'b = -a % 3']),\n"
+			"    'index_in_while': translate_update(['values = [1, 2]', 'while values.index(2) > 0:', '    break']),\n"
+			"}\n",
+			py::globals(), locals);
+		const auto results = locals["results"].cast<std::map<std::string, std::string>>();
+		EXPECT_NE(results.at("scalar_mul").find("Vec2f(1.0f, 2.0f) * 2.0f;"), std::string::npos);
+		EXPECT_NE(results.at("vector_add").find("p2Vec2(1.0f, 2.0f) + p2Vec2(3.0f, 4.0f);"), std::string::npos);
+		//The vectors are only added to vectors and multiplied by scalars
+		EXPECT_EQ(results.at("scalar_add").rfind("GenerationError", 0), 0u);
+		EXPECT_EQ(results.at("scalar_sub").rfind("GenerationError", 0), 0u);
+		EXPECT_EQ(results.at("scalar_div").rfind("GenerationError", 0), 0u);
+		EXPECT_EQ(results.at("vector_mod").rfind("GenerationError", 0), 0u);
+		EXPECT_NE(results.at("int_floor_div").find("static int FloorDiv(int a, int b)"), std::string::npos);
+		EXPECT_NE(results.at("int_floor_div").find("FloorDiv(-a, 2)"), std::string::npos);
+		EXPECT_NE(results.at("int_mod").find("FloorMod(-a, 3)"), std::string::npos);
+		EXPECT_EQ(results.at("int_mod").find("FloorDiv"), std::string::npos);
+		EXPECT_EQ(results.at("index_in_while").rfind("GenerationError", 0), 0u);
+	}
+	engine.Destroy();
+}
@@ -28,6 +28,8 @@ SOFTWARE.
 #include <utility/json_utility.h>
 #include <gtest/gtest.h>
 #include <engine/component.h>
+#include <physics/physics2d.h>
+#include <python/python_engine.h>
 
 TEST(Physics, TestPlanetPySystem)
 {
@@ -67,6 +69,88 @@ TEST(System, TestPlanetPySystemCpp)
 	sceneJson["systems"] = json::array({ systemJson });
 	auto* sceneManager = engine.GetSceneManager();
 	sceneManager->LoadSceneFromJson(sceneJson);
+	//PlanetSystem is registered as a native system, it is not instantiated by Python
+	EXPECT_EQ(sceneManager->GetSceneNativeSystems().size(), 1u);
+	EXPECT_TRUE(sceneManager->GetSceneSystems().empty());
 
 	engine.Start();
-}
\ No newline at end of file
+}
+TEST(Physics, TestPlanetNumpyPySystem)
+{
+	sfge::Engine engine;
+	std::unique_ptr<sfge::Configuration> initConfig = std::make_unique<sfge::Configuration>();
+	initConfig->gravity = p2Vec2();
+	initConfig->devMode = false;
+	initConfig->maxFramerate = 0;
+	engine.Init(std::move(initConfig));
+	json sceneJson = {
+		{ "name", "Test Planet Numpy System" }
+	};
+	json systemJson = {
+		{"script_path", "scripts/planet_numpy_system.py"}
+	};
+	sceneJson["systems"] = json::array({ systemJson });
+	auto* sceneManager = engine.GetSceneManager();
+	sceneManager->LoadSceneFromJson(sceneJson);
+
+	engine.Start();
+}
+
+TEST(Physics, TestBodyNumpyViews)
+{
+	sfge::Engine engine;
+	std::unique_ptr<sfge::Configuration> initConfig = std::make_unique<sfge::Configuration>();
+	initConfig->gravity = p2Vec2(0.0f, 0.0f);
+	initConfig->devMode = false;
+	initConfig->windowLess = true;
+	engine.Init(std::move(initConfig));
+	json sceneJson = {
+		{ "name", "Test Body Numpy Views" }
+	};
+	sceneJson["entities"] = json::array();
+	for (int i = 0; i < 2; i++)
+	{
+		json transformJson;
+		transformJson["type"] = static_cast<int>(sfge::ComponentType::TRANSFORM2D);
+		transformJson["position"] = json::array({ 100.0f * i, 100.0f });
+		json bodyJson;
+		bodyJson["type"] = static_cast<int>(sfge::ComponentType::BODY2D);
+		bodyJson["body_type"] = 2;
+		json entityJson;
+		entityJson["components"] = json::array({ transformJson, bodyJson });
+		sceneJson["entities"].push_back(entityJson);
+	}
+	engine.GetSceneManager()->LoadSceneFromJson(sceneJson);
+
+	auto* physicsManager = engine.GetPhysicsManager();
+	auto* bodyManager = physicsManager->GetBodyManager();
+	const p2Vec2 velocityBefore = bodyManager->GetComponentRef(2).GetLinearVelocity();
+	{
+		py::gil_scoped_acquire gil;
+		//Not through ExecutePythonCommand, a Python error has to fail the test
+		py::exec(
+			"import SFGE\n"
+			"body2d_manager = SFGE.physics2d_manager.body2d_manager\n"
+			"body2d_manager.velocities[0] = (1.0, 0.0)\n"
+			"body2d_manager.forces[1] = (0.0, 10.0)\n");
+	}
+	physicsManager->OnFixedUpdate();
+
+	const p2Vec2 velocity = bodyManager->GetComponentRef(1).GetLinearVelocity();
+	EXPECT_FLOAT_EQ(velocity.x, 1.0f);
+	EXPECT_FLOAT_EQ(velocity.y, 0.0f);
+	const p2Vec2 velocityAfter = bodyManager->GetComponentRef(2).GetLinearVelocity();
+	EXPECT_FLOAT_EQ(velocityAfter.x, velocityBefore.x);
+	EXPECT_FLOAT_EQ(velocityAfter.y - velocityBefore.y, 10.0f);
+	//The force is applied once then reset
+	const auto& forces = bodyManager->GetForces();
+	EXPECT_FLOAT_EQ(forces[1].x, 0.0f);
+	EXPECT_FLOAT_EQ(forces[1].y, 0.0f);
+	{
+		py::gil_scoped_acquire gil;
+		py::exec("forces_after_step = SFGE.physics2d_manager.body2d_manager.forces[1].tolist()\n");
+		const auto forcesAfterStep = py::globals()["forces_after_step"].cast<std::vector<float>>();
+		EXPECT_EQ(forcesAfterStep, std::vector<float>({ 0.0f, 0.0f }));
+	}
+	engine.Destroy();
+}
@@ -24,9 +24,18 @@ SOFTWARE.
 #include <engine/engine.h>
 #include <utility/log.h>
 #include <utility/json_utility.h>
+#include <utility/file_utility.h>
 #include <graphics/shape2d.h>
 #include <engine/scene.h>
+#include <engine/config.h>
+#include <engine/transform2d.h>
+#include <physics/physics2d.h>
+#include <python/python_engine.h>
+#include <utility/python_utility.h>
 #include <gtest/gtest.h>
+#include <fstream>
+#include <algorithm>
+#include <cstdio>
 
 TEST(OldPython, TestPyComponent)
 {
@@ -64,3 +73,283 @@ TEST(OldPython, TestPyComponent)
 	
 	engine.Start();
 }
+
+TEST(Python, TestReleaseGilOnEngineCalls)
+{
+	sfge::Engine engine;
+	std::unique_ptr<sfge::Configuration> initConfig = std::make_unique<sfge::Configuration>();
+	initConfig->devMode = false;
+	engine.Init(std::move(initConfig));
+	//The main thread never hands the GIL over on its own, the worker only counts while the engine calls release it
+	engine.GetPythonEngine()->ExecutePythonCommand(
+		"import sys\n"
+		"import threading\n"
+		"import time\n"
+		"import SFGE\n"
+		"gil_progress = [0]\n"
+		"gil_stop = threading.Event()\n"
+		"def gil_count():\n"
+		"    while not gil_stop.is_set():\n"
+		"        gil_progress[0] += 1\n"
+		"        time.sleep(0.0001)\n"
+		"gil_switch_interval = sys.getswitchinterval()\n"
+		"gil_worker = threading.Thread(target=gil_count)\n"
+		"gil_worker.start()\n"
+		"sys.setswitchinterval(100.0)\n"
+		"gil_progress_before = gil_progress[0]\n"
+		"SFGE.entity_manager.resize(20000)\n"
+		"SFGE.scene_manager.load_scene('SceneTest')\n"
+		"gil_progress_during_calls = gil_progress[0] - gil_progress_before\n"
+		"sys.setswitchinterval(gil_switch_interval)\n"
+		"gil_stop.set()\n"
+		"gil_worker.join()\n");
+	{
+		py::gil_scoped_acquire gil;
+		//ExecutePythonCommand only logs the Python errors, the result is read back to fail here
+		const auto globals = py::globals();
+		ASSERT_TRUE(globals.contains("gil_progress_during_calls"));
+		EXPECT_GT(globals["gil_progress_during_calls"].cast<int>(), 0);
+	}
+	engine.Destroy();
+}
+
+TEST(Python, TestLazyScriptsCache)
+{
+	sfge::Engine engine;
+	std::unique_ptr<sfge::Configuration> initConfig = std::make_unique<sfge::Configuration>();
+	initConfig->devMode = false;
+	initConfig->lazyScripts = true;
+	initConfig->scriptCacheDirname = "test_script_cache/";
+	engine.Init(std::move(initConfig));
+	json sceneJson = {
+		{ "name", "Test Lazy Scripts" }
+	};
+	json systemJson = {
+		{ "script_path", "scripts/vector_system.py" }
+	};
+	sceneJson["systems"] = json::array({ systemJson });
+	auto* sceneManager = engine.GetSceneManager();
+	sceneManager->LoadSceneFromJson(sceneJson);
+	//Only the script of the scene was imported and its compiled code is cached
+	EXPECT_EQ(sceneManager->GetSceneSystems().size(), 1u);
+	bool cached = false;
+	std::string cacheDirname = "test_script_cache/";
+	sfge::IterateDirectory(cacheDirname, [&cached](std::string entry)
+	{
+		cached = cached || entry.find("vector_system_") != std::string::npos;
+	});
+	EXPECT_TRUE(cached);
+	engine.Destroy();
+	sfge::RemoveDirectory(cacheDirname);
+}
+
+TEST(Python, TestScriptCacheReuse)
+{
+	sfge::Engine engine;
+	std::unique_ptr<sfge::Configuration> initConfig = std::make_unique<sfge::Configuration>();
+	initConfig->devMode = false;
+	engine.Init(std::move(initConfig));
+	const std::string scriptPath = "data/test_cached_module.py";
+	const std::string cacheDirname = "test_script_cache_reuse/";
+	const auto writeScript = [&scriptPath](const std::string& source)
+	{
+		std::ofstream scriptFile(scriptPath);
+		scriptFile << source;
+	};
+	const auto countCacheFiles = [&cacheDirname]()
+	{
+		size_t cacheFileCount = 0;
+		std::string dirname = cacheDirname;
+		sfge::IterateDirectory(dirname, [&cacheFileCount](std::string entry)
+		{
+			if (entry.find("test_cached_module_") != std::string::npos)
+				cacheFileCount++;
+		});
+		return cacheFileCount;
+	};
+	{
+		py::gil_scoped_acquire gil;
+		py::object globals = py::globals();
+		writeScript("value = 1\n");
+		auto module = sfge::import("test_cached_module", scriptPath, globals, cacheDirname);
+		EXPECT_EQ(module.attr("value").cast<int>(), 1);
+		ASSERT_EQ(countCacheFiles(), 1u);
+		//The cached code is replaced, the second import runs it instead of compiling the unchanged source
+		py::dict locals;
+		locals["cache_folder"] = py::cast(cacheDirname);
+		py::exec(
+			"import importlib.util\n"
+			"import marshal\n"
+			"import os\n"
+			"for cache_entry in os.listdir(cache_folder):\n"
+			"    with open(os.path.join(cache_folder, cache_entry), 'wb') as cache_file:\n"
+			"        cache_file.write(importlib.util.MAGIC_NUMBER)\n"
+			"        marshal.dump(compile('value = 2\\n', 'cached', 'exec'), cache_file)\n",
+			globals, locals);
+		module = sfge::import("test_cached_module", scriptPath, globals, cacheDirname);
+		EXPECT_EQ(module.attr("value").cast<int>(), 2);
+		//A changed source is compiled again and replaces its previous version in the cache
+		writeScript("value = 3\n");
+		module = sfge::import("test_cached_module", scriptPath, globals, cacheDirname);
+		EXPECT_EQ(module.attr("value").cast<int>(), 3);
+		EXPECT_EQ(countCacheFiles(), 1u);
+	}
+	std::remove(scriptPath.c_str());
+	sfge::RemoveDirectory(cacheDirname);
+	engine.Destroy();
+}
+
+TEST(Python, TestPySystemHookLists)
+{
+	sfge::Engine engine;
+	std::unique_ptr<sfge::Configuration> initConfig = std::make_unique<sfge::Configuration>();
+	initConfig->devMode = false;
+	engine.Init(std::move(initConfig));
+	json sceneJson = {
+		{ "name", "Test Hook Lists" }
+	};
+	json systemJson = {
+		{ "script_path", "scripts/vector_system.py" }
+	};
+	sceneJson["systems"] = json::array({ systemJson });
+	engine.GetSceneManager()->LoadSceneFromJson(sceneJson);
+
+	auto& pySystemManager = engine.GetPythonEngine()->GetPySystemManager();
+	//Only the loaded system, found by name, and only in the lists of the hooks VectorSystem overrides
+	ASSERT_EQ(pySystemManager.GetPySystems().size(), 1u);
+	auto* pySystem = pySystemManager.GetPySystems()[0];
+	EXPECT_EQ(pySystemManager.GetPySystemFromClassName("VectorSystem"), pySystem);
+	EXPECT_EQ(pySystemManager.GetPySystemFromClassName("PlanetSystem"), nullptr);
+	EXPECT_TRUE(pySystemManager.HasHook(pySystem, sfge::PySystemHook::UPDATE));
+	EXPECT_TRUE(pySystemManager.HasHook(pySystem, sfge::PySystemHook::DRAW));
+	EXPECT_FALSE(pySystemManager.HasHook(pySystem, sfge::PySystemHook::FIXED_UPDATE));
+	EXPECT_EQ(pySystemManager.GetHookSystems(sfge::PySystemHook::UPDATE).size(), 1u);
+	EXPECT_TRUE(pySystemManager.GetHookSystems(sfge::PySystemHook::CONTACT).empty());
+	engine.Destroy();
+}
+
+TEST(Python, TestSpawnBinding)
+{
+	sfge::Engine engine;
+	std::unique_ptr<sfge::Configuration> initConfig = std::make_unique<sfge::Configuration>();
+	initConfig->devMode = false;
+	initConfig->windowLess = true;
+	engine.Init(std::move(initConfig));
+	{
+		py::gil_scoped_acquire gil;
+		//Not through ExecutePythonCommand, a Python error has to fail the test
+		py::exec(
+			"import numpy as np\n"
+			"import SFGE\n"
+			"numpy_positions = np.arange(8.0).reshape(4, 2)\n"
+			"numpy_entities = SFGE.scene_manager.spawn(4, [SFGE.System.Transform2d], numpy_positions)\n"
+			"sequence_entities = SFGE.scene_manager.spawn(2, [SFGE.System.Body], [(1.0, 2.0), (3.0, 4.0)],\n"
+			"    velocities=[(0.5, 0.0), (0.0, 0.5)], body_type=SFGE.Body.KINEMATIC_BODY)\n"
+			"length_errors = []\n"
+			"for count, positions, velocities in ((3, numpy_positions, None), (1, [(1.0, 2.0)], [(0.5, 0.0), (0.0, 0.5)])):\n"
+			"    try:\n"
+			"        SFGE.scene_manager.spawn(count, [SFGE.System.Body], positions, velocities)\n"
+			"        length_errors.append('')\n"
+			"    except ValueError as e:\n"
+			"        length_errors.append(str(e))\n");
+		auto globals = py::globals();
+		auto* transformManager = engine.GetTransform2dManager();
+		auto* bodyManager = engine.GetPhysicsManager()->GetBodyManager();
+
+		const auto numpyEntities = globals["numpy_entities"].cast<std::vector<Entity>>();
+		ASSERT_EQ(numpyEntities.size(), 4u);
+		EXPECT_FLOAT_EQ(transformManager->GetComponentRef(numpyEntities[3]).Position.x, 6.0f);
+		EXPECT_FLOAT_EQ(transformManager->GetComponentRef(numpyEntities[3]).Position.y, 7.0f);
+
+		const auto sequenceEntities = globals["sequence_entities"].cast<std::vector<Entity>>();
+		ASSERT_EQ(sequenceEntities.size(), 2u);
+		EXPECT_FLOAT_EQ(transformManager->GetComponentRef(sequenceEntities[1]).Position.x, 3.0f);
+		EXPECT_FLOAT_EQ(transformManager->GetComponentRef(sequenceEntities[1]).Position.y, 4.0f);
+		auto& body = bodyManager->GetComponentRef(sequenceEntities[1]);
+		EXPECT_EQ(body.GetType(), p2BodyType::KINEMATIC);
+		EXPECT_FLOAT_EQ(body.GetLinearVelocity().x, 0.0f);
+		EXPECT_FLOAT_EQ(body.GetLinearVelocity().y, 0.5f);
+
+		//The arrays not matching the count are refused before any entity is created
+		const auto lengthErrors = globals["length_errors"].cast<std::vector<std::string>>();
+		ASSERT_EQ(lengthErrors.size(), 2u);
+		EXPECT_NE(lengthErrors[0].find("positions"), std::string::npos);
+		EXPECT_NE(lengthErrors[1].find("velocities"), std::string::npos);
+		EXPECT_EQ(bodyManager->GetBodyCount(), 2u);
+	}
+	engine.Destroy();
+}
+
+TEST(Python, TestPySystemProfileHistory)
+{
+	sfge::PySystemProfile profile;
+	const auto historyLength = sfge::PySystemProfile::HISTORY_LENGTH;
+	EXPECT_FLOAT_EQ(profile.GetAverageTime(sfge::PySystemHook::UPDATE), 0.0f);
+	EXPECT_EQ(profile.GetHistoryOffset(sfge::PySystemHook::UPDATE), 0u);
+
+	for (auto i = 1; i <= 3; i++)
+	{
+		profile.AddTime(sfge::PySystemHook::UPDATE, static_cast<float>(i));
+	}
+	EXPECT_FLOAT_EQ(profile.GetAverageTime(sfge::PySystemHook::UPDATE), 2.0f);
+	EXPECT_EQ(profile.GetHistoryOffset(sfge::PySystemHook::UPDATE), 0u);
+	//The hooks have their own history
+	EXPECT_FLOAT_EQ(profile.GetAverageTime(sfge::PySystemHook::FIXED_UPDATE), 0.0f);
+
+	//Past the history length the oldest samples are overwritten and the offset points to the oldest kept one
+	for (size_t i = 4; i <= historyLength + 5; i++)
+	{
+		profile.AddTime(sfge::PySystemHook::UPDATE, static_cast<float>(i));
+	}
+	const auto offset = profile.GetHistoryOffset(sfge::PySystemHook::UPDATE);
+	EXPECT_EQ(offset, 5u);
+	const auto& history = profile.history[static_cast<size_t>(sfge::PySystemHook::UPDATE)];
+	EXPECT_FLOAT_EQ(history[offset], 6.0f);
+	EXPECT_FLOAT_EQ(history[(offset + historyLength - 1) % historyLength], static_cast<float>(historyLength + 5));
+	EXPECT_FLOAT_EQ(profile.GetAverageTime(sfge::PySystemHook::UPDATE), (6.0f + historyLength + 5) / 2.0f);
+	EXPECT_FLOAT_EQ(profile.maxTime, static_cast<float>(historyLength + 5));
+}
+
+TEST(Python, TestPythonHotspots)
+{
+	sfge::Engine engine;
+	std::unique_ptr<sfge::Configuration> initConfig = std::make_unique<sfge::Configuration>();
+	initConfig->devMode = false;
+	initConfig->windowLess = true;
+	engine.Init(std::move(initConfig));
+	json sceneJson = {
+		{ "name", "Test Python Hotspots" }
+	};
+	json systemJson = {
+		{ "script_path", "scripts/vector_system.py" }
+	};
+	sceneJson["systems"] = json::array({ systemJson });
+	auto* sceneManager = engine.GetSceneManager();
+	sceneManager->LoadSceneFromJson(sceneJson);
+
+	auto& pySystemManager = engine.GetPythonEngine()->GetPySystemManager();
+	EXPECT_TRUE(pySystemManager.GetPythonHotspots(10).empty());
+	pySystemManager.SetPythonProfiling(true);
+	ASSERT_TRUE(pySystemManager.IsPythonProfiling());
+	sceneManager->OnUpdate(0.016f);
+	pySystemManager.SetPythonProfiling(false);
+
+	//The update of VectorSystem is found back with its location and its single call
+	const auto hotspots = pySystemManager.GetPythonHotspots(10);
+	const auto updateIt = std::find_if(hotspots.begin(), hotspots.end(), [](const sfge::PyHotspot& hotspot)
+	{
+		return hotspot.location.find("vector_system.py") != std::string::npos &&
+			hotspot.location.find(" update") != std::string::npos;
+	});
+	ASSERT_NE(updateIt, hotspots.end());
+	EXPECT_EQ(updateIt->calls, 1u);
+	EXPECT_GE(updateIt->time, 0.0f);
+	//The hook timing of the Stats window got its sample too
+	const auto profiledSystems = pySystemManager.GetProfiledSystems();
+	ASSERT_EQ(profiledSystems.size(), 1u);
+	EXPECT_EQ(profiledSystems[0]->profile.sampleCounts[static_cast<size_t>(sfge::PySystemHook::UPDATE)], 1u);
+
+	pySystemManager.ResetPythonHotspots();
+	EXPECT_TRUE(pySystemManager.GetPythonHotspots(10).empty());
+	engine.Destroy();
+}
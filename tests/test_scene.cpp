@@ -25,8 +25,93 @@ SOFTWARE.
 #include <engine/engine.h>
 #include <engine/scene.h>
 #include <utility/json_utility.h>
+#include <utility/file_utility.h>
+#include <engine/config.h>
+#include <engine/component.h>
+#include <engine/cooked_scene.h>
+#include <engine/system_registry.h>
+#include <engine/transform2d.h>
+#include <graphics/graphics2d.h>
+#include <graphics/shape2d.h>
+#include <physics/physics2d.h>
+#include <python/python_engine.h>
+#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <cstdio>
+#include <SFML/System/Sleep.hpp>
 #include <gtest/gtest.h>
 
+/**
+ * \brief Engine without window nor editor, shared by the scene tests
+ */
+static void InitTestEngine(sfge::Engine& engine)
+{
+	auto config = std::make_unique<sfge::Configuration>();
+	config->devMode = false;
+	config->windowLess = true;
+	engine.Init(std::move(config));
+}
+
+/**
+ * \brief Scene of entityNmb entities with a transform at (spacing * i, 10), listed after the other components
+ */
+static json CreateTransformScene(const std::string& sceneName, size_t entityNmb, float spacing = 1.0f,
+	const json& otherComponents = json::array(), const std::string& entityName = "")
+{
+	json sceneJson;
+	sceneJson["name"] = sceneName;
+	sceneJson["entities"] = json::array();
+	for (size_t i = 0; i < entityNmb; i++)
+	{
+		json transformJson;
+		transformJson["type"] = static_cast<int>(sfge::ComponentType::TRANSFORM2D);
+		transformJson["position"] = json::array({ spacing * i, 10.0f });
+		json entityJson;
+		if (!entityName.empty())
+		{
+			entityJson["name"] = entityName;
+		}
+		entityJson["components"] = otherComponents;
+		entityJson["components"].push_back(transformJson);
+		sceneJson["entities"].push_back(entityJson);
+	}
+	return sceneJson;
+}
+
+/**
+ * \brief Native system of the wave tests, its access is given by the factory and it counts its updates
+ */
+class TestWaveSystem : public sfge::System
+{
+public:
+	TestWaveSystem(sfge::Engine& engine, std::atomic<int>* updateCount) : System(engine), m_UpdateCount(updateCount)
+	{
+	}
+	void OnUpdate(float dt) override
+	{
+		(void) dt;
+		if (m_UpdateCount != nullptr)
+			(*m_UpdateCount)++;
+	}
+private:
+	std::atomic<int>* m_UpdateCount;
+};
+
+static void RegisterTestWaveSystem(sfge::Engine& engine, const std::string& systemClassName,
+	int readComponents, int writeComponents, bool declared = true, std::atomic<int>* updateCount = nullptr)
+{
+	engine.GetSystemRegistry()->RegisterSystem(systemClassName,
+		[=](sfge::Engine& systemEngine) -> std::unique_ptr<sfge::System>
+	{
+		auto system = std::make_unique<TestWaveSystem>(systemEngine, updateCount);
+		if (declared)
+			system->SetComponentAccess(readComponents, writeComponents);
+		return system;
+	});
+}
+
 TEST(Scene, TestSwitchScene)
 {
 
@@ -58,4 +143,629 @@ TEST(Scene, TestSwitchSceneLeak)
 
 
 
-}
\ No newline at end of file
+}
+
+TEST(Scene, TestCookedScene)
+{
+	sfge::Engine engine;
+	InitTestEngine(engine);
+
+	json transformJson;
+	transformJson["type"] = static_cast<int>(sfge::ComponentType::TRANSFORM2D);
+	transformJson["position"] = json::array({ 100.0f, 200.0f });
+	json shapeJson;
+	shapeJson["type"] = static_cast<int>(sfge::ComponentType::SHAPE2D);
+	shapeJson["shape_type"] = static_cast<int>(sfge::ShapeType::CIRCLE);
+	shapeJson["radius"] = 25.0f;
+	json entityJson;
+	entityJson["name"] = "Cooked Entity";
+	entityJson["components"] = json::array({ transformJson, shapeJson });
+	json sceneJson;
+	sceneJson["name"] = "Test Cooked Scene";
+	sceneJson["entities"] = json::array({ entityJson, entityJson });
+
+	const std::string scenePath = "test_cooked.scene";
+	const std::string cookedPath = sfge::GetCookedScenePath(scenePath);
+	ASSERT_EQ(cookedPath, "test_cooked.cscene");
+	{
+		std::ofstream sceneFile(scenePath);
+		sceneFile << sceneJson;
+	}
+	ASSERT_TRUE(engine.GetSceneManager()->CookScene(scenePath));
+	ASSERT_TRUE(sfge::FileExists(cookedPath));
+
+	engine.GetSceneManager()->LoadSceneFromPath(scenePath);
+	auto* entityManager = engine.GetEntityManager();
+	ASSERT_TRUE(entityManager->HasComponent(2, sfge::ComponentType::TRANSFORM2D));
+	ASSERT_TRUE(entityManager->HasComponent(2, sfge::ComponentType::SHAPE2D));
+	ASSERT_EQ(entityManager->GetEntityInfo(2).name, "Cooked Entity");
+	const auto& transform = engine.GetTransform2dManager()->GetComponentRef(2);
+	ASSERT_FLOAT_EQ(transform.Position.x, 100.0f);
+	ASSERT_FLOAT_EQ(transform.Position.y, 200.0f);
+	auto* shape = engine.GetGraphics2dManager()->GetShapeManager()->GetComponentPtr(2)->GetShape();
+	ASSERT_NE(shape, nullptr);
+
+	engine.Destroy();
+	std::remove(scenePath.c_str());
+	std::remove(cookedPath.c_str());
+}
+
+TEST(Scene, TestCookedSceneAfterBiggerScene)
+{
+	sfge::Engine engine;
+	InitTestEngine(engine);
+	auto* config = engine.GetConfig();
+
+	const size_t bigEntityNmb = INIT_ENTITY_NMB * 3;
+	auto bigSceneJson = CreateTransformScene("Test Big Scene", bigEntityNmb);
+	engine.GetSceneManager()->LoadSceneFromJson(bigSceneJson);
+	ASSERT_EQ(config->currentEntitiesNmb, bigEntityNmb);
+
+	//Bigger than the initial size but smaller than the previous scene
+	const size_t cookedEntityNmb = INIT_ENTITY_NMB * 2;
+	const std::string scenePath = "test_cooked_small.scene";
+	const std::string cookedPath = sfge::GetCookedScenePath(scenePath);
+	{
+		std::ofstream sceneFile(scenePath);
+		sceneFile << CreateTransformScene("Test Small Cooked Scene", cookedEntityNmb, 2.0f);
+	}
+	ASSERT_TRUE(engine.GetSceneManager()->CookScene(scenePath));
+	engine.GetSceneManager()->LoadSceneFromPath(scenePath);
+
+	//The entity arrays and the component managers keep the size of the bigger scene
+	ASSERT_EQ(config->currentEntitiesNmb, bigEntityNmb);
+	auto* entityManager = engine.GetEntityManager();
+	auto* transformManager = engine.GetTransform2dManager();
+	ASSERT_EQ(entityManager->GetEntityInfo(cookedEntityNmb).name, "Entity " + std::to_string(cookedEntityNmb));
+	ASSERT_FLOAT_EQ(transformManager->GetComponentRef(cookedEntityNmb).Position.x, 2.0f * (cookedEntityNmb - 1));
+	ASSERT_FALSE(entityManager->HasComponent(bigEntityNmb, sfge::ComponentType::TRANSFORM2D));
+
+	//The freed entities can still be used after the cooked scene
+	bigSceneJson = CreateTransformScene("Test Big Scene Again", bigEntityNmb);
+	engine.GetSceneManager()->LoadSceneFromJson(bigSceneJson);
+	ASSERT_TRUE(entityManager->HasComponent(bigEntityNmb, sfge::ComponentType::TRANSFORM2D));
+	ASSERT_FLOAT_EQ(transformManager->GetComponentRef(bigEntityNmb).Position.x, static_cast<float>(bigEntityNmb - 1));
+
+	engine.Destroy();
+	std::remove(scenePath.c_str());
+	std::remove(cookedPath.c_str());
+}
+
+TEST(Scene, TestStagedSceneLoading)
+{
+	sfge::Engine engine;
+	InitTestEngine(engine);
+
+	const size_t entityNmb = 2000;
+	json shapeJson;
+	shapeJson["type"] = static_cast<int>(sfge::ComponentType::SHAPE2D);
+	shapeJson["shape_type"] = static_cast<int>(sfge::ShapeType::CIRCLE);
+	json bodyJson;
+	bodyJson["type"] = static_cast<int>(sfge::ComponentType::BODY2D);
+	bodyJson["body_type"] = 2;
+	//The body is listed before the transform it depends on
+	auto sceneJson = CreateTransformScene("Test Staged Loading", entityNmb, 1.0f, json::array({ bodyJson, shapeJson }));
+	engine.GetSceneManager()->LoadSceneFromJson(sceneJson);
+
+	const auto& loadStats = engine.GetSceneManager()->GetLoadStats();
+	ASSERT_EQ(loadStats.componentCounts[0], entityNmb);
+	ASSERT_EQ(loadStats.componentCounts[2], entityNmb);
+	ASSERT_EQ(loadStats.componentCounts[3], entityNmb);
+	auto* entityManager = engine.GetEntityManager();
+	for (Entity entity = 1; entity <= entityNmb; entity++)
+	{
+		ASSERT_EQ(entityManager->GetMask(entity), static_cast<int>(sfge::ComponentType::TRANSFORM2D) |
+			static_cast<int>(sfge::ComponentType::SHAPE2D) | static_cast<int>(sfge::ComponentType::BODY2D));
+	}
+	ASSERT_FLOAT_EQ(engine.GetTransform2dManager()->GetComponentRef(entityNmb).Position.x, static_cast<float>(entityNmb - 1));
+	engine.Destroy();
+}
+
+TEST(Scene, TestStreamedSceneLoading)
+{
+	sfge::Engine engine;
+	InitTestEngine(engine);
+
+	//More entities than one streaming batch
+	const size_t entityNmb = 2500;
+	const auto sceneJson = CreateTransformScene("Test Streamed Loading", entityNmb, 1.0f, json::array(), "Streamed");
+	const std::string scenePath = "data/scenes/test_streamed.scene";
+	{
+		std::ofstream sceneFile(scenePath);
+		sceneFile << sceneJson;
+	}
+	engine.GetSceneManager()->LoadSceneFromPath(scenePath);
+	std::remove(scenePath.c_str());
+
+	ASSERT_EQ(engine.GetSceneManager()->GetLoadStats().componentCounts[0], entityNmb);
+	auto* entityManager = engine.GetEntityManager();
+	ASSERT_TRUE(entityManager->HasComponent(entityNmb, sfge::ComponentType::TRANSFORM2D));
+	ASSERT_EQ(entityManager->GetEntityInfo(entityNmb).name, "Streamed");
+	ASSERT_FLOAT_EQ(engine.GetTransform2dManager()->GetComponentRef(entityNmb).Position.x, static_cast<float>(entityNmb - 1));
+	engine.Destroy();
+}
+
+TEST(Scene, TestStreamedSceneSystemsAfterEntities)
+{
+	sfge::Engine engine;
+	InitTestEngine(engine);
+	//Records if the entities already existed when the scene systems were created
+	auto systemSawEntities = std::make_shared<bool>(false);
+	engine.GetSystemRegistry()->RegisterSystem("StreamedSceneSystem",
+		[systemSawEntities](sfge::Engine& systemEngine) -> std::unique_ptr<sfge::System>
+	{
+		*systemSawEntities = systemEngine.GetEntityManager()->HasComponent(1, sfge::ComponentType::TRANSFORM2D);
+		return std::make_unique<TestWaveSystem>(systemEngine, nullptr);
+	});
+
+	const size_t entityNmb = 2500;
+	auto sceneJson = CreateTransformScene("Test Streamed Systems", entityNmb);
+	sceneJson["systems"] = json::array({ { { "systemClassName", "StreamedSceneSystem" } } });
+	const std::string scenePath = "data/scenes/test_streamed_systems.scene";
+	{
+		//The keys are written in alphabetical order, the entities come before the systems
+		std::ofstream sceneFile(scenePath);
+		sceneFile << sceneJson;
+	}
+	auto* sceneManager = engine.GetSceneManager();
+	sceneManager->LoadSceneFromPath(scenePath);
+	ASSERT_EQ(sceneManager->GetSceneNativeSystems().size(), 1u);
+	ASSERT_FALSE(*systemSawEntities);
+	ASSERT_EQ(sceneManager->GetLoadStats().componentCounts[0], entityNmb);
+	ASSERT_TRUE(engine.GetEntityManager()->HasComponent(entityNmb, sfge::ComponentType::TRANSFORM2D));
+
+	//Saved scenes list their name and systems first, so their entities are not deferred
+	ASSERT_TRUE(sceneManager->SaveScene(scenePath));
+	std::string sceneText;
+	{
+		std::ifstream sceneFile(scenePath);
+		sceneText.assign(std::istreambuf_iterator<char>(sceneFile), std::istreambuf_iterator<char>());
+	}
+	const auto systemsIndex = sceneText.find("\"systems\"");
+	ASSERT_NE(systemsIndex, std::string::npos);
+	ASSERT_LT(sceneText.find("\"name\""), systemsIndex);
+	ASSERT_LT(systemsIndex, sceneText.find("\"entities\""));
+	ASSERT_EQ(*sfge::LoadJson(scenePath), json::parse(sceneText));
+	sceneManager->LoadSceneFromPath(scenePath);
+	std::remove(scenePath.c_str());
+	ASSERT_EQ(sceneManager->GetSceneNativeSystems().size(), 1u);
+	ASSERT_FALSE(*systemSawEntities);
+	ASSERT_TRUE(engine.GetEntityManager()->HasComponent(entityNmb, sfge::ComponentType::TRANSFORM2D));
+	engine.Destroy();
+}
+
+TEST(Scene, TestPreloadScene)
+{
+	sfge::Engine engine;
+	InitTestEngine(engine);
+
+	auto* sceneManager = engine.GetSceneManager();
+	ASSERT_FALSE(sceneManager->ActivateScene());
+	sceneManager->PreloadScene("SceneTest");
+	while (!sceneManager->IsScenePreloaded())
+	{
+		sf::sleep(sf::milliseconds(1));
+	}
+	ASSERT_TRUE(sceneManager->ActivateScene());
+	ASSERT_TRUE(engine.GetEntityManager()->HasComponent(1, sfge::ComponentType::TRANSFORM2D));
+	ASSERT_FLOAT_EQ(engine.GetTransform2dManager()->GetComponentRef(1).Position.x, 300.0f);
+	ASSERT_FALSE(sceneManager->IsScenePreloaded());
+	engine.Destroy();
+}
+
+TEST(Scene, TestSceneIndex)
+{
+	const std::string indexPath = "data/scene_index.json";
+	std::remove(indexPath.c_str());
+	sfge::Engine engine;
+	auto config = std::make_unique<sfge::Configuration>();
+	config->devMode = false;
+	config->windowLess = true;
+	config->lazySceneSearch = true;
+	engine.Init(std::move(config));
+
+	ASSERT_FALSE(sfge::FileExists(indexPath));
+	auto* sceneManager = engine.GetSceneManager();
+	const auto scenes = sceneManager->GetAllScenes();
+	ASSERT_FALSE(scenes.empty());
+	ASSERT_TRUE(sfge::FileExists(indexPath));
+	const auto indexJsonPtr = sfge::LoadJson(indexPath);
+	ASSERT_NE(indexJsonPtr, nullptr);
+
+	//Searching again with an up to date index gives the same scenes
+	std::string dataDirname = "data/";
+	sceneManager->SearchScenes(dataDirname);
+	ASSERT_EQ(sceneManager->GetAllScenes(), scenes);
+	sceneManager->LoadSceneFromName("SceneTest");
+	ASSERT_TRUE(engine.GetEntityManager()->HasComponent(1, sfge::ComponentType::TRANSFORM2D));
+	engine.Destroy();
+}
+
+TEST(Scene, TestSaveScene)
+{
+	sfge::Engine engine;
+	InitTestEngine(engine);
+
+	auto sceneJson = CreateTransformScene("Test Save", 3, 100.0f);
+	auto* sceneManager = engine.GetSceneManager();
+	sceneManager->LoadSceneFromJson(sceneJson);
+
+	const std::string scenePath = "data/scenes/test_save.scene";
+	ASSERT_TRUE(sceneManager->SaveScene(scenePath));
+	auto savedJsonPtr = sfge::LoadJson(scenePath);
+	std::remove(scenePath.c_str());
+	ASSERT_NE(savedJsonPtr, nullptr);
+	ASSERT_EQ((*savedJsonPtr)["name"], "Test Save");
+	ASSERT_EQ((*savedJsonPtr)["entities"].size(), 3u);
+	ASSERT_FLOAT_EQ(sfge::GetVectorFromJson((*savedJsonPtr)["entities"][2]["components"][0], "position").x, 200.0f);
+
+	//Only the moved entity is in the delta
+	engine.GetTransform2dManager()->GetComponentRef(2).Position.x = 150.0f;
+	const std::string deltaPath = "data/scenes/test_save.delta";
+	ASSERT_TRUE(sceneManager->SaveSceneDelta(deltaPath));
+	const auto deltaJsonPtr = sfge::LoadJson(deltaPath);
+	std::remove(deltaPath.c_str());
+	ASSERT_NE(deltaJsonPtr, nullptr);
+	ASSERT_EQ((*deltaJsonPtr)["entities"].size(), 1u);
+	ASSERT_EQ((*deltaJsonPtr)["entities"][0]["entity"], 2);
+	sfge::SceneManager::MergeSceneDelta(*savedJsonPtr, *deltaJsonPtr);
+	ASSERT_EQ((*savedJsonPtr)["entities"][1]["components"].size(), 1u);
+	ASSERT_FLOAT_EQ(sfge::GetVectorFromJson((*savedJsonPtr)["entities"][1]["components"][0], "position").x, 150.0f);
+
+	const std::string snapshotPath = "data/scenes/test_save.cscene";
+	ASSERT_TRUE(sceneManager->SaveScene(snapshotPath, sfge::SceneSaveFormat::BINARY));
+	sceneManager->LoadSceneFromJson(sceneJson);
+	ASSERT_TRUE(sceneManager->LoadSceneSnapshot(snapshotPath));
+	std::remove(snapshotPath.c_str());
+	ASSERT_FLOAT_EQ(engine.GetTransform2dManager()->GetComponentRef(2).Position.x, 150.0f);
+	engine.Destroy();
+}
+
+TEST(Scene, TestSaveMultipleComponents)
+{
+	sfge::Engine engine;
+	InitTestEngine(engine);
+
+	json bodyJson;
+	bodyJson["type"] = static_cast<int>(sfge::ComponentType::BODY2D);
+	bodyJson["body_type"] = 2;
+	json colliderJson;
+	colliderJson["type"] = static_cast<int>(sfge::ComponentType::COLLIDER2D);
+	colliderJson["collider_type"] = 1;
+	colliderJson["radius"] = 10.0f;
+	auto sceneJson = CreateTransformScene("Test Save Colliders", 100, 20.0f, json::array({ bodyJson, colliderJson, colliderJson }));
+	engine.GetSceneManager()->LoadSceneFromJson(sceneJson);
+
+	//The colliders are found through the entity index built once for the whole scene
+	const auto savedJson = engine.GetSceneManager()->SerializeScene();
+	ASSERT_EQ(savedJson["entities"].size(), 100u);
+	for (const auto& entityJson : savedJson["entities"])
+	{
+		const auto colliderCount = std::count_if(entityJson["components"].begin(), entityJson["components"].end(),
+			[](const json& componentJson) { return componentJson["type"] == static_cast<int>(sfge::ComponentType::COLLIDER2D); });
+		ASSERT_EQ(colliderCount, 2);
+	}
+	engine.Destroy();
+}
+
+TEST(Scene, TestSystemComponentAccess)
+{
+	sfge::Engine engine;
+	sfge::System transformWriter(engine);
+	sfge::System transformReader(engine);
+	sfge::System spriteWriter(engine);
+	sfge::System undeclared(engine);
+	transformWriter.SetComponentAccess(0, static_cast<int>(sfge::ComponentType::TRANSFORM2D));
+	transformReader.SetComponentAccess(static_cast<int>(sfge::ComponentType::TRANSFORM2D), 0);
+	spriteWriter.SetComponentAccess(static_cast<int>(sfge::ComponentType::TRANSFORM2D), static_cast<int>(sfge::ComponentType::SPRITE2D));
+
+	EXPECT_TRUE(transformWriter.ConflictsWith(transformReader));
+	EXPECT_TRUE(spriteWriter.ConflictsWith(transformWriter));
+	EXPECT_FALSE(transformReader.ConflictsWith(spriteWriter));
+	//A system without declared access never shares its wave
+	EXPECT_TRUE(undeclared.ConflictsWith(transformReader));
+}
+
+TEST(Scene, TestSystemWavePlacement)
+{
+	sfge::Engine engine;
+	InitTestEngine(engine);
+	const int transform = static_cast<int>(sfge::ComponentType::TRANSFORM2D);
+	const int sprite = static_cast<int>(sfge::ComponentType::SPRITE2D);
+	RegisterTestWaveSystem(engine, "TransformWriterSystem", 0, transform);
+	RegisterTestWaveSystem(engine, "TransformReaderSystem", transform, 0);
+	RegisterTestWaveSystem(engine, "SpriteWriterSystem", transform, sprite);
+	RegisterTestWaveSystem(engine, "UndeclaredSystem", 0, 0, false);
+	json sceneJson = {
+		{ "name", "Test System Waves" }
+	};
+	sceneJson["systems"] = json::array({
+		{ { "systemClassName", "TransformWriterSystem" } },
+		{ { "systemClassName", "TransformReaderSystem" } },
+		{ { "systemClassName", "SpriteWriterSystem" } },
+		{ { "systemClassName", "UndeclaredSystem" } } });
+	auto* sceneManager = engine.GetSceneManager();
+	sceneManager->LoadSceneFromJson(sceneJson);
+	ASSERT_EQ(sceneManager->GetSceneNativeSystems().size(), 4u);
+	const auto& nativeSystems = sceneManager->GetSceneNativeSystems();
+	//The readers wait for the writer, the sprite writer does not conflict with the transform reader and the undeclared system is alone
+	const auto& waves = sceneManager->GetSystemWaves();
+	ASSERT_EQ(waves.size(), 3u);
+	ASSERT_EQ(waves[0].nativeSystems.size(), 1u);
+	EXPECT_EQ(waves[0].nativeSystems[0], nativeSystems[0].system.get());
+	ASSERT_EQ(waves[1].nativeSystems.size(), 2u);
+	EXPECT_EQ(waves[1].nativeSystems[0], nativeSystems[1].system.get());
+	EXPECT_EQ(waves[1].nativeSystems[1], nativeSystems[2].system.get());
+	ASSERT_EQ(waves[2].nativeSystems.size(), 1u);
+	EXPECT_EQ(waves[2].nativeSystems[0], nativeSystems[3].system.get());
+	engine.Destroy();
+}
+
+/**
+ * \brief Native system of the join test, sleeps before counting its update or records the count of the earlier waves
+ */
+class TestJoinWaveSystem : public sfge::System
+{
+public:
+	TestJoinWaveSystem(sfge::Engine& engine, std::atomic<int>* finishedCount, int* observedCount) :
+		System(engine), m_FinishedCount(finishedCount), m_ObservedCount(observedCount)
+	{
+	}
+	void OnUpdate(float dt) override
+	{
+		(void) dt;
+		if (m_ObservedCount != nullptr)
+		{
+			*m_ObservedCount = m_FinishedCount->load();
+			return;
+		}
+		sf::sleep(sf::milliseconds(20));
+		(*m_FinishedCount)++;
+	}
+private:
+	std::atomic<int>* m_FinishedCount;
+	int* m_ObservedCount;
+};
+
+/**
+ * \brief PySystem writing one component type that appends its tag to sys.test_wave_order at each update
+ */
+static void WriteWaveOrderScript(const std::string& scriptPath, const std::string& className,
+	const std::string& tag, const std::string& writtenComponent)
+{
+	std::ofstream scriptFile(scriptPath);
+	scriptFile <<
+		"from SFGE import *\n"
+		"import sys\n"
+		"\n"
+		"\n"
+		"class " << className << "(System):\n"
+		"    def init(self):\n"
+		"        self.set_component_access([], [System." << writtenComponent << "])\n"
+		"\n"
+		"    def update(self, dt):\n"
+		"        sys.test_wave_order += '" << tag << "'\n";
+}
+
+TEST(Scene, TestSystemWavesNativeAndPython)
+{
+	sfge::Engine engine;
+	InitTestEngine(engine);
+	const int transform = static_cast<int>(sfge::ComponentType::TRANSFORM2D);
+	const int sound = static_cast<int>(sfge::ComponentType::SOUND);
+	std::atomic<int> finishedCount{ 0 };
+	int observedCount = -1;
+	const auto registerJoinSystem = [&](const std::string& systemClassName, int writeComponents, bool observer)
+	{
+		engine.GetSystemRegistry()->RegisterSystem(systemClassName,
+			[&finishedCount, &observedCount, writeComponents, observer](sfge::Engine& systemEngine) -> std::unique_ptr<sfge::System>
+		{
+			auto system = std::make_unique<TestJoinWaveSystem>(systemEngine, &finishedCount, observer ? &observedCount : nullptr);
+			system->SetComponentAccess(0, writeComponents);
+			return system;
+		});
+	};
+	registerJoinSystem("SlowTransformSystem", transform, false);
+	registerJoinSystem("SlowSoundSystem", sound, false);
+	registerJoinSystem("TransformObserverSystem", transform, true);
+
+	const std::vector<std::string> scriptPaths = {
+		"data/test_wave_order_a.py", "data/test_wave_order_b.py", "data/test_wave_order_c.py" };
+	WriteWaveOrderScript(scriptPaths[0], "TestWaveOrderA", "A", "Transform2d");
+	WriteWaveOrderScript(scriptPaths[1], "TestWaveOrderB", "B", "Transform2d");
+	WriteWaveOrderScript(scriptPaths[2], "TestWaveOrderC", "C", "Sprite");
+	const auto resetWaveOrder = []()
+	{
+		py::gil_scoped_acquire gil;
+		py::module::import("sys").attr("test_wave_order") = py::str("");
+	};
+	const auto getWaveOrder = []()
+	{
+		py::gil_scoped_acquire gil;
+		return py::module::import("sys").attr("test_wave_order").cast<std::string>();
+	};
+	json pySystemsJson = json::array();
+	for (const auto& scriptPath : scriptPaths)
+	{
+		pySystemsJson.push_back({ { "script_path", scriptPath } });
+	}
+
+	//Without native systems, the PySystems are called in one batch in the scene order even if B waits for A in the waves
+	json sceneJson = {
+		{ "name", "Test Python Waves" }
+	};
+	sceneJson["systems"] = pySystemsJson;
+	auto* sceneManager = engine.GetSceneManager();
+	sceneManager->LoadSceneFromJson(sceneJson);
+	const auto& pySystems = sceneManager->GetSceneSystems();
+	ASSERT_EQ(pySystems.size(), 3u);
+	const auto& pyWaves = sceneManager->GetSystemWaves();
+	ASSERT_EQ(pyWaves.size(), 2u);
+	ASSERT_EQ(pyWaves[0].pyUpdateSystems.size(), 2u);
+	ASSERT_EQ(pyWaves[1].pyUpdateSystems.size(), 1u);
+	EXPECT_EQ(pyWaves[1].pyUpdateSystems[0], pySystems[1]);
+	resetWaveOrder();
+	sceneManager->OnUpdate(0.016f);
+	EXPECT_EQ(getWaveOrder(), "ABC");
+
+	//The two slow systems are disjoint, the observer and the transform PySystems wait for the slow transform system
+	sceneJson["name"] = "Test Native And Python Waves";
+	sceneJson["systems"] = json::array({
+		{ { "systemClassName", "SlowTransformSystem" } },
+		{ { "systemClassName", "SlowSoundSystem" } },
+		{ { "systemClassName", "TransformObserverSystem" } } });
+	for (auto& pySystemJson : pySystemsJson)
+	{
+		sceneJson["systems"].push_back(pySystemJson);
+	}
+	sceneManager->LoadSceneFromJson(sceneJson);
+	const auto& nativeSystems = sceneManager->GetSceneNativeSystems();
+	ASSERT_EQ(nativeSystems.size(), 3u);
+	ASSERT_EQ(pySystems.size(), 3u);
+	const auto& waves = sceneManager->GetSystemWaves();
+	ASSERT_EQ(waves.size(), 4u);
+	ASSERT_EQ(waves[0].nativeSystems.size(), 2u);
+	EXPECT_EQ(waves[0].nativeSystems[0], nativeSystems[0].system.get());
+	EXPECT_EQ(waves[0].nativeSystems[1], nativeSystems[1].system.get());
+	//C only writes sprites and overlaps the slow native systems
+	ASSERT_EQ(waves[0].pyUpdateSystems.size(), 1u);
+	EXPECT_EQ(waves[0].pyUpdateSystems[0], pySystems[2]);
+	ASSERT_EQ(waves[1].nativeSystems.size(), 1u);
+	EXPECT_EQ(waves[1].nativeSystems[0], nativeSystems[2].system.get());
+	EXPECT_TRUE(waves[1].pyUpdateSystems.empty());
+	ASSERT_EQ(waves[2].pyUpdateSystems.size(), 1u);
+	EXPECT_EQ(waves[2].pyUpdateSystems[0], pySystems[0]);
+	ASSERT_EQ(waves[3].pyUpdateSystems.size(), 1u);
+	EXPECT_EQ(waves[3].pyUpdateSystems[0], pySystems[1]);
+
+	resetWaveOrder();
+	sceneManager->OnUpdate(0.016f);
+	//Both tasks of the first wave were joined before the observer of the second wave ran
+	EXPECT_EQ(observedCount, 2);
+	EXPECT_EQ(finishedCount, 2);
+	EXPECT_EQ(getWaveOrder(), "CAB");
+
+	engine.Destroy();
+	for (const auto& scriptPath : scriptPaths)
+	{
+		std::remove(scriptPath.c_str());
+	}
+}
+
+TEST(Scene, TestLoadSceneFromSystemUpdate)
+{
+	sfge::Engine engine;
+	InitTestEngine(engine);
+	std::atomic<int> updateCount{ 0 };
+	RegisterTestWaveSystem(engine, "TransformWriterSystem", 0, static_cast<int>(sfge::ComponentType::TRANSFORM2D), true, &updateCount);
+	//The PySystem shares the wave of the native system, which runs on the thread pool while the script loads the scene
+	const std::string scriptPath = "data/test_load_scene_system.py";
+	{
+		std::ofstream scriptFile(scriptPath);
+		scriptFile <<
+			"from SFGE import *\n"
+			"\n"
+			"\n"
+			"class TestLoadSceneSystem(System):\n"
+			"    def init(self):\n"
+			"        self.set_component_access([System.Sound], [])\n"
+			"\n"
+			"    def update(self, dt):\n"
+			"        scene_manager.load_scene('SceneTest')\n";
+	}
+	json sceneJson = {
+		{ "name", "Test Load From Update" }
+	};
+	sceneJson["systems"] = json::array({
+		{ { "systemClassName", "TransformWriterSystem" } },
+		{ { "script_path", scriptPath } } });
+	auto* sceneManager = engine.GetSceneManager();
+	sceneManager->LoadSceneFromJson(sceneJson);
+	ASSERT_EQ(sceneManager->GetSystemWaves().size(), 1u);
+	ASSERT_EQ(sceneManager->GetSystemWaves()[0].pyUpdateSystems.size(), 1u);
+
+	sceneManager->OnUpdate(0.016f);
+	//The native system finished its update before the requested scene replaced the systems
+	EXPECT_EQ(updateCount, 1);
+	EXPECT_TRUE(sceneManager->GetSceneNativeSystems().empty());
+	EXPECT_TRUE(sceneManager->GetSceneSystems().empty());
+	EXPECT_TRUE(sceneManager->GetSystemWaves().empty());
+	sceneManager->OnUpdate(0.016f);
+	EXPECT_EQ(updateCount, 1);
+	std::remove(scriptPath.c_str());
+	engine.Destroy();
+}
+
+TEST(Scene, TestSpawnEntities)
+{
+	sfge::Engine engine;
+	std::unique_ptr<sfge::Configuration> initConfig = std::make_unique<sfge::Configuration>();
+	initConfig->devMode = false;
+	engine.Init(std::move(initConfig));
+
+	const size_t spawnNmb = 10'000;
+	std::vector<float> positions(spawnNmb * 2);
+	for (size_t i = 0; i < spawnNmb; i++)
+	{
+		positions[2 * i] = static_cast<float>(i);
+		positions[2 * i + 1] = 2.0f * i;
+	}
+	sfge::EntitySpawnDef spawnDef;
+	spawnDef.archetype = static_cast<int>(sfge::ComponentType::TRANSFORM2D) | static_cast<int>(sfge::ComponentType::SPRITE2D);
+	spawnDef.positions = positions.data();
+	spawnDef.texturePath = "data/sprites/round.png";
+	auto* sceneManager = engine.GetSceneManager();
+	const auto entities = sceneManager->SpawnEntities(spawnNmb, spawnDef);
+
+	ASSERT_EQ(entities.size(), spawnNmb);
+	auto* entityManager = engine.GetEntityManager();
+	auto* transformManager = engine.GetTransform2dManager();
+	EXPECT_TRUE(entityManager->HasComponent(entities.back(), sfge::ComponentType::SPRITE2D));
+	EXPECT_FLOAT_EQ(transformManager->GetComponentRef(entities.back()).Position.y, 2.0f * (spawnNmb - 1));
+	//The spawned entities are no longer free
+	const auto nextEntities = entityManager->CreateEntities(1);
+	EXPECT_EQ(std::find(entities.begin(), entities.end(), nextEntities[0]), entities.end());
+	engine.Destroy();
+}
+
+TEST(Scene, TestSpawnBodies)
+{
+	sfge::Engine engine;
+	InitTestEngine(engine);
+
+	//More entities than the world can hold bodies
+	const size_t spawnNmb = MAX_BODY_LEN + 10;
+	std::vector<float> velocities(spawnNmb * 2);
+	for (size_t i = 0; i < spawnNmb; i++)
+	{
+		velocities[2 * i] = static_cast<float>(i);
+		velocities[2 * i + 1] = -1.0f;
+	}
+	sfge::EntitySpawnDef spawnDef;
+	spawnDef.archetype = static_cast<int>(sfge::ComponentType::BODY2D);
+	spawnDef.velocities = velocities.data();
+	spawnDef.bodyType = p2BodyType::KINEMATIC;
+	const auto entities = engine.GetSceneManager()->SpawnEntities(spawnNmb, spawnDef);
+
+	ASSERT_EQ(entities.size(), spawnNmb);
+	auto* entityManager = engine.GetEntityManager();
+	auto* bodyManager = engine.GetPhysicsManager()->GetBodyManager();
+	EXPECT_EQ(bodyManager->GetBodyCount(), MAX_BODY_LEN);
+	for (size_t i = 0; i < MAX_BODY_LEN; i++)
+	{
+		//A body gets a transform even when the archetype does not ask for it
+		ASSERT_TRUE(entityManager->HasComponent(entities[i], sfge::ComponentType::TRANSFORM2D));
+		ASSERT_TRUE(entityManager->HasComponent(entities[i], sfge::ComponentType::BODY2D));
+		auto& body = bodyManager->GetComponentRef(entities[i]);
+		ASSERT_EQ(body.GetType(), p2BodyType::KINEMATIC);
+		ASSERT_FLOAT_EQ(body.GetLinearVelocity().x, static_cast<float>(i));
+		ASSERT_FLOAT_EQ(body.GetLinearVelocity().y, -1.0f);
+	}
+	//The entities past the cap are spawned without body
+	for (size_t i = MAX_BODY_LEN; i < spawnNmb; i++)
+	{
+		EXPECT_TRUE(entityManager->HasComponent(entities[i], sfge::ComponentType::TRANSFORM2D));
+		EXPECT_FALSE(entityManager->HasComponent(entities[i], sfge::ComponentType::BODY2D));
+	}
+	engine.Destroy();
+}